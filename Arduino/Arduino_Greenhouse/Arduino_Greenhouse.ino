@@ -6,65 +6,194 @@
 //   identified by the MD5 fingerprints listed above.
 
 #include <avr/pgmspace.h>
-#include <avr/wdt.h>
 #include <EEPROM.h>
 
 #include <lib_aci.h>
 #include <aci_setup.h>
 #include <SPI.h>
-#include <Wire.h>
 #include <Servo.h>
 #include <Time.h>
 #include <PID_v1.h>
 
 #include "constants.h"
 #include "services.h"
+#include "lib_hal.h"
 #include "lib_ble.h"
+#include "lib_twi.h"
 #include "lib_hih6100.h"
-//#include "lib_fsm.h"
+#include "lib_sensorArray.h"
+#include "lib_fsm.h"
 #include "lib_timeSeries.h"
+#include "lib_telemetry.h"
+#include "lib_scheduler.h"
+#include "lib_autotune.h"
+#include "lib_fixed.h"
+#include "lib_fixedPID.h"
+#include "lib_eepromGuard.h"
+#include "lib_configStore.h"
+#include "lib_history.h"
+#include "lib_bulkTransfer.h"
+#include "lib_pipeDispatch.h"
+#include "lib_power.h"
+#include "lib_profiler.h"
+#include "lib_sampler.h"
+#include "lib_ventStrategy.h"
+#include "pipe_descriptors.h"
 
 
+// FUNCTION PROTOTYPES
+// NOTE: The Arduino IDE generates these itself, the host build (Arduino/host/) compiles this file as plain C++
+// -------------------------------------------------
+void sleepUntilNextTask(void);
+void updateBluetoothReadPipes(void);
+void setupHoneywellSensors(void);
+void startMeasurements(void);
+void performMeasurements(void);
+void measurementsFetched(void);
+void analyzeSystemState(void);
+control_t worstZoneDeviation(SensorAggregate *reading, control_t setpoint);
+control_t exteriorFeedForward(control_t humidityDeviation, control_t temperatureDeviation);
+float exteriorTrend(TimeSeries<CIRC_BUFFER_DEPTH> *series);
+void updateClimateState(float humidityDeviation, float temperatureDeviation);
+void performControl(void);
+void publishTelemetry(void);
+void logHistory(void);
+boolean diagnosticsPending(void);
+boolean notifyDiagnostics(uint8_t reportID, const void *report, uint8_t length);
+void sendPhaseTimingReport(void);
+void sendSamplingReport(void);
+void applySamplingInterval(void);
+void engageVentStrategy(void);
+void moveVentServo(void);
+void releaseSettledServo(void);
+void sendActuationReport(void);
+void sendBLEReport(void);
+uint32_t historyStreamLength(void);
+void readHistoryStream(uint32_t offset, uint8_t *buffer, uint8_t byteCount);
+uint32_t configStreamLength(void);
+void readConfigStream(uint32_t offset, uint8_t *buffer, uint8_t byteCount);
+void checkIlluminationTimer(void);
+void startAutotune(void);
+void finishAutotune(void);
+void publishTuningReport(void);
+void handleACIEvent(aci_state_t *aci_state, aci_evt_t *aci_evt);
+void receivedDataFromPipe(uint8_t *bytes, uint8_t byteCount, uint8_t pipe);
+void persistConfiguration(void);
+void configurationChanged(void);
+void commitConfiguration(void);
+void sendConfigReport(void);
+void watchdogBarked(void);
+void restoreConfiguration(void);
+void applyControlConfiguration(void);
+
 // USER-CONFIGURABLE VARIABLES
 // -------------------------------------------------
 UserConfig currentConfig;
+ConfigStore configStore(CONFIG_STORE_START, CONFIG_STORE_LENGTH, CONFIG_SCHEMA_VERSION, sizeof(UserConfig));
+static_assert(CONFIG_RECORD_SIZE(sizeof(UserConfig)) * 2 <= CONFIG_STORE_LENGTH, "Config store can't hold two records, a failed write would lose the configuration");
+boolean configReportRequested = false;
+
+// The parts of currentConfig used every control cycle, in the control path's number format
+typedef struct {
+  
+  control_t humiditySetpoint;
+  control_t humidityNecessityCoeff;
+  control_t temperatureSetpoint;
+  control_t temperatureNecessityCoeff;
+  
+} ControlConfig;
+
+ControlConfig controlConfig;
 
 // GLOBAL VARIABLES
 // -------------------------------------------------
 
 // Bluetooth Low Energy (BLE)
 BLE BLE_board(handleACIEvent);  // Configure BLE instance with callback function
+BulkTransfer bulkTransfer;  // Larger uploads, streamed in every free data credit
+boolean bleReportRequested = false;
 
 // Timeseries Statistics
-TimeSeries ventNecessityMeasurements;
+TimeSeries<CIRC_BUFFER_DEPTH> ventNecessityMeasurements;
+TimeSeries<CIRC_BUFFER_DEPTH> exteriorHumidityMeasurements, exteriorTemperatureMeasurements;  // Trends the feed-forward anticipates
+
+// Interval averages kept in EEPROM, for clients that were out of range
+HistoryLog historyLog(HISTORY_LOG_START, HISTORY_LOG_LENGTH);
+
+// Per-cycle values published together as one frame
+TelemetrySnapshot telemetry;
+
+// What the climate needs most, see updateClimateState()
+// NOTE: Reversing direction on one quantity passes through Steady, the band between the two
+static const uint8_t climateTransitions[ClimateStateCount] PROGMEM = {
+  
+  /* Steady */ FSM_ALLOW(ClimateStateIncreasingHumidity) | FSM_ALLOW(ClimateStateDecreasingHumidity) | FSM_ALLOW(ClimateStateIncreasingTemperature) | FSM_ALLOW(ClimateStateDecreasingTemperature),
+  /* IncreasingHumidity */ FSM_ALLOW(ClimateStateSteady) | FSM_ALLOW(ClimateStateIncreasingTemperature) | FSM_ALLOW(ClimateStateDecreasingTemperature),
+  /* DecreasingHumidity */ FSM_ALLOW(ClimateStateSteady) | FSM_ALLOW(ClimateStateIncreasingTemperature) | FSM_ALLOW(ClimateStateDecreasingTemperature),
+  /* IncreasingTemperature */ FSM_ALLOW(ClimateStateSteady) | FSM_ALLOW(ClimateStateIncreasingHumidity) | FSM_ALLOW(ClimateStateDecreasingHumidity),
+  /* DecreasingTemperature */ FSM_ALLOW(ClimateStateSteady) | FSM_ALLOW(ClimateStateIncreasingHumidity) | FSM_ALLOW(ClimateStateDecreasingHumidity)
+};
+
+FiniteStateMachine<ClimateState, ClimateStateCount, ClimateHooks> climateMachine(ClimateStateSteady, climateTransitions);
 
 // PID control
 boolean hasInitialData = false;
-double ventingNecessity = UNAVAILABLE_f;
-double ventFlapPosition = VENT_DOOR_CLOSED;
-double setpoint = 0;
-PID ventFlapPID(&ventingNecessity, &ventFlapPosition, &setpoint, 2.5, 0.25, 0.5, DIRECT);
+control_t ventingNecessity = UNAVAILABLE_f;
+control_t ventFlapPosition = VENT_DOOR_CLOSED;  // PID output plus the feed-forward, or the relay's while autotuning
+control_t ventPIDOutput = VENT_DOOR_CLOSED;
+control_t ventFeedForward = 0;  // servo degrees, from the exterior trends
+control_t setpoint = 0;
+ControlPID ventFlapPID(&ventingNecessity, &ventPIDOutput, &setpoint, VENT_PID_DEFAULT_KP, VENT_PID_DEFAULT_KI, VENT_PID_DEFAULT_KD, DIRECT);  // Gains replaced from currentConfig in setup()
+
+// PID autotuning
+RelayAutotuner ventFlapAutotuner;
+ResponseMonitor ventFlapResponse(RESPONSE_TRIGGER_ERROR);
+TuningReport tuningReport;
+boolean measuringTunedResponse = false;
+
+// Two-position venting, the alternative to the PID, and how often either moves the flap
+HysteresisSwitch ventSwitch;
+ActuationCounter ventActuations;
+uint8_t activeVentStrategy = VentStrategyPID;  // currentConfig.ventStrategy once engaged, the relay holds off a change
+boolean actuationReportRequested = false;
 
 // Shift Register
 int shiftRegLatchPin = 4;
 int shiftRegClockPin = 2;
 int shiftRegDataPin = 7;
-byte shiftRegisterState;
 
-// Humidity-&-Temp sensors
-HIH6100_Sensor interiorHoneywell, exteriorHoneywell;
+// Humidity-&-Temp sensors, the exterior one then one per interior zone, on the I2C bus
+TwiBus twiBus;
+SensorArray honeywellSensors;
+HIH6100_Sensor *exteriorHoneywell = &honeywellSensors.channels[SENSOR_CHANNEL_EXTERIOR];
+SensorAggregate interiorHumidity, interiorTemperature;  // Over the zones that read
 
 // Vent door servo
 Servo ventDoorServo;
 int ventDoorServoPin = 3;
+unsigned long lastServoMoveMillis = 0;
+
+// Sleep between tasks
+PowerMonitor powerMonitor;
+
+// Wall clock for the illumination timer, counted on the monotonic clock from the last time set
+time_t wallClockSetTime = 0;  // s since the epoch
+uint64_t wallClockSetMillis = 0;  // hal_millis64() when set
+
+// Where each cycle's time goes, see PROFILE_BEGIN()
+PhaseProfiler profiler;
+
+// Sensor reads and control cycles, further apart while venting necessity holds steady
+AdaptiveSampler sampler;
+boolean samplingReportRequested = false;
 
 // Light banks
 int lightBank1DutyCycle = HIGH;
 int lightBank2DutyCycle = HIGH;
 
-// W.D. interrupt handler should be as short as possible, so it sets
-//   watchdogWokeUp = true to indicate to run-loop that watchdog timer fired
-volatile boolean watchdogWokeUp = false;
+// Periodic tasks
+TaskScheduler scheduler;
+uint8_t sensorRequestTaskID, sensorTaskID, controlTaskID, illuminationTaskID, configCommitTaskID, historyTaskID;
 
 void setup (void) {
 
@@ -73,13 +202,19 @@ void setup (void) {
   Serial.println(F("Serial logging enabled"));
   
   restoreConfiguration();
+  applyControlConfiguration();
+  ventFlapPID.SetTunings(currentConfig.ventKp, currentConfig.ventKi, currentConfig.ventKd);
+  historyLog.begin();
+  climateMachine.begin();
   
-  // Initiate our measurement trigger
-  startWatchdogTimer();
-//  wdt_enable(WDTO_4S);
-
 // Configure Bluetooth LE support
   BLE_board.ble_setup();
+  BLE_board.setDeadbandForCharacteristic(PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET, VENTING_NECESSITY_DEADBAND);
+  BLE_board.setDeadbandForCharacteristic(PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET, VENTING_NECESSITY_DELTA_DEADBAND);
+  
+  bulkTransfer.addStream(BULK_STREAM_HISTORY, historyStreamLength, readHistoryStream);
+  bulkTransfer.addStream(BULK_STREAM_CONFIG, configStreamLength, readConfigStream);
+  BLE_board.setBulkTransfer(&bulkTransfer, PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_TX);
 
   // Configure support for Honeywell sensors
   setupHoneywellSensors();
@@ -90,50 +225,84 @@ void setup (void) {
   // Enable illumination control
   pinMode(5, OUTPUT);
   pinMode(6, OUTPUT);
+  
+  // Schedule periodic work, (task, period, phase, deadline) in ms
+  static_assert(CONTROL_TASK_PHASE > HIH6100_CONVERSION_TIME, "Control would run before the sensor read of its cycle");
+  sensorRequestTaskID = scheduler.addTask(startMeasurements, SAMPLING_INTERVAL, 0, HIH6100_CONVERSION_TIME);
+  sensorTaskID = scheduler.addTask(performMeasurements, SAMPLING_INTERVAL, HIH6100_CONVERSION_TIME, CONTROL_TASK_PHASE - HIH6100_CONVERSION_TIME);
+  controlTaskID = scheduler.addTask(performControl, SAMPLING_INTERVAL, CONTROL_TASK_PHASE, SAMPLING_INTERVAL / 2);
+  illuminationTaskID = scheduler.addTask(checkIlluminationTimer, ILLUMINATION_INTERVAL, ILLUMINATION_TASK_PHASE, ILLUMINATION_INTERVAL / 2);
+  configCommitTaskID = scheduler.addTask(commitConfiguration, CONFIG_COMMIT_INTERVAL, CONFIG_COMMIT_TASK_PHASE, CONFIG_COMMIT_INTERVAL);
+  historyTaskID = scheduler.addTask(logHistory, HISTORY_INTERVAL, HISTORY_TASK_PHASE, SAMPLING_INTERVAL);
+  
+  scheduler.start(hal_millis64());
+  sampler.begin(SAMPLING_INTERVAL, hal_millis64());
+  applySamplingInterval();
+  powerMonitor.begin(micros());
+  
+  // Start the watchdog last, BLE setup can take longer than its time-out
+  // NOTE: loop() feeds it, periodic work is timed by the scheduler above
+  hal_startWatchdogTimer(watchdogBarked);
 }
 
 void loop() {
   
-  // Check whether the watchdog barked
-  if (watchdogWokeUp) {
-   
-//    Serial.println(F("Watchdog barked!"));
-    
-    watchdogWokeUp = false;  // Reset flag until watchdog fires again
-    
-    performMeasurements();
-    
-    analyzeSystemState();
-    
-    checkIlluminationTimer();
-  }
+  hal_feedWatchdog();
+  
+  // Run whichever periodic task is due, if any
+  scheduler.runNextDueTask(hal_millis64());
 
   //Process any ACI commands or events
   BLE_board.ble_loop();
   
+  // Finished sensor transfers
+  twiBus.loop();
+  
+  sendPhaseTimingReport();
+  sendSamplingReport();
+  sendActuationReport();
+  sendConfigReport();
+  sendBLEReport();
+  
+  releaseSettledServo();
+  sleepUntilNextTask();
 }
 
 
-// STUCK-IN-LOOP DETECTIOn
+// SLEEP
 // ----------------------------------------------------
-void detectHungLoop() {
+void sleepUntilNextTask() {
   
-  if (BLE_board.loopingSinceLastBark) {
-    
-    // Assume we're in an inf-loop, force us out to try and recover
-    BLE_board._aci_cmd_pending = false;
-    BLE_board._data_credit_pending  = false;
-    
-  } else if (BLE_board._aci_cmd_pending || BLE_board._data_credit_pending) {
+  // Stay awake while the radio or the sensor bus has anything in flight, a sleep would only be cut short
+  if (!BLE_board.readyToSleep() || !twiBus.idle() || profiler.reporting) return;
+  
+  unsigned long sleepMillis = scheduler.millisUntilNextTask(hal_millis64());
+  if (sleepMillis < SLEEP_MIN_MILLIS) return;
+  if (sleepMillis > SLEEP_MAX_MILLIS) sleepMillis = SLEEP_MAX_MILLIS;
+  
+  // NOTE: Connected, the nRF8001 raises RDYN every connection interval, too often for power-down's
+  //   start-up time and estimated timekeeping to pay off. A moving servo needs Timer1's pulses.
+  boolean servoSettling = millis() - lastServoMoveMillis < SERVO_SETTLE_MILLIS;
+  HalSleepMode mode = (BLE_board.isConnected() || servoSettling) ? HalSleepIdle : HalSleepPowerDown;
+  
+  if (mode == HalSleepPowerDown) {
     
-    // Set a marker so we can see if either loop has exited by the next time the watchdog barks
-    BLE_board.loopingSinceLastBark = true;
+    Serial.flush();  // The UART stops too
+    ventDoorServo.detach();  // Rather than let it see one truncated pulse, it holds position unpowered
+  }
+  
+  hal_feedWatchdog();
+  powerMonitor.sleeping(micros());
+  
+  boolean wokeByRadio;
+  unsigned long sleptMillis = hal_sleep(mode, sleepMillis, BLE_board.radioWakePin(), &wokeByRadio);
   
-  }  // else do nothing, everything's peachy
+  powerMonitor.woke(mode, sleptMillis, wokeByRadio, micros());
+  
+  // NOTE: Left detached, the next move attaches it again, see moveVentServo()
 }
 
 
-
 // BREAKOUT
 // ----------------------------------------------------
 void updateBluetoothReadPipes() {
@@ -150,13 +319,20 @@ void updateBluetoothReadPipes() {
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_SET, currentConfig.temperatureNecessityCoeff);
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_SET, currentConfig.illuminationOnMinutes);
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_SET, currentConfig.illuminationOffMinutes);
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_SET, &currentConfig.samplingMinSeconds, 2);  // ...and samplingMaxSeconds after it
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_SET, currentConfig.ventingNecessityThreshold);
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_SET, currentConfig.ventingNecessityOvershoot);
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_SET, currentConfig.targetVentingNecessity);
   
   // Climate Control State
-//  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_SHIFT_REGISTER_STATE_SET, shiftRegisterState);
+//  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_SHIFT_REGISTER_STATE_SET, honeywellSensors.shiftRegisterState);
   
   // Controls
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_SET, (uint8_t) lightBank1DutyCycle);
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_SET, (uint8_t) ventDoorServo.read());
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_SET, (uint8_t *) &currentConfig.ventFeedForwardHumidity, 2 * sizeof(float));  // ...and ventFeedForwardTemperature after it
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_SET, currentConfig.ventStrategy);
+  publishTuningReport();
   
   // Measurements
   // NOTE: Set when measured
@@ -164,74 +340,115 @@ void updateBluetoothReadPipes() {
 
 void setupHoneywellSensors() {
   
-  pinMode(shiftRegLatchPin, OUTPUT);
-  pinMode(shiftRegDataPin, OUTPUT);
-  pinMode(shiftRegClockPin, OUTPUT);
+  // In SENSOR_CHANNEL_* order
+  honeywellSensors.addChannel(EXTERIOR_SENSOR_OUTPUT);
+  for (uint8_t zone = 0; zone < INTERIOR_ZONE_COUNT; zone++) honeywellSensors.addChannel(INTERIOR_ZONE_OUTPUT(zone));
+  
+  honeywellSensors.begin(shiftRegLatchPin, shiftRegDataPin, shiftRegClockPin);
+}
+
+void startMeasurements() {
   
-  enableHoneywellSensor(HoneywellSensorNone);
-  Wire.begin();
+  // Trigger every sensor with a single shared request, they convert in parallel
+  //   while the loop goes back to servicing BLE
+  honeywellSensors.startConversions();
 }
 
 void performMeasurements() {
   
-  // Check Temp & Humidity inside and out
-  // ---------------------------------------
+  PROFILE_BEGIN(ProfilePhaseMeasurements);
   
-  // Exterior
-  enableHoneywellSensor(HoneywellSensorExterior);
-  delay(50);  // Allow sensor to wakeup
-  exteriorHoneywell.performMeasurement();
-//  exteriorHoneywell.printStatus();
+  // Collect Temp & Humidity inside and out, converted since startMeasurements()
+  // NOTE: Read one sensor at a time in the background, the loop keeps servicing BLE meanwhile
+  if (!honeywellSensors.fetchResults(measurementsFetched)) PROFILE_END(ProfilePhaseMeasurements);
+}
+
+void measurementsFetched() {
   
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_HUMIDITY_TX, exteriorHoneywell.humidity);
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_TEMPERATURE_TX, exteriorHoneywell.temperature);
+  // Exterior
+//  exteriorHoneywell->printStatus();
+  telemetry.recordExterior(toFloat(exteriorHoneywell->humidity), toFloat(exteriorHoneywell->temperature));
+  historyLog.addMeasurement(HistoryChannelExteriorHumidity, toFloat(exteriorHoneywell->humidity));
+  historyLog.addMeasurement(HistoryChannelExteriorTemperature, toFloat(exteriorHoneywell->temperature));
+  exteriorHumidityMeasurements.addValue(toFloat(exteriorHoneywell->humidity));
+  exteriorTemperatureMeasurements.addValue(toFloat(exteriorHoneywell->temperature));
   
-  // Interior
-  enableHoneywellSensor(HoneywellSensorInterior);
-  delay(50);  // Allow sensor to wakeup
-  interiorHoneywell.performMeasurement();
-//  interiorHoneywell.printStatus();
+  // Interior, the zones' mean
+  // NOTE: Holds the last readings if no zone answered
+  honeywellSensors.aggregate(SENSOR_CHANNEL_FIRST_ZONE, INTERIOR_ZONE_COUNT, &interiorHumidity, &interiorTemperature);
   
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_HUMIDITY_TX, interiorHoneywell.humidity);
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_TEMPERATURE_TX, interiorHoneywell.temperature);
+  telemetry.recordInterior(toFloat(interiorHumidity.mean), toFloat(interiorTemperature.mean));
+  historyLog.addMeasurement(HistoryChannelInteriorHumidity, toFloat(interiorHumidity.mean));
+  historyLog.addMeasurement(HistoryChannelInteriorTemperature, toFloat(interiorTemperature.mean));
   
-  // Cleanup
-  enableHoneywellSensor(HoneywellSensorNone);
+  PROFILE_END(ProfilePhaseMeasurements);
 }
 
 void analyzeSystemState() {
   
   // Calculate our Venting Necessity
-  float humidityDeviation = interiorHoneywell.humidity - currentConfig.humiditySetpoint;  // + when interior is too humid
-  float temperatureDeviation = interiorHoneywell.temperature - currentConfig.temperatureSetpoint; // + when interior is too warm
+  // NOTE: Venting mixes the whole house, so it's driven by the zones' mean
+  control_t humidityDeviation = interiorHumidity.mean - controlConfig.humiditySetpoint;  // + when interior is too humid
+  control_t temperatureDeviation = interiorTemperature.mean - controlConfig.temperatureSetpoint; // + when interior is too warm
 
-  float humidityDelta = interiorHoneywell.humidity - exteriorHoneywell.humidity;  // + when interior is more humid than exterior
-  float temperatureDelta = interiorHoneywell.temperature - exteriorHoneywell.temperature;  // + when interior is warmer than exterior
+  control_t humidityDelta = interiorHumidity.mean - exteriorHoneywell->humidity;  // + when interior is more humid than exterior
+  control_t temperatureDelta = interiorTemperature.mean - exteriorHoneywell->temperature;  // + when interior is warmer than exterior
   
   // Example H(i) = 31%, H(o) = 28.5%, H(s) = 30.0, T(i) = 22.3, T(o) = 21.9, T(s) = 23.0
   //    2.22             = ( 1.0                   * 2.5           * 1.0              ) + ( 1.0                      * 0.4              * -0.7                )
-  ventingNecessity = (currentConfig.humidityNecessityCoeff * humidityDelta * humidityDeviation) + (currentConfig.temperatureNecessityCoeff * temperatureDelta * temperatureDeviation);
+  ventingNecessity = (controlConfig.humidityNecessityCoeff * humidityDelta * humidityDeviation) + (controlConfig.temperatureNecessityCoeff * temperatureDelta * temperatureDeviation);
   
-  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET, (float)ventingNecessity);
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_TX, (float)ventingNecessity);
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET, toFloat(ventingNecessity));
   
   // Staticstics
-  ventNecessityMeasurements.addValue(ventingNecessity);
+  ventNecessityMeasurements.addValue(toFloat(ventingNecessity));
+  
+  float ventingNecessityDelta = ventNecessityMeasurements.averageSlope();
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET, ventingNecessityDelta);
   
-  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET, ventNecessityMeasurements.averageSlope());
-  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_TX, ventNecessityMeasurements.averageSlope());
+  // The climate is only steady when every zone is, so its state follows the zone furthest out
+  if (hasInitialData) updateClimateState(toFloat(worstZoneDeviation(&interiorHumidity, controlConfig.humiditySetpoint)), toFloat(worstZoneDeviation(&interiorTemperature, controlConfig.temperatureSetpoint)));
   
-  // Set Vent Flap servo position based on PID controller
+  // Set Vent Flap servo position based on the vent strategy, or the relay while autotuning
   if (hasInitialData) {
     
-    ventFlapPID.Compute();
+    if (ventFlapAutotuner.state == AutotuneStateRunning) {
+      
+      double relayOutput = toFloat(ventFlapPosition);
+      if (ventFlapAutotuner.update(toFloat(ventingNecessity), millis(), &relayOutput)) finishAutotune();
+      ventFlapPosition = relayOutput;
+      
+    } else if (activeVentStrategy == VentStrategyHysteresis) {
+      
+      // Only ever fully open or fully closed, and only once the necessity has crossed the band
+      ventFlapPosition = ventSwitch.update(ventingNecessity) ? VENT_DOOR_OPEN : VENT_DOOR_CLOSED;
+      
+    } else {
+      
+      ventFlapPID.Compute();
+      
+      // Moved ahead of what the exterior is about to do to the necessity, the PID trims the rest
+      ventFeedForward = exteriorFeedForward(humidityDeviation, temperatureDeviation);
+      ventFlapPosition = ventPIDOutput + ventFeedForward;
+      if (ventFlapPosition < control_t(VENT_DOOR_OPEN)) ventFlapPosition = VENT_DOOR_OPEN;
+      if (ventFlapPosition > control_t(VENT_DOOR_CLOSED)) ventFlapPosition = VENT_DOOR_CLOSED;
 //    Serial.print("Servo position = ");
 //    Serial.println(ventFlapPosition);
+      
+      if (ventFlapResponse.update(toFloat(ventingNecessity - setpoint), millis()) && measuringTunedResponse) {
+        
+        // First disturbance handled by the new gains
+        tuningReport.settlingTimeAfter = ventFlapResponse.settlingTime;
+        tuningReport.overshootAfter = ventFlapResponse.overshoot;
+        measuringTunedResponse = false;
+        
+        publishTuningReport();
+      }
+    }
     
-    ventDoorServo.write(ventFlapPosition);
+    moveVentServo();
     
     BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_SET, (uint8_t) ventDoorServo.read());
-    BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_TX, (uint8_t) ventDoorServo.read());
     
   } else {
     
@@ -240,15 +457,324 @@ void analyzeSystemState() {
     // Turn the PID on
     // NOTE: To raise venting necessity you would raise the output value (towards vent flap closure)
     //   so relationship is 'direct', not 'reverse'
-    ventFlapPID.SetSampleTime(3000);  // 3sec, less than watchdog cycle
+    // NOTE: Sample time follows the sampling interval, see applySamplingInterval()
     ventFlapPID.SetOutputLimits(VENT_DOOR_OPEN, VENT_DOOR_CLOSED);  // (min, max)
+    engageVentStrategy();
+  }
+  
+  // Sample faster while the necessity is on the move, slower while it holds
+  if (sampler.update(ventingNecessityDelta, ventNecessityMeasurements.slopeError(), toFloat(ventingNecessity - setpoint))) applySamplingInterval();
+  
+  telemetry.recordVenting(toFloat(ventingNecessity), ventingNecessityDelta, (uint8_t) ventDoorServo.read());
+  historyLog.addMeasurement(HistoryChannelVentingNecessity, toFloat(ventingNecessity));
+  historyLog.addMeasurement(HistoryChannelVentServoPosition, ventDoorServo.read());
+}
+
+control_t exteriorFeedForward(control_t humidityDeviation, control_t temperatureDeviation) {
+  
+  float humiditySlope = exteriorTrend(&exteriorHumidityMeasurements);  // per second
+  float temperatureSlope = exteriorTrend(&exteriorTemperatureMeasurements);
+  
+  // Rates the exterior trends move venting necessity at, its partial derivatives in the exterior readings times their slopes
+  float humidityRate = -toFloat(controlConfig.humidityNecessityCoeff * humidityDeviation) * humiditySlope;
+  float temperatureRate = -toFloat(controlConfig.temperatureNecessityCoeff * temperatureDeviation) * temperatureSlope;
+  
+  // A rising necessity is met by opening, towards VENT_DOOR_OPEN, as the PID would once it had moved
+  return -(currentConfig.ventFeedForwardHumidity * humidityRate + currentConfig.ventFeedForwardTemperature * temperatureRate);
+}
+
+// Slope of a full window, or 0 while it's filling or the slope is within the sensor's noise of zero
+// NOTE: Nothing is anticipated from the first few readings, the jump from power-up values would kick the flap
+float exteriorTrend(TimeSeries<CIRC_BUFFER_DEPTH> *series) {
+  
+  if (series->measurementCount < CIRC_BUFFER_DEPTH) return 0;
+  
+  float slope = series->averageSlope();
+  if (fabs(slope) <= SAMPLER_SLOPE_SIGNIFICANCE * series->slopeError()) return 0;
+  
+  return slope;
+}
+
+control_t worstZoneDeviation(SensorAggregate *reading, control_t setpoint) {
+  
+  control_t above = reading->maximum - setpoint;
+  control_t below = setpoint - reading->minimum;
+  
+  return (above >= below) ? above : -below;
+}
+
+void updateClimateState(float humidityDeviation, float temperatureDeviation) {
+  
+  // In bands, so the two deviations compare, 1.0 is the edge of steady
+  float humidityNeed = humidityDeviation / CLIMATE_HUMIDITY_BAND;
+  float temperatureNeed = temperatureDeviation / CLIMATE_TEMPERATURE_BAND;
+  
+  // Leaving steady takes a whole band, returning half of one, so noise at the edge can't flap the state
+  float threshold = (climateMachine.currentState() == ClimateStateSteady) ? 1.0 : 0.5;
+  
+  ClimateState needed;
+  if (fabs(humidityNeed) < threshold && fabs(temperatureNeed) < threshold) needed = ClimateStateSteady;
+  else if (fabs(humidityNeed) >= fabs(temperatureNeed)) needed = (humidityNeed > 0) ? ClimateStateDecreasingHumidity : ClimateStateIncreasingHumidity;
+  else needed = (temperatureNeed > 0) ? ClimateStateDecreasingTemperature : ClimateStateIncreasingTemperature;
+  
+  if (!climateMachine.transitionToState(needed)) climateMachine.transitionToState(ClimateStateSteady);
+}
+
+void ClimateHooks::enter(uint8_t state, uint8_t fromState) {
+  
+  telemetry.recordClimateState(state);
+}
+
+void ClimateHooks::leave(uint8_t state, uint8_t toState) {
+  
+  // Nothing is started per state yet
+}
+
+void performControl() {
+  
+  PROFILE_BEGIN(ProfilePhaseAnalysis);
+  analyzeSystemState();
+  PROFILE_END(ProfilePhaseAnalysis);
+  
+  publishTelemetry();
+  
+  powerMonitor.closeCycle(micros());
+}
+
+void publishTelemetry() {
+  
+  // One frame carries every per-cycle value instead of a notification per characteristic
+  telemetry.recordConfigPending(configStore.dirty);
+  TelemetryFrame *frame = telemetry.stampFrame(millis());
+  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_MEASUREMENTS_TELEMETRY_SNAPSHOT_TX, (uint8_t *) frame, sizeof(TelemetryFrame));
+}
+
+// SAMPLE HISTORY
+// ----------------------------------------------------
+void logHistory() {
+  
+  // Logged whether or not anyone is connected, a client catches up with a download
+  historyLog.logSample(now(), HISTORY_INTERVAL / 1000, timeStatus() != timeNotSet);
+}
+
+// DIAGNOSTICS
+// ----------------------------------------------------
+static_assert(sizeof(PhaseTimingReport) <= DIAGNOSTICS_REPORT_SIZE, "Phase timing report doesn't fit one notification");
+static_assert(sizeof(SamplingReport) <= DIAGNOSTICS_REPORT_SIZE, "Sampling report doesn't fit one notification");
+static_assert(sizeof(ActuationReport) <= DIAGNOSTICS_REPORT_SIZE, "Actuation report doesn't fit one notification");
+static_assert(sizeof(ConfigReport) <= DIAGNOSTICS_REPORT_SIZE, "Config report doesn't fit one notification");
+static_assert(sizeof(BLEReport) <= DIAGNOSTICS_REPORT_SIZE, "BLE report doesn't fit one notification");
+
+// The reports share the Diagnostics Report characteristic, each notification leads with the one it carries
+// NOTE: One packet queued at a time, a second for the same pipe would supersede it, so callers
+//   wait until diagnosticsPending() is false
+boolean diagnosticsPending() {
+  
+  return BLE_board.notificationPendingForPipe(PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_TX);
+}
+
+boolean notifyDiagnostics(uint8_t reportID, const void *report, uint8_t length) {
+  
+  uint8_t packet[1 + DIAGNOSTICS_REPORT_SIZE];
+  
+  packet[0] = reportID;
+  memcpy(packet + 1, report, length);
+  
+  return BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_TX, packet, 1 + length);
+}
+
+void sendPhaseTimingReport() {
+  
+  if (!profiler.reporting || diagnosticsPending()) return;
+  
+  PhaseTimingReport report;
+  
+  if (profiler.nextReport(&report, millis()) && !notifyDiagnostics(DIAGNOSTICS_REPORT_PHASE_TIMING, &report, sizeof(PhaseTimingReport))) {
+    
+    profiler.reporting = false;  // Client has unsubscribed
+  }
+}
+
+void sendBLEReport() {
+  
+  if (!bleReportRequested || diagnosticsPending()) return;
+  
+  BLEReport report;
+  BLE_board.fillReport(&report);
+  
+  notifyDiagnostics(DIAGNOSTICS_REPORT_BLE, &report, sizeof(BLEReport));
+  bleReportRequested = false;
+}
+
+// ADAPTIVE SAMPLING
+// ----------------------------------------------------
+void applySamplingInterval() {
+  
+  // The sensor request, fetch and control tasks keep their phases within the cycle
+  scheduler.setTaskPeriod(sensorRequestTaskID, sampler.interval);
+  scheduler.setTaskPeriod(sensorTaskID, sampler.interval);
+  scheduler.setTaskPeriod(controlTaskID, sampler.interval);
+  scheduler.setTaskDeadline(controlTaskID, sampler.interval / 2);
+  
+  // Short of the interval, or a late wake would skip a Compute(). Ki and Kd are rescaled to match
+  ventFlapPID.SetSampleTime(sampler.interval * PID_SAMPLE_FRACTION);
+}
+
+void sendSamplingReport() {
+  
+  if (!samplingReportRequested || diagnosticsPending()) return;
+  
+  SamplingReport report;
+  sampler.fillReport(&report, hal_millis64());
+  
+  notifyDiagnostics(DIAGNOSTICS_REPORT_SAMPLING, &report, sizeof(SamplingReport));
+  samplingReportRequested = false;
+}
+
+// VENT STRATEGY
+// ----------------------------------------------------
+// Hands the flap to currentConfig.ventStrategy, bumplessly from wherever it is
+void engageVentStrategy() {
+  
+  // Counts belong to one strategy, or the actuation rates couldn't be compared
+  if (currentConfig.ventStrategy != activeVentStrategy) ventActuations.reset(hal_millis64());
+  activeVentStrategy = currentConfig.ventStrategy;
+  
+  if (activeVentStrategy == VentStrategyHysteresis) {
+    
+    // Carries on from the nearer end of travel, the PID waits in manual to be engaged again
+    ventFlapPID.SetMode(MANUAL);
+    ventFeedForward = 0;
+    ventSwitch.begin(ventFlapPosition < control_t((VENT_DOOR_OPEN + VENT_DOOR_CLOSED) / 2));
+    
+  } else {
+    
+    ventPIDOutput = ventFlapPosition - ventFeedForward;
     ventFlapPID.SetMode(AUTOMATIC);
   }
 }
 
+void moveVentServo() {
+  
+  int angle = toInt(ventFlapPosition);
+  int previousAngle = ventDoorServo.read();
+  
+  if (angle != previousAngle) {
+    
+    lastServoMoveMillis = millis();
+    ventActuations.moved(abs(angle - previousAngle));
+    
+    if (!ventDoorServo.attached()) ventDoorServo.attach(ventDoorServoPin);
+  }
+  
+  ventDoorServo.write(angle);
+}
+
+// A settled servo holds position unpowered, Timer1's pulse interrupts and the holding current are only spent on moves
+void releaseSettledServo() {
+  
+  if (ventDoorServo.attached() && millis() - lastServoMoveMillis >= SERVO_SETTLE_MILLIS) ventDoorServo.detach();
+}
+
+void sendActuationReport() {
+  
+  if (!actuationReportRequested || diagnosticsPending()) return;
+  
+  ActuationReport report;
+  ventActuations.fillReport(&report, activeVentStrategy, hal_millis64());
+  
+  notifyDiagnostics(DIAGNOSTICS_REPORT_ACTUATIONS, &report, sizeof(ActuationReport));
+  actuationReportRequested = false;
+}
+
+// BULK TRANSFER STREAMS
+// ----------------------------------------------------
+uint32_t historyStreamLength() {
+  
+  return HISTORY_LOG_LENGTH;
+}
+
+void readHistoryStream(uint32_t offset, uint8_t *buffer, uint8_t byteCount) {
+  
+  // Raw blocks, lib_history.h describes how to decode them
+  for (uint8_t i = 0; i < byteCount; i++) buffer[i] = eepromRead(HISTORY_LOG_START + offset + i);
+}
+
+uint32_t configStreamLength() {
+  
+  return sizeof(UserConfig);
+}
+
+void readConfigStream(uint32_t offset, uint8_t *buffer, uint8_t byteCount) {
+  
+  memcpy(buffer, (uint8_t *) &currentConfig + offset, byteCount);
+}
+
+// PID AUTOTUNING
+// ----------------------------------------------------
+void startAutotune() {
+  
+  if (!hasInitialData || ventFlapAutotuner.state == AutotuneStateRunning) return;
+  
+  // Keep the last response measured with the current gains for comparison
+  tuningReport.settlingTimeBefore = ventFlapResponse.responseCount ? ventFlapResponse.settlingTime : 0;
+  tuningReport.overshootBefore = ventFlapResponse.responseCount ? ventFlapResponse.overshoot : 0;
+  tuningReport.settlingTimeAfter = 0;
+  tuningReport.overshootAfter = 0;
+  measuringTunedResponse = false;
+  
+  // Relay around the flap's current position, the process gain depends heavily on the operating point
+  // NOTE: Kept far enough from the ends of travel for both relay positions to fit
+  double outputCenter = toFloat(ventFlapPosition);
+  if (outputCenter < VENT_DOOR_OPEN + AUTOTUNE_OUTPUT_STEP) outputCenter = VENT_DOOR_OPEN + AUTOTUNE_OUTPUT_STEP;
+  if (outputCenter > VENT_DOOR_CLOSED - AUTOTUNE_OUTPUT_STEP) outputCenter = VENT_DOOR_CLOSED - AUTOTUNE_OUTPUT_STEP;
+  
+  // The PID stays out of the loop until it's done
+  ventFlapPID.SetMode(MANUAL);
+  ventFlapAutotuner.start(toFloat(ventingNecessity), outputCenter, AUTOTUNE_OUTPUT_STEP, AUTOTUNE_HYSTERESIS, millis());
+  
+  publishTuningReport();
+}
+
+void finishAutotune() {
+  
+  double kp, ki, kd;
+  
+  if (ventFlapAutotuner.tuningsForUltimate(&kp, &ki, &kd)) {
+    
+    currentConfig.ventKp = kp;
+    currentConfig.ventKi = ki;
+    currentConfig.ventKd = kd;
+    configurationChanged();
+    
+    ventFlapPID.SetTunings(kp, ki, kd);
+    measuringTunedResponse = true;
+  }
+  
+  // Bumpless hand back from wherever the relay left the flap
+  ventFlapResponse.reset();
+  engageVentStrategy();
+  
+  publishTuningReport();
+}
+
+void publishTuningReport() {
+  
+  tuningReport.state = ventFlapAutotuner.state;
+  tuningReport.kp = currentConfig.ventKp;
+  tuningReport.ki = currentConfig.ventKi;
+  tuningReport.kd = currentConfig.ventKd;
+  
+  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_SET, (uint8_t *) &tuningReport, sizeof(TuningReport));
+  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_TX, (uint8_t *) &tuningReport, sizeof(TuningReport));
+}
+
 void checkIlluminationTimer() {
   
-  int minutesSinceMidnight = (60 * hour()) + minute();
+  PROFILE_BEGIN(ProfilePhaseIllumination);
+  
+  time_t wallClock = wallClockSetTime + (time_t) ((hal_millis64() - wallClockSetMillis) / 1000);
+  int minutesSinceMidnight = (int) ((wallClock % 86400UL) / 60);
   
   if (timeStatus() != timeSet || currentConfig.illuminationOnMinutes == UNAVAILABLE_u || currentConfig.illuminationOffMinutes == UNAVAILABLE_u) {
     
@@ -286,12 +812,16 @@ void checkIlluminationTimer() {
   digitalWrite(5, lightBank1DutyCycle);
   digitalWrite(6, lightBank2DutyCycle);
   
+  telemetry.recordLightBanks(lightBank1DutyCycle == HIGH, lightBank2DutyCycle == HIGH);
+  
   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_SET, (uint8_t) lightBank1DutyCycle);
   BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_TX, (uint8_t) lightBank1DutyCycle);
   
   // NOTE: Not bothering to send bank 2 status separately since they alreays get changed together
 //  BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_2_DUTY_CYCLE_SET, (uint8_t) lightBank2DutyCycle);
 //  BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_2_DUTY_CYCLE_TX, (uint8_t) lightBank2DutyCycle);
+  
+  PROFILE_END(ProfilePhaseIllumination);
 }
 
 
@@ -318,6 +848,17 @@ void handleACIEvent(aci_state_t *aci_state, aci_evt_t *aci_evt) {
         BLE_board.timing_change_done = false;
         break;
     }
+    
+    case ACI_EVT_DISCONNECTED: {
+      
+      // The client asks again after reconnecting, a bulk transfer resumes where it stopped
+      bulkTransfer.abort();
+      
+      // As for any other unhandled event
+      BLE_board._aci_cmd_pending = false;
+      BLE_board._data_credit_pending = false;
+      break;
+    }
   
     case ACI_EVT_DATA_RECEIVED: {  // One of the writeable pipes (for a Characteristic) has received data
       
@@ -353,7 +894,7 @@ void handleACIEvent(aci_state_t *aci_state, aci_evt_t *aci_evt) {
     
     case ACI_EVT_PIPE_STATUS: {  //
     
-        if (lib_aci_is_pipe_available(aci_state, PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_HUMIDITY_TX) && (BLE_board.timing_change_done == false)) {
+        if (lib_aci_is_pipe_available(aci_state, PIPE_GREENHOUSE_MEASUREMENTS_TELEMETRY_SNAPSHOT_TX) && (BLE_board.timing_change_done == false)) {
           
           lib_aci_change_timing_GAP_PPCP(); // change the timing on the link as specified in the nRFgo studio -> nRF8001 conf. -> GAP. 
                                             // Used to increase or decrease bandwidth
@@ -380,114 +921,97 @@ void handleACIEvent(aci_state_t *aci_state, aci_evt_t *aci_evt) {
 
 // USER-CONFIGURATION
 // ----------------------------------------------------
-boolean valueWithinLimits(float value, float minLimit, float maxLimit) {
-  
-  return (value >= minLimit && value <= maxLimit);
-}
-
 // Route incoming data to the correct state variables
-boolean receivedDataFromPipe(uint8_t *bytes, uint8_t byteCount, uint8_t pipe) {
+void receivedDataFromPipe(uint8_t *bytes, uint8_t byteCount, uint8_t pipe) {
   
+  // Configuration fields, described by the table generate_services.py builds from the service XML
+  PipeDescriptor descriptor;
+  PipeWriteResult result = pipeDispatchWrite(pipe, bytes, byteCount, &currentConfig, pipeDescriptors, pipeDescriptorIndex, NUMBER_OF_PIPES, &descriptor);
+  
+  if (result == PipeWriteAccepted) {
+    
+    configurationChanged();
+    if (descriptor.flags & PIPE_FLAG_APPLY_CONTROL) applyControlConfiguration();
+    
+    if (descriptor.echoPipe != PIPE_NONE) BLE_board.setValueForCharacteristic(descriptor.echoPipe, (uint8_t *) &currentConfig + descriptor.fieldOffset, descriptor.size);
+  }
+  
+  if (result != PipeWriteUnhandled) return;
+  
+  // Commands
   switch (pipe) {
 
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_SETPOINT_RX_ACK_AUTO: {
+    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_DATETIME_RX_ACK_AUTO: {
       
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_SETPOINT_RX_ACK_AUTO_MAX_SIZE) {
+      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_DATETIME_RX_ACK_AUTO_MAX_SIZE) {
       
-        float floatValue = *((float *)bytes);
-        if ( valueWithinLimits(floatValue, TEMPERATURE_SETPOINT_MIN, TEMPERATURE_SETPOINT_MAX) ) {
-          
-          currentConfig.temperatureSetpoint = floatValue;
-          persistConfiguration();
-          
-          BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_SETPOINT_SET, floatValue); 
-        }
+        uint32_t bleHostTime;
+        memcpy(&bleHostTime, bytes, sizeof(bleHostTime));  // NOTE: No alignment guarantee on the ACI buffer
+        setTime(bleHostTime);
+        adjustTime(3600);  // Shift time forward 1hr (not sure why necessary to be correct)
+        
+        wallClockSetTime = now();
+        wallClockSetMillis = hal_millis64();
+        
       }
-      break;
-    }
-    
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_SETPOINT_RX_ACK_AUTO: {
       
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_SETPOINT_RX_ACK_AUTO_MAX_SIZE) {
-      
-        float floatValue = *((float *)bytes);
-        if ( valueWithinLimits(floatValue, HUMIDITY_SETPOINT_MIN, HUMIDITY_SETPOINT_MAX) ) {
-          
-          currentConfig.humiditySetpoint = floatValue;
-          persistConfiguration();
-          
-          BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_SETPOINT_SET, floatValue); 
-        }
-      }
       break;
     }
     
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_NECESSITY_COEFF_RX_ACK_AUTO: {
+    case PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_RX_ACK_AUTO: {
       
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_NECESSITY_COEFF_RX_ACK_AUTO_MAX_SIZE) {
-      
-        float floatValue = *((float *)bytes);
-        if ( valueWithinLimits(floatValue, NECESSITY_COEFF_MIN, NECESSITY_COEFF_MAX) ) {
-          
-          currentConfig.humidityNecessityCoeff = floatValue;
-          persistConfiguration();
+      if (byteCount >= 1) {
+        
+        if (bytes[0] == AUTOTUNE_COMMAND_START) startAutotune();
+        else if (bytes[0] == AUTOTUNE_COMMAND_ABORT && ventFlapAutotuner.state == AutotuneStateRunning) {
           
-          BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_NECESSITY_COEFF_SET, floatValue); 
+          ventFlapAutotuner.abort();
+          finishAutotune();
         }
       }
-      break;
-    }
-    
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_RX_ACK_AUTO: {
-      
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_RX_ACK_AUTO_MAX_SIZE) {
       
-        float floatValue = *((float *)bytes);
-        if ( valueWithinLimits(floatValue, NECESSITY_COEFF_MIN, NECESSITY_COEFF_MAX) ) {
-          
-          currentConfig.temperatureNecessityCoeff = floatValue;
-          persistConfiguration();
-          
-          BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_SET, floatValue); 
-        }
-      }
       break;
     }
     
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_DATETIME_RX_ACK_AUTO: {
-      
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_DATETIME_RX_ACK_AUTO_MAX_SIZE) {
+    case PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_RX_ACK_AUTO: {
       
-        unsigned long bleHostTime = *((unsigned long *)bytes);
-        setTime(bleHostTime);
-        adjustTime(3600);  // Shift time forward 1hr (not sure why necessary to be correct)
+      if (byteCount >= 2 && bytes[0] == BULK_COMMAND_START) {
         
-      }
-      
-      break;
-    }
-    
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_RX_ACK_AUTO: {
-      
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_RX_ACK_AUTO_MAX_SIZE) {
-      
-        currentConfig.illuminationOnMinutes = *((int *)bytes);  // NOTE: Expecting that 'int' type is 2 bytes
-        persistConfiguration();
+        uint16_t fromSequence = (byteCount >= 4) ? (bytes[2] | ((uint16_t) bytes[3] << 8)) : 0;
+        bulkTransfer.start(bytes[1], fromSequence);
         
-        BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_SET, currentConfig.illuminationOnMinutes);
-      }
+      } else if (byteCount >= 1 && bytes[0] == BULK_COMMAND_ABORT) bulkTransfer.abort();
       
       break;
     }
     
-    case PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_RX_ACK_AUTO: {
+    case PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_RX_ACK_AUTO: {
       
-      if (byteCount == PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_RX_ACK_AUTO_MAX_SIZE) {
+      // Report, then the command for it
+      if (byteCount < 2) break;
       
-        currentConfig.illuminationOffMinutes = *((int *)bytes);  // NOTE: Expecting that 'int' type is 2 bytes
-        persistConfiguration();
+      if (bytes[0] == DIAGNOSTICS_REPORT_PHASE_TIMING) {
+        
+        if (bytes[1] == PROFILE_COMMAND_REPORT) profiler.startReport();
+        else if (bytes[1] == PROFILE_COMMAND_RESET) profiler.reset(millis());
+        
+      } else if (bytes[0] == DIAGNOSTICS_REPORT_SAMPLING) {
+        
+        if (bytes[1] == SAMPLING_COMMAND_REPORT) samplingReportRequested = true;
+        else if (bytes[1] == SAMPLING_COMMAND_RESET) sampler.reset(hal_millis64());
+        
+      } else if (bytes[0] == DIAGNOSTICS_REPORT_ACTUATIONS) {
+        
+        if (bytes[1] == ACTUATIONS_COMMAND_REPORT) actuationReportRequested = true;
+        else if (bytes[1] == ACTUATIONS_COMMAND_RESET) ventActuations.reset(hal_millis64());
+        
+      } else if (bytes[0] == DIAGNOSTICS_REPORT_CONFIG) {
+        
+        if (bytes[1] == CONFIG_COMMAND_REPORT) configReportRequested = true;
+        
+      } else if (bytes[0] == DIAGNOSTICS_REPORT_BLE) {
         
-        BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_SET, currentConfig.illuminationOffMinutes);
+        if (bytes[1] == BLE_COMMAND_REPORT) bleReportRequested = true;
       }
       
       break;
@@ -496,111 +1020,99 @@ boolean receivedDataFromPipe(uint8_t *bytes, uint8_t byteCount, uint8_t pipe) {
   }  // end switch(pipe)
 }
 
-// MEASUREMENT
+
+// PERSISTENT CONFIGURATION
 // ----------------------------------------------------
-void enableHoneywellSensor(HoneywellSensor sensorID) {
-  
-   // The transistors switching the SDA (data) line between our two
-   //  HIH6100 I2C devices are controlled by the outputs from an
-   //  8-bit shift register.  Here we set the shift register state
-   //  to enable the +5V output enabling the SDA line for one sensor
-   //  or the other.
-   byte enabledOutputs;
-   
-   switch (sensorID) {
-     
-     case HoneywellSensorNone: enabledOutputs = B00000000; break;
-     case HoneywellSensorExterior: enabledOutputs = B10000000; break;
-     case HoneywellSensorInterior: enabledOutputs = B01000000; break;
-     default: enabledOutputs = B00000000; break;
-   }
-   
-   digitalWrite(shiftRegLatchPin, LOW);
-   shiftOut(shiftRegDataPin, shiftRegClockPin, LSBFIRST, enabledOutputs);
-   digitalWrite(shiftRegLatchPin, HIGH);
-   
-   shiftRegisterState = enabledOutputs;
-   
-//   BLE_board.setValueForCharacteristic(PIPE_GREENHOUSE_STATE_SHIFT_REGISTER_STATE_SET, shiftRegisterState);
-//   BLE_board.notifyClientOfValueForCharacteristic(PIPE_GREENHOUSE_STATE_SHIFT_REGISTER_STATE_TX, shiftRegisterState);
+void configurationChanged(void) {
+  
+  // Applied in RAM already, the EEPROM record waits until the edits stop coming
+  configStore.markDirty(millis());
 }
 
+void commitConfiguration(void) {
+  
+  if (!configStore.dirty) return;
+  
+  // Brown-out on the way, don't wait out the quiet period
+  if (hal_supplyMillivolts() < SUPPLY_WARNING_MILLIVOLTS) persistConfiguration();
+  else configStore.commitIfQuiet(&currentConfig, millis(), CONFIG_QUIET_PERIOD);
+}
 
-// PERSISTENT CONFIGURATION
-// ----------------------------------------------------
 void persistConfiguration(void) {
   
-  const byte* p = (const byte*)(const void*)&currentConfig;
-  unsigned int i;
-  unsigned int ee = 0;
-  for (i = 0; i < sizeof(UserConfig); i++) {  // Write each byte of the struct to EEPROM in series
+  configStore.commit(&currentConfig);
+}
+
+void sendConfigReport(void) {
   
-    EEPROM.write(ee++, *p++);
-  }
+  if (!configReportRequested || diagnosticsPending()) return;
+  
+  ConfigReport report;
+  configStore.fillReport(&report);
+  
+  notifyDiagnostics(DIAGNOSTICS_REPORT_CONFIG, &report, sizeof(ConfigReport));
+  configReportRequested = false;
+}
+
+void watchdogBarked(void) {
+  
+  // Called from the watchdog interrupt, a reset follows unless the loop recovers
+  // NOTE: Skipped if it interrupted an EEPROM access, the record would corrupt it and itself.
+  //   The edits are lost, the stored configuration isn't
+  if (!eepromBusy()) persistConfiguration();
 }
 
 void restoreConfiguration(void) {
   
-  byte* p = (byte*)(void*)&currentConfig;
-  unsigned int i;
-  unsigned int ee = 0;
-  for (i = 0; i < sizeof(UserConfig); i++) {    // Write each byte of the struct to EEPROM in series
+  if (!configStore.restore(&currentConfig)) {  // No record with a good CRC and the current schema
     
-    byte readByte = EEPROM.read(ee++);
+    Serial.println(F("No stored config found.  Setting defaults"));
     
-    if (i == 0 && readByte != 17) {  // Magic number doesn't match what we're expecting
-      
-      Serial.println(F("No stored config found.  Setting defaults"));
-      
-      currentConfig.magicNumber = 18;
-      
-      currentConfig.humiditySetpoint = 30.0f;
-      currentConfig.humidityNecessityCoeff = 1.0;  // Unit-less, coefficient for balancing humidity needs with temperature needs
-      
-      currentConfig.temperatureSetpoint = 21.0f;
-      currentConfig.temperatureNecessityCoeff = 0.75;  // Unit-less, coefficient for balancing humidity needs with temperature needs
-      
-      currentConfig.illuminationOnMinutes = UNAVAILABLE_u;  // Stored as minutes since 12:00AM
-      currentConfig.illuminationOffMinutes = UNAVAILABLE_u;  // Stored as minutes since 12:00AM
-      
-      break;
-    }
+    currentConfig.humiditySetpoint = 30.0f;
+    currentConfig.humidityNecessityCoeff = 1.0;  // Unit-less, coefficient for balancing humidity needs with temperature needs
+    
+    currentConfig.temperatureSetpoint = 21.0f;
+    currentConfig.temperatureNecessityCoeff = 0.75;  // Unit-less, coefficient for balancing humidity needs with temperature needs
+    
+    currentConfig.illuminationOnMinutes = UNAVAILABLE_u;  // Stored as minutes since 12:00AM
+    currentConfig.illuminationOffMinutes = UNAVAILABLE_u;  // Stored as minutes since 12:00AM
+    
+    currentConfig.ventKp = VENT_PID_DEFAULT_KP;
+    currentConfig.ventKi = VENT_PID_DEFAULT_KI;
+    currentConfig.ventKd = VENT_PID_DEFAULT_KD;
+    
+    currentConfig.samplingMinSeconds = SAMPLING_DEFAULT_MIN_SECONDS;
+    currentConfig.samplingMaxSeconds = SAMPLING_DEFAULT_MAX_SECONDS;
     
-    *p++ = readByte;
+    currentConfig.ventFeedForwardHumidity = VENT_FEED_FORWARD_DEFAULT_HUMIDITY;
+    currentConfig.ventFeedForwardTemperature = VENT_FEED_FORWARD_DEFAULT_TEMPERATURE;
+    
+    currentConfig.ventStrategy = VentStrategyPID;
+    currentConfig.ventingNecessityThreshold = VENTING_NECESSITY_DEFAULT_THRESHOLD;
+    currentConfig.ventingNecessityOvershoot = VENTING_NECESSITY_DEFAULT_OVERSHOOT;
+    currentConfig.targetVentingNecessity = VENTING_NECESSITY_DEFAULT_TARGET;
   }
 }
 
-// WATCHDOG
-// ----------------------------------------------------
-
-// Enable the Watchdog timer and configure timer duration
-void startWatchdogTimer() {
+void applyControlConfiguration(void) {
   
-  // Clear the reset flag, the WDRF bit (bit 3) of MCUSR.
-  MCUSR = MCUSR & B11110111;
-    
-  // Set the WDCE bit (bit 4) and the WDE bit (bit 3) 
-  // of WDTCSR. The WDCE bit must be set in order to 
-  // change WDE or the watchdog prescalers. Setting the 
-  // WDCE bit will allow updtaes to the prescalers and 
-  // WDE for 4 clock cycles then it will be reset by 
-  // hardware.
-  WDTCSR = WDTCSR | B00011000; 
+  // Converted once here rather than every control cycle
+  controlConfig.humiditySetpoint = currentConfig.humiditySetpoint;
+  controlConfig.humidityNecessityCoeff = currentConfig.humidityNecessityCoeff;
+  controlConfig.temperatureSetpoint = currentConfig.temperatureSetpoint;
+  controlConfig.temperatureNecessityCoeff = currentConfig.temperatureNecessityCoeff;
   
-  // Set the watchdog timeout prescaler value to 1024 K 
-  // which will yeild a time-out interval of about 8.0 s.
-//  WDTCSR = B00100001;  // ~8s
-  WDTCSR = B00100000;  // ~4s
+  // Taken up by the next control cycle
+  sampler.setBounds(currentConfig.samplingMinSeconds * 1000UL, currentConfig.samplingMaxSeconds * 1000UL);
   
-  // Enable the watchdog timer interupt.
-  WDTCSR = WDTCSR | B01000000;
-  MCUSR = MCUSR & B11110111;
-
-}
-
-// Register function for Watchdog interrupt
-ISR(WDT_vect) {
-    
-    watchdogWokeUp = true;
-    wdt_reset();  // Pet the Watchdog, stop it from forcing hardware reset
+  // Venting continues past the target by the overshoot, a share of the threshold
+  // NOTE: A target at or above the threshold would leave no band, the flap would flip on every
+  //   sample either side of it, so the overshoot is then taken from the threshold instead
+  float overshoot = currentConfig.ventingNecessityThreshold * currentConfig.ventingNecessityOvershoot / 100.0;
+  float closeFrom = (currentConfig.targetVentingNecessity < currentConfig.ventingNecessityThreshold) ? currentConfig.targetVentingNecessity : currentConfig.ventingNecessityThreshold;
+  float closeAt = closeFrom - overshoot;
+  ventSwitch.setLevels(currentConfig.ventingNecessityThreshold, closeAt);
+  
+  // NOTE: Until the first readings, and while the relay has the flap, the change waits to be engaged
+  if (hasInitialData && ventFlapAutotuner.state != AutotuneStateRunning && currentConfig.ventStrategy != activeVentStrategy) engageVentStrategy();
 }
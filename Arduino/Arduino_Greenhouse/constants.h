@@ -14,14 +14,32 @@ typedef enum ClimateState {
   ClimateStateIncreasingHumidity,
   ClimateStateDecreasingHumidity,
   ClimateStateIncreasingTemperature,
-  ClimateStateDecreasingTemperature
+  ClimateStateDecreasingTemperature,
+  ClimateStateCount
   
 };
 
+// Work timed by the phase profiler, see lib_profiler.h
+enum ProfilePhase {
+  
+  ProfilePhaseMeasurements,  // performMeasurements() to measurementsFetched(), the sensor bus working in the background
+  ProfilePhaseAnalysis,  // analyzeSystemState()
+  ProfilePhaseIllumination,  // checkIlluminationTimer()
+  ProfilePhaseACIResponse,  // BLE::waitForACIResponse()
+  ProfilePhaseDataCredit,  // BLE::waitForDataCredit()
+  ProfilePhaseCount
+  
+};
+
+// Run as the climate state machine enters and leaves each state, defined in the sketch
+struct ClimateHooks {
+  
+  static void enter(uint8_t state, uint8_t fromState);
+  static void leave(uint8_t state, uint8_t toState);
+};
+
 typedef struct {
  
-  byte magicNumber;
-  
   float humiditySetpoint;
   float humidityNecessityCoeff;  // Unit-less, coefficient for balancing humidity needs with temperature needs
 
@@ -32,15 +50,103 @@ typedef struct {
   float ventingNecessityOvershoot;  // Percent of ventingNecessityThreshold to overshoot by to reduce frequency of cycling
   float targetVentingNecessity;  // Venting necessity value at which to stop venting
   
-  int illuminationOnMinutes;
-  int illuminationOffMinutes;
+  int16_t illuminationOnMinutes;  // NOTE: Fixed width so the EEPROM layout and BLE payload match on every platform
+  int16_t illuminationOffMinutes;
+  
+  float ventKp;  // Vent flap PID gains, set by autotuning
+  float ventKi;  // per second
+  float ventKd;  // seconds
+  
+  uint8_t samplingMinSeconds;  // Bounds of the adaptive sampling interval, see lib_sampler.h, written together so kept adjacent
+  uint8_t samplingMaxSeconds;
+  
+  float ventFeedForwardHumidity;  // servo degrees per unit of venting necessity per second the exterior humidity trend adds, written together so kept adjacent
+  float ventFeedForwardTemperature;  // ...and the exterior temperature trend, 0 leaves the PID alone
+  
+  uint8_t ventStrategy;  // VentStrategy, see lib_ventStrategy.h, the thresholds above are used by VentStrategyHysteresis
  
 } UserConfig;
 
+#define CONFIG_SCHEMA_VERSION 23  // Change whenever the UserConfig layout changes, stored records are then ignored
+#define CONFIG_STORE_START 0  // EEPROM address
+#define CONFIG_STORE_LENGTH 256  // bytes, as many whole records as fit, at least two (checked in the sketch)
+#define CONFIG_QUIET_PERIOD 5000UL  // ms without an edit before pending configuration is committed
+#define CONFIG_COMMIT_INTERVAL 1000UL  // ms, how often a pending commit is checked for
+#define CONFIG_COMMIT_TASK_PHASE 500UL  // ms
+#define SUPPLY_WARNING_MILLIVOLTS 4500  // Commit at once below this, ahead of the brown-out reset
+
+#define HISTORY_LOG_START 256  // EEPROM address, the rest of the ATmega328's 1024 bytes after the configuration
+#define HISTORY_LOG_LENGTH 768  // bytes, six blocks
+
+#define BULK_STREAM_HISTORY 0  // Bulk transfer streams, the raw history log...
+#define BULK_STREAM_CONFIG 1  // ...and the UserConfig in RAM
+
+#define DIAGNOSTICS_REPORT_PHASE_TIMING 0  // First byte of every Diagnostics Report write and notification, lib_profiler.h...
+#define DIAGNOSTICS_REPORT_SAMPLING 1  // ...lib_sampler.h...
+#define DIAGNOSTICS_REPORT_ACTUATIONS 2  // ...lib_ventStrategy.h...
+#define DIAGNOSTICS_REPORT_CONFIG 3  // ...lib_configStore.h...
+#define DIAGNOSTICS_REPORT_BLE 4  // ...and lib_ble.h
+#define DIAGNOSTICS_REPORT_SIZE 19  // bytes, the most that fits after the report byte in one notification
+
+// Sensor channels, each an HIH6100 whose SDA line one shift register output switches
+// NOTE: Build with a larger INTERIOR_ZONE_COUNT for houses with a sensor per zone, analysis
+//   works from the zones' mean and extremes
+#ifndef INTERIOR_ZONE_COUNT
+#define INTERIOR_ZONE_COUNT 1
+#endif
+#if INTERIOR_ZONE_COUNT < 1 || INTERIOR_ZONE_COUNT > 6
+#error "INTERIOR_ZONE_COUNT must be 1 to 6"
+#endif
+#define SENSOR_CHANNEL_COUNT (1 + INTERIOR_ZONE_COUNT)
+#define SENSOR_CHANNEL_EXTERIOR 0  // Channel numbers, in the order setupHoneywellSensors() adds them
+#define SENSOR_CHANNEL_FIRST_ZONE 1
+#define EXTERIOR_SENSOR_OUTPUT B10000000
+#define INTERIOR_ZONE_OUTPUT(zone) (B01000000 >> (zone))  // Zone 0 on the original interior output, the rest below it
+
 #define UNAVAILABLE_f -12345.678f  // Used for indicating a value has become unavailable
 #define UNAVAILABLE_u -1234  // Used for indicating a value has become unavailable
 
-#define SAMPLING_INTERVAL 4.0  // seconds (NOTE: Must match watchdog timer!)
+// Task schedule
+#define SAMPLING_INTERVAL 4000UL  // ms, sensor reads and vent control until adapted, and the fixed rate savings are counted against
+#define CONTROL_TASK_PHASE 100UL  // ms, runs after the sensor read of the same cycle, which is HIH6100_CONVERSION_TIME (50 ms) in
+#define ILLUMINATION_INTERVAL 15000UL  // ms
+#define ILLUMINATION_TASK_PHASE 1000UL  // ms
+#define HISTORY_INTERVAL 1200000UL  // ms, each logged sample averages the control cycles in it
+#define HISTORY_TASK_PHASE 200UL  // ms, after the control task of the same cycle
+
+#define SAMPLING_DEFAULT_MIN_SECONDS 3  // s, adaptive sampling interval bounds until configured
+#define SAMPLING_DEFAULT_MAX_SECONDS 12  // s
+#define SAMPLER_QUIET_CHANGE 0.5  // unitless, venting necessity change per sample below which the interval grows
+#define SAMPLER_FAST_CHANGE 2.0  // unitless, above which it halves
+#define PID_SAMPLE_FRACTION 0.75  // Of the sampling interval, the slack absorbs the sleep's timekeeping error
+
+#define VENT_PID_DEFAULT_KP 2.5
+#define VENT_PID_DEFAULT_KI 0.25  // per second
+#define VENT_PID_DEFAULT_KD 0.5  // seconds
+#define VENT_FEED_FORWARD_DEFAULT_HUMIDITY 0.0  // servo degrees per unit of venting necessity per second, 0 leaves the PID alone
+#define VENT_FEED_FORWARD_DEFAULT_TEMPERATURE 0.0
+
+#define VENTING_NECESSITY_DEFAULT_THRESHOLD 40.0  // Hysteresis strategy opens the flap here...
+#define VENTING_NECESSITY_DEFAULT_TARGET 0.0  // ...and closes it the overshoot below the target, or below the threshold if the target isn't under it
+#define VENTING_NECESSITY_DEFAULT_OVERSHOOT 25.0  // % of the threshold
+
+#define AUTOTUNE_OUTPUT_STEP 10.0  // servo degrees either side of the vent's position when tuning starts
+#define AUTOTUNE_HYSTERESIS 12.0  // unitless, venting necessity noise band
+#define RESPONSE_TRIGGER_ERROR 20.0  // unitless, venting necessity excursion worth measuring
+
+#define VENTING_NECESSITY_DEADBAND 0.1  // unitless, smaller changes aren't re-sent over BLE
+#define VENTING_NECESSITY_DELTA_DEADBAND 0.001  // unitless per second
+
+#define CLIMATE_HUMIDITY_BAND 3.0  // % RH either side of the setpoint that counts as steady
+#define CLIMATE_TEMPERATURE_BAND 1.0  // °C either side of the setpoint that counts as steady
+
+#define SLEEP_MIN_MILLIS 16UL  // ms, shortest gap before the next task worth sleeping through, one watchdog period
+#define SLEEP_MAX_MILLIS 2000UL  // ms, longest single sleep, well inside the watchdog's reset timeout
+#define SERVO_SETTLE_MILLIS 1000UL  // ms after a vent move during which the servo keeps its pulses, so only idle sleep
+
+#define MCU_ACTIVE_MICROAMPS 9500  // ATmega328 at 16MHz and 5V, datasheet typical, peripherals excluded
+#define MCU_IDLE_MICROAMPS 2700
+#define MCU_POWER_DOWN_MICROAMPS 7  // Watchdog running
 
 
 
@@ -59,7 +165,19 @@ typedef struct {
 #define NECESSITY_THRESHOLD_MIN 10.0  // unitless
 #define NECESSITY_THRESHOLD_MAX 100.0  // unitless
 
+#define FEED_FORWARD_GAIN_MIN 0.0  // servo degrees per unit of venting necessity per second
+#define FEED_FORWARD_GAIN_MAX 1000.0
+
+#define SAMPLING_BOUND_MIN 1  // s, the control task's phase and conversion time fit well inside
+#define SAMPLING_BOUND_MAX 30  // s, the PID's sample time is an int of ms
+
 #define VENTING_OVERSHOOT_MIN 0.0  // % of 'threshold'
 #define VENTING_OVERSHOOT_MAX 50.0  // % of 'threshold'
 
+#define TARGET_NECESSITY_MIN -100.0  // unitless
+#define TARGET_NECESSITY_MAX 100.0  // unitless
+
+#define VENT_STRATEGY_MIN 0  // VentStrategyPID
+#define VENT_STRATEGY_MAX 1  // VentStrategyHysteresis
+
 #endif
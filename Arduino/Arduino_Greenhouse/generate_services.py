@@ -0,0 +1,682 @@
+#!/usr/bin/env python3
+# LICENSES: [a1cdbd]
+# -----------------------------------
+# The contents of this file contains the aggregate of contributions
+#   covered under one or more licences. The full text of those licenses
+#   can be found in the "LICENSES" file at the top level of this project
+#   identified by the MD5 fingerprints listed above.
+
+"""Generates services.h, the pipe descriptor table and the setup report from
+nordic_service_config.xml.
+
+    python3 generate_services.py          # Rewrite services.h, pipe_descriptors.h and ublue_setup.gen.out.txt
+    python3 generate_services.py --check  # Fail if any of them is out of date
+
+services.h gets the pipe definitions and the nRF8001 setup messages, the GATT
+database, pipe table and UUID areas being built from the characteristics in the
+XML.  The header and device settings messages (security, advertising, bonding)
+are kept from the image already in services.h, only their characteristic and
+pipe counts are rewritten.  A profile whose image overflows the nRF8001's
+setup area is rejected.
+
+NOTE: Only fixed length characteristics without a default value, presentation
+  format, indication or write without response are supported, the profile is
+  rejected otherwise.  Open the XML in nRFgo Studio for anything else, or for
+  changes to the GAP settings, then run this to bring the pipes back in line.
+  ACI_DYNAMIC_DATA_SIZE is nRFgo's figure for the original profile, nothing
+  reads it.
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+XML_PATH = os.path.join(HERE, "nordic_service_config.xml")
+SERVICES_PATH = os.path.join(HERE, "services.h")
+DESCRIPTORS_PATH = os.path.join(HERE, "pipe_descriptors.h")
+REPORT_PATH = os.path.join(HERE, "ublue_setup.gen.out.txt")
+
+# Characteristics the client writes a UserConfig field through, handled by
+#   pipeDispatchWrite() instead of a case in receivedDataFromPipe()
+#   name: (type, UserConfig field, minimum, maximum, flags)
+# NOTE: Limits are constants.h names, None leaves the field unbounded.  A list of fields
+#   binds them all to one characteristic, same type and limits, consecutive in UserConfig.
+#   ASCENDING rejects a write whose fields are out of order, for a minimum and maximum pair
+BINDINGS = {
+    "Temperature Setpoint": ("Float", "temperatureSetpoint", "TEMPERATURE_SETPOINT_MIN", "TEMPERATURE_SETPOINT_MAX", ["APPLY_CONTROL"]),
+    "Humidity Setpoint": ("Float", "humiditySetpoint", "HUMIDITY_SETPOINT_MIN", "HUMIDITY_SETPOINT_MAX", ["APPLY_CONTROL"]),
+    "Humidity Necessity Coeff": ("Float", "humidityNecessityCoeff", "NECESSITY_COEFF_MIN", "NECESSITY_COEFF_MAX", ["APPLY_CONTROL"]),
+    "Temperature Necessity Coeff": ("Float", "temperatureNecessityCoeff", "NECESSITY_COEFF_MIN", "NECESSITY_COEFF_MAX", ["APPLY_CONTROL"]),
+    "Illumination On Time": ("Int16", "illuminationOnMinutes", None, None, []),
+    "Illumination Off Time": ("Int16", "illuminationOffMinutes", None, None, []),
+    "Sampling Bounds": ("Uint8", ["samplingMinSeconds", "samplingMaxSeconds"], "SAMPLING_BOUND_MIN", "SAMPLING_BOUND_MAX", ["APPLY_CONTROL", "ASCENDING"]),
+    "Venting Necessity Threshold": ("Float", "ventingNecessityThreshold", "NECESSITY_THRESHOLD_MIN", "NECESSITY_THRESHOLD_MAX", ["APPLY_CONTROL"]),
+    "Venting Necessity Overshoot": ("Float", "ventingNecessityOvershoot", "VENTING_OVERSHOOT_MIN", "VENTING_OVERSHOOT_MAX", ["APPLY_CONTROL"]),
+    "Target Venting Necessity": ("Float", "targetVentingNecessity", "TARGET_NECESSITY_MIN", "TARGET_NECESSITY_MAX", ["APPLY_CONTROL"]),
+    "Feed Forward Gains": ("Float", ["ventFeedForwardHumidity", "ventFeedForwardTemperature"], "FEED_FORWARD_GAIN_MIN", "FEED_FORWARD_GAIN_MAX", []),
+    "Vent Strategy": ("Uint8", "ventStrategy", "VENT_STRATEGY_MIN", "VENT_STRATEGY_MAX", ["APPLY_CONTROL"]),
+}
+
+TYPE_SIZES = {"Float": 4, "Int16": 2, "Uint8": 1, "Uint32": 4}
+
+# aci_pipe_type_t, nRFgo Studio numbers a characteristic's pipes in this (mask bit) order
+PIPE_KINDS = [("TX", 0x0002), ("TX_ACK", 0x0004), ("RX", 0x0008), ("RX_ACK", 0x0010), ("SET", 0x0080), ("RX_ACK_AUTO", 0x0400)]
+
+
+def identifier(name):
+
+    return re.sub(r"[^A-Z0-9]+", "_", name.upper()).strip("_")
+
+
+def flag(element, tag):
+
+    return element.findtext(tag, "false").strip() == "true"
+
+
+def read_profile(xml_path):
+
+    services = []
+    root = ElementTree.parse(xml_path).getroot()
+    number = 0
+
+    for service in root.findall("Service"):
+
+        if service.get("Type") != "local":
+            raise SystemExit("%s: only local services are supported" % service.findtext("Name"))
+
+        uuid = service.find("Uuid")
+        entry = {
+            "name": service.findtext("Name").strip(),
+            "uuid": int(uuid.text, 16),
+            "base": uuid.get("BaseUUID"),
+            "characteristics": [],
+        }
+
+        for characteristic in service.findall("Characteristic"):
+
+            name = characteristic.findtext("Name").strip()
+            properties = characteristic.find("Properties")
+
+            if (flag(properties, "Indicate") or flag(properties, "WriteWithoutResponse") or flag(properties, "Broadcast")
+                    or characteristic.findtext("AttributeLenType").strip() != "1" or characteristic.findtext("DefaultValue", "").strip()
+                    or characteristic.findtext("UsePresentationFormat").strip() != "0"):
+                raise SystemExit("%s: can't be built into the setup image here, use nRFgo Studio" % name)
+
+            uuid = characteristic.find("Uuid")
+            kinds = {
+                "TX": flag(properties, "Notify"),
+                "TX_ACK": flag(properties, "Indicate"),
+                "RX": flag(properties, "WriteWithoutResponse"),
+                "RX_ACK": flag(properties, "Write") and not flag(characteristic, "AckIsAuto"),
+                "SET": flag(characteristic, "SetPipe"),
+                "RX_ACK_AUTO": flag(properties, "Write") and flag(characteristic, "AckIsAuto"),
+            }
+
+            pipes = []
+            for kind, mask in PIPE_KINDS:
+
+                if not kinds[kind]:
+                    continue
+
+                number += 1
+                pipes.append({
+                    "number": number,
+                    "service": entry["name"],
+                    "characteristic": name,
+                    "kind": kind,
+                    "mask": mask,
+                    "size": int(characteristic.findtext("MaxDataLength")),
+                    "define": "PIPE_%s_%s_%s" % (identifier(entry["name"]), identifier(name), kind),
+                })
+
+            entry["characteristics"].append({
+                "name": name,
+                "uuid": int(uuid.text, 16),
+                "base": uuid.get("BaseUUID"),
+                "size": int(characteristic.findtext("MaxDataLength")),
+                "read": kinds["SET"],  # NOTE: Only a set pipe gives the value a local copy to read
+                "write": flag(properties, "Write"),
+                "notify": flag(properties, "Notify"),
+                "pipes": pipes,
+            })
+
+        services.append(entry)
+
+    gap = root.find("Gapsettings")
+    if gap.findtext("DeviceNameWriteLength").strip() != "0" or flag(gap, "LocalPipeOnDeviceName") or flag(gap, "AddServiceUpdateCharacteristic"):
+        raise SystemExit("GAP settings: a writable device name or service changed characteristic needs nRFgo Studio")
+
+    gap_settings = {
+        "name": gap.findtext("Name").strip(),
+        "appearance": int(gap.findtext("Apperance").strip() or "0", 16),
+        "ppcp": [int(gap.findtext(tag)) for tag in ("MinimumConnectionInterval", "MaximumConnectionInterval", "SlaveLatency", "TimeoutMultipler")],
+    }
+
+    return services, gap_settings
+
+
+def read_pipes(services):
+
+    return [pipe for service in services for characteristic in service["characteristics"] for pipe in characteristic["pipes"]]
+
+
+# SETUP IMAGE
+# -------------------------------------------------
+# nRF8001 D setup messages, [length, ACI_CMD_SETUP, target, offset, data...] where the
+#   target picks the area and carries the high bits of the offset
+SETUP_AREA_SIZE = 1595  # bytes, GATT database, pipe table, UUID and extended attribute areas
+SETUP_CHUNK = 28  # data bytes per message
+DEVICE_NAME_SIZE = 20
+
+TARGET_HEADER = 0x00
+TARGET_DEVICE = 0x10
+TARGET_GATT = 0x20
+TARGET_PIPES = 0x40
+TARGET_VS_UUID = 0x50
+TARGET_EXTENDED = 0x60
+TARGET_CRC = 0xF0
+
+UUID_TYPE_SIG = 0x01
+UUID_TYPE_VS = 0x02  # first vendor specific base, the next one is 0x03...
+
+# Characteristic property bits in a declaration
+PROPERTY_READ = 0x02
+PROPERTY_WRITE = 0x08
+PROPERTY_NOTIFY = 0x10
+
+
+def be16(value):
+
+    return [value >> 8, value & 0xFF]
+
+
+def le16(value):
+
+    return [value & 0xFF, value >> 8]
+
+
+def uuid_bytes(uuid, base):
+
+    # Little endian, a vendor specific 16 bit UUID sits in bytes 12-13 of its base
+    if base is None:
+        return le16(uuid)
+
+    return list(bytes.fromhex(base[:4] + "%04X" % uuid + base[8:]))[::-1]
+
+
+def attribute(handle, attribute_type, uuid_type, value, fixed=True, capacity=None, access=0x04, permissions=0x04):
+
+    # [flags, permissions, capacity, length, handle, type, uuid type, value]
+    if capacity is None:
+        capacity = len(value)
+
+    flags = access | (0x02 if fixed else 0)
+    return [flags, permissions, capacity + (1 if fixed else 0), len(value)] + be16(handle) + be16(attribute_type) + [uuid_type] \
+        + list(value) + [0] * (capacity - len(value))
+
+
+def gatt_database(services, gap, bases):
+
+    entries = []
+    rows = []  # (handle, kind, label, pipes, details) for the report
+    handle = [0]
+
+    def next_handle():
+
+        handle[0] += 1
+        return handle[0]
+
+    def declare(uuid, base, properties, label, access):
+
+        declaration = next_handle()
+        value = [properties] + le16(declaration + 1) + uuid_bytes(uuid, base)
+        entries.append(attribute(declaration, 0x2803, UUID_TYPE_SIG, value, fixed=False))
+        rows.append((declaration, "characteristic", label, "", access))
+        return declaration + 1
+
+    # GAP and GATT services, the nRF8001 always has them
+    entries.append(attribute(next_handle(), 0x2800, UUID_TYPE_SIG, le16(0x1800), fixed=False))
+    rows.append((handle[0], "service", '"GAP" (01:0x1800)', "", ""))
+
+    name = gap["name"].encode("ascii")
+    value_handle = declare(0x2A00, None, PROPERTY_READ, '"Device Name" (01:0x2A00) [rd]', "")
+    entries.append(attribute(next_handle(), 0x2A00, UUID_TYPE_SIG, name, fixed=False, capacity=DEVICE_NAME_SIZE))
+    rows.append((value_handle, "value", list(name), "", "[rd:allow|wr:none]"))
+
+    appearance = le16(gap["appearance"])
+    value_handle = declare(0x2A01, None, PROPERTY_READ, '"Appearance" (01:0x2A01) [rd]', "")
+    entries.append(attribute(next_handle(), 0x2A01, UUID_TYPE_SIG, appearance))
+    rows.append((value_handle, "value", appearance, "", "[rd:allow|wr:none]"))
+
+    ppcp = [byte for setting in gap["ppcp"] for byte in le16(setting)]
+    value_handle = declare(0x2A04, None, PROPERTY_READ, '"PPCP" (01:0x2A04) [rd]', "")
+    entries.append(attribute(next_handle(), 0x2A04, UUID_TYPE_SIG, ppcp))
+    rows.append((value_handle, "value", ppcp, "", "[rd:allow|wr:none]"))
+
+    entries.append(attribute(next_handle(), 0x2800, UUID_TYPE_SIG, le16(0x1801), fixed=False))
+    rows.append((handle[0], "service", '"GATT" (01:0x1801)', "", ""))
+
+    pipe_table = []
+
+    for service in services:
+
+        uuid_type = UUID_TYPE_VS + bases.index(service["base"])
+        entries.append(attribute(next_handle(), 0x2800, UUID_TYPE_SIG, uuid_bytes(service["uuid"], service["base"]), fixed=False))
+        rows.append((handle[0], "service", '"?" (%02X:0x%04X)' % (uuid_type, service["uuid"]), "", ""))
+
+        for characteristic in service["characteristics"]:
+
+            uuid_type = UUID_TYPE_VS + bases.index(characteristic["base"])
+            properties = ((PROPERTY_READ if characteristic["read"] else 0) | (PROPERTY_WRITE if characteristic["write"] else 0)
+                          | (PROPERTY_NOTIFY if characteristic["notify"] else 0))
+            label = '"?" (%02X:0x%04X) [%s]' % (uuid_type, characteristic["uuid"], "|".join(
+                tag for tag, present in (("rd", characteristic["read"]), ("wr", characteristic["write"]), ("not", characteristic["notify"])) if present))
+
+            value_handle = declare(characteristic["uuid"], characteristic["base"], properties, label, "")
+            access = 0x04 | (0x40 if characteristic["write"] else 0) | (0x10 if characteristic["notify"] else 0)
+            permissions = (0x04 if characteristic["read"] else 0) | (0x10 if characteristic["write"] else 0)
+            entries.append(attribute(next_handle(), characteristic["uuid"], uuid_type, [0] * characteristic["size"], access=access, permissions=permissions))
+
+            kinds = [pipe["kind"] for pipe in characteristic["pipes"]]
+            marks = ("<" if any(kind.startswith("RX") for kind in kinds) else " ") + ("x" if "SET" in kinds else " ") \
+                + (">" if any(kind.startswith("TX") for kind in kinds) else " ")
+            rows.append((value_handle, "value", [0] * characteristic["size"], marks, "[rd:%s|wr:%s]" % (
+                "allow" if characteristic["read"] else "none", "allow" if characteristic["write"] else "none")))
+
+            descriptor = 0
+            if characteristic["notify"]:
+                descriptor = next_handle()
+                entries.append(attribute(descriptor, 0x2902, UUID_TYPE_SIG, [0, 0], access=0x46, permissions=0x14))
+                rows.append((descriptor, "descriptor", "", "", ""))
+
+            if characteristic["pipes"]:
+                mask = 0
+                for pipe in characteristic["pipes"]:
+                    mask |= pipe["mask"]
+                pipe_table.append(be16(characteristic["uuid"]) + [uuid_type] + be16(mask) + [0x04] + be16(value_handle) + be16(descriptor))
+
+    database = [byte for entry in entries for byte in entry] + [0x00]
+    return database, pipe_table, rows
+
+
+def read_image(current):
+
+    # Area contents by target, from the SETUP_MESSAGES_CONTENT already in services.h
+    start = current.find("#define SETUP_MESSAGES_CONTENT")
+    if start < 0:
+        raise SystemExit("services.h: no setup messages, generate the file once with nRFgo Studio")
+
+    areas = {}
+    for message in re.findall(r"\{0x00,\\\s*\{\\(.*?)\},\\", current[start:], re.S):
+
+        data = [int(byte, 16) for byte in re.findall(r"0x([0-9a-fA-F]{2})", message)]
+        target, offset = data[2] & 0xF0, ((data[2] & 0x0F) << 8) | data[3]
+        area = areas.setdefault(target, [])
+        area[len(area):] = [0] * (offset + len(data) - 4 - len(area))
+        area[offset:offset + len(data) - 4] = data[4:]
+
+    return areas
+
+
+def crc16(data):
+
+    # CRC-16-CCITT, the nRF8001 checks it against the last setup message
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+
+    return crc
+
+
+def setup_image(services, gap, current):
+
+    areas = read_image(current)
+    pipes = read_pipes(services)
+
+    bases = []
+    for service in services:
+        for base in [service["base"]] + [characteristic["base"] for characteristic in service["characteristics"]]:
+            if base not in bases:
+                bases.append(base)
+
+    database, pipe_table, rows = gatt_database(services, gap, bases)
+
+    # NOTE: Counts as nRFgo Studio writes them, characteristics with pipes then pipes
+    device = list(areas[TARGET_DEVICE])
+    device[6] = len(pipe_table)
+    device[8] = len(pipes)
+
+    layout = {
+        "database": len(database),
+        "pipes": len(pipe_table) * 10,
+        "vs_uuid": len(bases) * 16,
+        "extended": len(pipe_table) * 3,
+    }
+    used = sum(layout.values())
+    if used > SETUP_AREA_SIZE:
+        raise SystemExit("setup image: %d bytes, the nRF8001 holds %d" % (used, SETUP_AREA_SIZE))
+
+    messages = []
+    for target, data in [
+            (TARGET_HEADER, areas[TARGET_HEADER]),
+            (TARGET_DEVICE, device),
+            (TARGET_GATT, database),
+            (TARGET_PIPES, [byte for entry in pipe_table for byte in entry]),
+            (TARGET_VS_UUID, [byte for base in bases for byte in uuid_bytes(0x0000, base)]),
+            (TARGET_EXTENDED, [0] * layout["extended"])]:
+
+        for offset in range(0, len(data), SETUP_CHUNK):
+            chunk = data[offset:offset + SETUP_CHUNK]
+            messages.append([len(chunk) + 3, 0x06, target | (offset >> 8), offset & 0xFF] + chunk)
+
+    trailer = [0x06, 0x06, TARGET_CRC, 0x00, areas[TARGET_HEADER][0]]
+    crc = crc16([byte for message in messages for byte in message] + trailer)
+    messages.append(trailer + be16(crc))
+
+    return {"messages": messages, "layout": layout, "rows": rows, "bases": bases, "pipes": pipes,
+            "characteristics": len(pipe_table), "services": services}
+
+
+# SERVICES.H
+# -------------------------------------------------
+def pipe_section(pipes):
+
+    lines = []
+
+    for pipe in pipes:
+
+        lines.append("/* Service: %s - Characteristic: %s - Pipe: %s */" % (pipe["service"], pipe["characteristic"], pipe["kind"]))
+        lines.append("#define %s          %d" % (pipe["define"], pipe["number"]))
+        lines.append("#define %s_MAX_SIZE %d" % (pipe["define"], pipe["size"]))
+        lines.append("")
+
+    lines.append("")
+    lines.append("#define NUMBER_OF_PIPES %d" % len(pipes))
+    lines.append("")
+    lines.append("#define SERVICES_PIPE_TYPE_MAPPING_CONTENT {\\")
+
+    for pipe in pipes:
+
+        lines.append("  {ACI_STORE_LOCAL, ACI_%s},   \\" % pipe["kind"])
+
+    lines.append("}")
+
+    return "\n".join(lines) + "\n"
+
+
+def setup_section(messages):
+
+    lines = [
+        "#define NB_SETUP_MESSAGES %d" % len(messages),
+        "#define SETUP_MESSAGES_CONTENT {\\",
+    ]
+
+    for message in messages:
+
+        lines.append("    {0x00,\\")
+        lines.append("        {\\")
+        for i in range(0, len(message), 20):
+            lines.append("            " + "".join("0x%02x," % byte for byte in message[i:i + 20]) + "\\")
+        lines.append("        },\\")
+        lines.append("    },\\")
+
+    lines.append("}")
+
+    return "\n".join(lines) + "\n"
+
+
+def services_header(pipes, image, current):
+
+    # Replaces the first pipe comment through the end of the pipe type mapping...
+    start = current.find("/* Service:")
+    mapping = current.find("#define SERVICES_PIPE_TYPE_MAPPING_CONTENT")
+    end = current.find("}\n", mapping) + 2
+
+    if start < 0 or mapping < 0:
+        raise SystemExit("services.h: pipe section not found, generate the file once with nRFgo Studio")
+
+    # ...and the setup messages, the GAP connection parameters between them are left alone
+    setup_start = current.find("#define NB_SETUP_MESSAGES")
+    setup_end = current.find("}\n", current.find("#define SETUP_MESSAGES_CONTENT")) + 2
+
+    return current[:start] + pipe_section(pipes) + current[end:setup_start] + setup_section(image["messages"]) + current[setup_end:]
+
+
+# UBLUE_SETUP.GEN.OUT.TXT
+# -------------------------------------------------
+# nRFgo Studio's report on the image, the sections describing the GATT database and
+#   setup data are rewritten, the device settings and advertising ones kept
+def report_sections(image):
+
+    layout = image["layout"]
+    used = sum(layout.values())
+    pipes = image["pipes"]
+
+    counts = [
+        "Setup data size          = %4d bytes" % sum(len(message) for message in image["messages"]),
+        "Local database size      = %4d bytes" % layout["database"],
+        "Local attribute count    = %4d" % image["characteristics"],
+        "Remote attribute count   =    0",
+        "Total pipe count         = %4d" % len(pipes),
+    ]
+
+    area = [
+        "Setup area, total    = %4d bytes" % SETUP_AREA_SIZE,
+        "Setup area, used     = %4d bytes (%3d%% of total )" % (used, used * 100 // SETUP_AREA_SIZE),
+    ]
+    for label, size in (("Local services", layout["database"]), ("Remote services", 0), ("Pipes", layout["pipes"]),
+                        ("VS UUID area", layout["vs_uuid"]), ("Extended Attr area", layout["extended"])):
+        area.append("%-20s = %4d bytes (%3d%% of used  )" % (label, size, size * 100 // used))
+
+    uuids = ["VS UUID #%d (type=0x%02X):  %s" % (i, UUID_TYPE_VS + i, " ".join("0x%02X" % byte for byte in uuid_bytes(0x0000, base)))
+             for i, base in enumerate(image["bases"])]
+
+    database = ["Handle  Pipes  Structure", "------  -----  ---------"]
+    for handle, kind, label, marks, access in image["rows"]:
+
+        if kind == "service":
+            database.append("0x%04X         +----- Service (Primary): %s" % (handle, label))
+        elif kind == "characteristic":
+            database.append("0x%04X            |----- |Characteristic: %s [rd:allow|wr:none]" % (handle, label))
+        elif kind == "value":
+            database.append("0x%04X   %3s             |Value: {%s} %s" % (handle, marks, " ".join("0x%02X" % byte for byte in label), access))
+        else:
+            database.append("0x%04X                |----- |Descriptor: \"Client Characteristic Configuration\" (01:0x2902) "
+                            "Value: {0x00 0x00} [rd:allow|wr:allow]" % handle)
+
+    uuid_types = {}
+    for service in image["services"]:
+        for characteristic in service["characteristics"]:
+            for pipe in characteristic["pipes"]:
+                uuid_types[pipe["number"]] = (UUID_TYPE_VS + image["bases"].index(service["base"]), service["uuid"],
+                                              UUID_TYPE_VS + image["bases"].index(characteristic["base"]), characteristic["uuid"])
+
+    pipe_map = [
+        "Pipe   Store    Type     Service      Char.       CPF           Desc.    ",
+        "----   ------   ------   ----------   ---------   -----------   ---------",
+    ]
+    for pipe in pipes:
+
+        kind = "RX_AA" if pipe["kind"] == "RX_ACK_AUTO" else pipe["kind"]
+        pipe_map.append("%02d     Local    %-6s   %02X:0x%04X    %02X:0x%04X       --           --   " % ((pipe["number"], kind) + uuid_types[pipe["number"]]))
+
+    setup_data = ["-".join("%02X" % byte for byte in message) for message in image["messages"]]
+
+    return {
+        "Counts": counts,
+        "Setup Area Layout": area,
+        "Vendor Specific UUIDs": uuids,
+        "Local Database": database,
+        "Pipe Map": pipe_map,
+        "Setup Data": setup_data,
+    }
+
+
+def report(image, current):
+
+    lines = current.split("\n")
+    first = next(i for i, line in enumerate(lines) if line.startswith("["))
+
+    # NOTE: A fixed header, so --check only fails when the image itself has changed
+    header = [line for line in lines[:first] if not line.startswith(" Generated")]
+    header.insert(2, " Generated by generate_services.py from nordic_service_config.xml")
+
+    sections = report_sections(image)
+    output = header
+
+    i = first
+    while i < len(lines):
+
+        title = lines[i]
+        end = next((j for j in range(i + 1, len(lines)) if lines[j].startswith("[")), len(lines))
+        name = title.strip().strip("[]")
+
+        if name in sections:
+            output += [title, ""] + sections[name] + ([""] if end < len(lines) else [])
+        else:
+            output += lines[i:end]
+
+        i = end
+
+    return "\n".join(output).rstrip("\n") + "\n"
+
+
+# PIPE_DESCRIPTORS.H
+# -------------------------------------------------
+def descriptors_header(pipes):
+
+    by_name = {}
+    for pipe in pipes:
+        by_name.setdefault(pipe["characteristic"], {})[pipe["kind"]] = pipe
+
+    entries = []
+
+    for name, (value_type, fields, minimum, maximum, flags) in BINDINGS.items():
+
+        if name not in by_name or "RX_ACK_AUTO" not in by_name[name]:
+            raise SystemExit("%s: bound, but isn't a writable characteristic" % name)
+
+        rx = by_name[name]["RX_ACK_AUTO"]
+        echo = by_name[name].get("SET")
+
+        fields = fields if isinstance(fields, list) else [fields]
+        if rx["size"] != TYPE_SIZES[value_type] * len(fields):
+            raise SystemExit("%s: MaxDataLength %d doesn't fit %d %s" % (name, rx["size"], len(fields), value_type))
+
+        flags = list(flags)
+        if "ASCENDING" in flags and len(fields) < 2:
+            raise SystemExit("%s: ASCENDING needs more than one field" % name)
+        if minimum is None:
+            flags.append("UNBOUNDED")
+
+        entries.append((rx, echo, value_type, fields, minimum, maximum, flags))
+
+    entries.sort(key=lambda entry: entry[0]["number"])
+    index = {entry[0]["number"]: position for position, entry in enumerate(entries)}
+
+    lines = [
+        "// Generated by generate_services.py from nordic_service_config.xml, don't edit",
+        "",
+        "#ifndef PipeDescriptors_h",
+        "#define PipeDescriptors_h",
+        "",
+        "#include <stddef.h>",
+        "#include <avr/pgmspace.h>",
+        "#include \"constants.h\"",
+        "#include \"services.h\"",
+        "#include \"lib_pipeDispatch.h\"",
+        "",
+        "#define PIPE_DESCRIPTOR_COUNT %d" % len(entries),
+        "",
+        "static const PipeDescriptor pipeDescriptors[PIPE_DESCRIPTOR_COUNT] PROGMEM = {",
+    ]
+
+    for rx, echo, value_type, fields, minimum, maximum, flags in entries:
+
+        flag_expression = " | ".join("PIPE_FLAG_%s" % f for f in flags) or "0"
+        lines.append("  { %s, %s, PipeValue%s, %d, %d, offsetof(UserConfig, %s), %s, %s, %s }," % (
+            rx["define"], echo["define"] if echo else "PIPE_NONE", value_type, rx["size"], len(fields), fields[0],
+            flag_expression, minimum or "0", maximum or "0"))
+
+    lines.append("};")
+    lines.append("")
+
+    # One write fills a characteristic's fields in one go, so they have to be packed together
+    packed = [(fields[i - 1], field) for _, _, _, fields, _, _, _ in entries for i, field in enumerate(fields) if i > 0]
+    for previous, field in packed:
+        lines.append("static_assert(offsetof(UserConfig, %s) == offsetof(UserConfig, %s) + sizeof(UserConfig::%s), \"%s doesn't follow %s\");" % (
+            field, previous, previous, field, previous))
+
+    if packed:
+        lines.append("")
+    lines.append("// Position in pipeDescriptors by pipe number, PIPE_DESCRIPTOR_NONE for pipes handled elsewhere")
+    lines.append("static const uint8_t pipeDescriptorIndex[NUMBER_OF_PIPES + 1] PROGMEM = {")
+
+    row = []
+    for number in range(len(pipes) + 1):
+        row.append(str(index[number]) if number in index else "PIPE_DESCRIPTOR_NONE")
+
+    for i in range(0, len(row), 8):
+        lines.append("  " + ", ".join(row[i:i + 8]) + ",")
+
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif")
+
+    return "\n".join(lines) + "\n"
+
+
+def main():
+
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="report stale output instead of writing it")
+    args = parser.parse_args()
+
+    services, gap = read_profile(XML_PATH)
+    pipes = read_pipes(services)
+
+    # NOTE: nRFgo Studio writes CRLF, kept so the diff only shows real changes
+    current = {}
+    for path in (SERVICES_PATH, REPORT_PATH):
+        with open(path, newline="") as f:
+            current[path] = f.read()
+
+    newline = {path: "\r\n" if "\r\n" in contents else "\n" for path, contents in current.items()}
+    current = {path: contents.replace("\r\n", "\n") for path, contents in current.items()}
+
+    image = setup_image(services, gap, current[SERVICES_PATH])
+
+    outputs = [
+        (SERVICES_PATH, services_header(pipes, image, current[SERVICES_PATH]).replace("\n", newline[SERVICES_PATH])),
+        (DESCRIPTORS_PATH, descriptors_header(pipes)),
+        (REPORT_PATH, report(image, current[REPORT_PATH]).replace("\n", newline[REPORT_PATH])),
+    ]
+
+    stale = False
+    for path, contents in outputs:
+
+        existing = open(path, newline="").read() if os.path.exists(path) else None
+        if existing == contents:
+            continue
+
+        stale = True
+        if args.check:
+            print("%s is out of date" % os.path.basename(path))
+        else:
+            with open(path, "w", newline="") as f:
+                f.write(contents)
+            print("wrote %s" % os.path.basename(path))
+
+    used = sum(image["layout"].values())
+    print("%d pipes, %d bound to UserConfig; setup area %d of %d bytes" % (len(pipes), len(BINDINGS), used, SETUP_AREA_SIZE))
+    return 1 if (stale and args.check) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_autotune.h"
+
+
+// RELAY AUTOTUNER
+// ----------------------------------------------------
+RelayAutotuner::RelayAutotuner(void) {
+  
+  state = AutotuneStateIdle;
+  cycleCount = 0;
+  ultimateGain = 0;
+  ultimatePeriod = 0;
+}
+
+void RelayAutotuner::start(double reference, double outputCenter, double outputStep, double hysteresis, unsigned long now) {
+  
+  _reference = reference;
+  _outputCenter = outputCenter;
+  _outputStep = outputStep;
+  _hysteresis = hysteresis;
+  
+  _relayHigh = true;
+  _lastSwitch = now;
+  _lastSwitchDown = now;
+  _peakHigh = reference;
+  _peakLow = reference;
+  _lastPeriod = 0;
+  _lastAmplitude = 0;
+  
+  cycleCount = 0;
+  ultimateGain = 0;
+  ultimatePeriod = 0;
+  state = AutotuneStateRunning;
+}
+
+void RelayAutotuner::abort(void) {
+  
+  if (state == AutotuneStateRunning) state = AutotuneStateAborted;
+}
+
+boolean RelayAutotuner::update(double input, unsigned long now, double *output) {
+  
+  if (state != AutotuneStateRunning) return true;
+  
+  if (input > _peakHigh) _peakHigh = input;
+  if (input < _peakLow) _peakLow = input;
+  
+  if (_relayHigh && input > _reference + _hysteresis) {
+    
+    // Switching down closes one full cycle, measure it
+    _relayHigh = false;
+    _lastSwitch = now;
+    
+    double period = (now - _lastSwitchDown) / 1e3;
+    double amplitude = (_peakHigh - _peakLow) / 2.0;
+    _lastSwitchDown = now;
+    
+    // The first switch only starts the oscillation, there's no cycle before it
+    if (cycleCount++ > 0) {
+      
+      boolean agrees = (_lastPeriod > 0) && (fabs(period - _lastPeriod) <= AUTOTUNE_AGREEMENT * _lastPeriod)
+                                         && (fabs(amplitude - _lastAmplitude) <= AUTOTUNE_AGREEMENT * _lastAmplitude);
+      
+      _lastPeriod = period;
+      _lastAmplitude = amplitude;
+      
+      if (agrees && cycleCount > AUTOTUNE_MIN_CYCLES && amplitude > _hysteresis) {
+        
+        // Describing function of a relay with hysteresis
+        ultimateGain = (4.0 * _outputStep) / (M_PI * sqrt(amplitude * amplitude - _hysteresis * _hysteresis));
+        ultimatePeriod = period;
+        state = AutotuneStateSucceeded;
+      }
+    }
+    
+    // Start the next cycle's extremes from here
+    _peakHigh = input;
+    _peakLow = input;
+    
+  } else if (!_relayHigh && input < _reference - _hysteresis) {
+    
+    _relayHigh = true;
+    _lastSwitch = now;
+  }
+  
+  if (state == AutotuneStateRunning && (cycleCount > AUTOTUNE_MAX_CYCLES || now - _lastSwitch > AUTOTUNE_SWITCH_TIMEOUT)) state = AutotuneStateFailed;
+  
+  *output = _relayHigh ? (_outputCenter + _outputStep) : (_outputCenter - _outputStep);
+  
+  return (state != AutotuneStateRunning);
+}
+
+boolean RelayAutotuner::tuningsForUltimate(double *kp, double *ki, double *kd) {
+  
+  if (state != AutotuneStateSucceeded) return false;
+  
+  // Tyreus-Luyben, gentler than Ziegler-Nichols and better suited to a slow thermal process
+  double integralTime = 2.2 * ultimatePeriod;
+  double derivativeTime = ultimatePeriod / 6.3;
+  
+  *kp = ultimateGain / 2.2;
+  *ki = *kp / integralTime;
+  *kd = *kp * derivativeTime;
+  
+  return true;
+}
+
+
+// RESPONSE MONITOR
+// ----------------------------------------------------
+ResponseMonitor::ResponseMonitor(double triggerError) {
+  
+  _triggerError = triggerError;
+  
+  settlingTime = 0;
+  overshoot = 0;
+  responseCount = 0;
+  
+  reset();
+}
+
+void ResponseMonitor::reset(void) {
+  
+  _tracking = false;
+}
+
+boolean ResponseMonitor::update(double error, unsigned long now) {
+  
+  if (!_tracking) {
+    
+    if (fabs(error) < _triggerError) return false;
+    
+    // A disturbance has pushed the error out, follow it from here
+    _tracking = true;
+    _peakError = error;
+    _peakTime = now;
+    _overshootError = 0;
+    _withinBand = false;
+  }
+  
+  boolean samePolarity = (error > 0) == (_peakError > 0);
+  
+  if (samePolarity && fabs(error) > fabs(_peakError)) {
+    
+    // Still being pushed away, the response starts from the peak
+    _peakError = error;
+    _peakTime = now;
+    _overshootError = 0;
+    _withinBand = false;
+    
+  } else if (!samePolarity && fabs(error) > _overshootError) {
+    
+    _overshootError = fabs(error);
+  }
+  
+  if (fabs(error) <= RESPONSE_SETTLE_FRACTION * fabs(_peakError)) {
+    
+    if (!_withinBand) {
+      
+      _withinBand = true;
+      _withinBandSince = now;
+      
+    } else if (now - _withinBandSince >= RESPONSE_SETTLE_HOLD) {
+      
+      settlingTime = (_withinBandSince - _peakTime) / 1000;
+      double overshootPercent = 100.0 * _overshootError / fabs(_peakError);
+      overshoot = (overshootPercent > 255.0) ? 255 : (uint8_t) overshootPercent;
+      responseCount++;
+      _tracking = false;
+      
+      return true;
+    }
+    
+  } else _withinBand = false;
+  
+  if (now - _peakTime > RESPONSE_TIMEOUT) _tracking = false;  // Never settled, not a usable measurement
+  
+  return false;
+}
@@ -0,0 +1,106 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Autotune_h
+#define Autotune_h
+
+#define AUTOTUNE_MIN_CYCLES 3  // Relay cycles before results are trusted
+#define AUTOTUNE_MAX_CYCLES 20
+#define AUTOTUNE_AGREEMENT 0.2  // Fraction by which consecutive cycles' period and amplitude may differ
+#define AUTOTUNE_SWITCH_TIMEOUT 10800000UL  // ms, a loop that stops crossing the reference will never finish by itself
+
+#define AUTOTUNE_COMMAND_ABORT 0  // Written to the Vent PID Tuning characteristic
+#define AUTOTUNE_COMMAND_START 1
+
+#define RESPONSE_SETTLE_FRACTION 0.1  // Settled once within this fraction of the peak error...
+#define RESPONSE_SETTLE_HOLD 300000UL  // ms, ...for this long
+#define RESPONSE_TIMEOUT 14400000UL  // ms, give up on a response that never settles
+
+// TYPES
+// -------------------------------------------------
+enum AutotuneState {
+
+  AutotuneStateIdle,
+  AutotuneStateRunning,
+  AutotuneStateSucceeded,
+  AutotuneStateFailed,  // Never oscillated steadily or timed out, previous gains kept
+  AutotuneStateAborted
+
+};
+
+// Sent over the Vent PID Tuning characteristic, fits a single 20-byte packet
+// NOTE: Multi-byte fields are little-endian, as laid out by the AVR
+typedef struct __attribute__((packed)) {
+
+  uint8_t state;  // AutotuneState
+  float kp;
+  float ki;  // per second
+  float kd;  // seconds
+  uint16_t settlingTimeBefore;  // s, last disturbance settled with the previous gains, 0 if none measured
+  uint16_t settlingTimeAfter;  // s, first disturbance settled with the new gains
+  uint8_t overshootBefore;  // % of the peak error
+  uint8_t overshootAfter;
+
+} TuningReport;
+
+
+// Class Definitions
+// -------------------------------------------------
+
+// Åström–Hägglund relay experiment
+// NOTE: The relay drives the output between (center ± step), switching when the input crosses
+//   the reference by more than the hysteresis.  The loop then oscillates at its ultimate period
+//   with an amplitude that gives the ultimate gain.
+class RelayAutotuner {
+
+  public:
+    RelayAutotuner(void);
+
+    void start(double reference, double outputCenter, double outputStep, double hysteresis, unsigned long now);
+    void abort(void);
+    boolean update(double input, unsigned long now, double *output);  // Returns true when the experiment has ended
+
+    boolean tuningsForUltimate(double *kp, double *ki, double *kd);  // Tyreus-Luyben rules
+
+    AutotuneState state;
+    uint8_t cycleCount;
+    double ultimateGain;
+    double ultimatePeriod;  // s
+
+  private:
+    double _reference, _outputCenter, _outputStep, _hysteresis;
+    boolean _relayHigh;
+    unsigned long _lastSwitch;  // ms
+    unsigned long _lastSwitchDown;  // ms, when the relay last switched to low
+    double _peakHigh, _peakLow;  // Input extremes in the current cycle
+    double _lastPeriod, _lastAmplitude;
+};
+
+// Measures overshoot and settling time of each excursion of a control error
+class ResponseMonitor {
+
+  public:
+    ResponseMonitor(double triggerError);
+
+    void reset(void);
+    boolean update(double error, unsigned long now);  // Returns true when a response has just settled
+
+    unsigned long settlingTime;  // s, of the last settled response
+    uint8_t overshoot;  // % of the peak error
+    unsigned int responseCount;
+
+  private:
+    double _triggerError;
+    boolean _tracking;
+    double _peakError;
+    unsigned long _peakTime;
+    double _overshootError;
+    unsigned long _withinBandSince;
+    boolean _withinBand;
+};
+
+#endif
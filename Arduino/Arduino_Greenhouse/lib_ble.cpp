@@ -6,6 +6,7 @@
 //   identified by the MD5 fingerprints listed above.
 
 #include "lib_ble.h"
+#include "lib_profiler.h"
 
 #define ADVERTISING_INTERVAL 510  // (multiple of 0.625ms)
 #define ADVERTISING_TIMEOUT 30 // sec (0 means never)
@@ -78,6 +79,67 @@ Timing change state variable
 */
 static boolean timing_change_done          = false;
 
+/*
+Link state for deciding whether the MCU may sleep, see BLE::readyToSleep()
+*/
+static boolean connected                   = false;
+static boolean aci_idle                    = false;  // Last aci_loop() found no event and no setup in progress
+
+/*
+Bounded waits for command responses and data credits, see BLE::waitUntilCleared()
+*/
+static unsigned long radioWaitSpent = 0;  // ms waited since the last ble_loop()
+static uint8_t consecutiveTimeouts = 0;
+static boolean radioDown = false;  // Waiting for the nRF8001 to restart, nothing is sent meanwhile
+static boolean radioReinitRequested = false;
+static unsigned long radioReinitAt = 0;  // ms
+static unsigned long radioTimeouts[BLETimeoutClassCount];
+static unsigned long radioOverBudget = 0;
+static unsigned long radioReinits = 0;
+
+/*
+Ring of notifications waiting for a data credit.  Filled by BLE::notifyClientOfValueForCharacteristic()
+and drained by aci_loop() whenever aci_state.data_credit_available allows it.
+*/
+typedef struct {
+  
+  uint8_t pipe;
+  uint8_t byteCount;
+  uint8_t buffer[NOTIFICATION_MAX_SIZE];
+  
+} PendingNotification;
+
+static PendingNotification notificationQueue[NOTIFICATION_QUEUE_DEPTH];
+static uint8_t notificationQueueHead = 0;  // Index of the oldest pending notification
+static uint8_t notificationQueueCount = 0;
+static unsigned long notificationsSent = 0;
+static unsigned long notificationsDropped = 0;
+
+/*
+Stream sent in the credits left over once the notification queue is empty, see BLE::setBulkTransfer()
+*/
+static BulkTransfer *bulkTransfer = NULL;
+static uint8_t bulkTransferPipe = 0;
+
+/*
+Shadow copy of the last scalar value set or notified on each pipe (indexed by pipe number),
+so that writes which would not change anything never reach the ACI command queue.
+A notification is shadowed when it is queued, and the shadow dropped again with it if it never goes out.
+*/
+typedef struct {
+  
+  uint8_t pipe;
+  float deadband;
+  
+} PipeDeadband;
+
+static uint8_t pipeShadowValues[NUMBER_OF_PIPES + 1][PIPE_SHADOW_SIZE];
+static uint8_t pipeShadowValid[(NUMBER_OF_PIPES / 8) + 1];  // Bitmap
+static PipeDeadband pipeDeadbands[PIPE_DEADBAND_SLOTS];
+static uint8_t pipeDeadbandCount = 0;
+static unsigned long pipeWritesSent = 0;
+static unsigned long pipeWritesSuppressed = 0;
+
 /*
 Initialize the radio_ack. This is the ack received for every transmitted packet.
 */
@@ -99,6 +161,156 @@ The ACI Evt Data Credit provides the radio level ack of a transmitted packet.
 
 ACIPostEventHandler postEventHandlerFn;
 
+void invalidate_pipe_shadow(uint8_t pipe)
+{
+  if (pipe > NUMBER_OF_PIPES) return;
+  
+  pipeShadowValid[pipe / 8] &= ~(1 << (pipe % 8));
+}
+
+void drop_notification(PendingNotification *notification)
+{
+  // The client never got this value, so the next one for the pipe must not be suppressed against it
+  invalidate_pipe_shadow(notification->pipe);
+  notificationsDropped++;
+}
+
+void clear_notification_queue(void)
+{
+  for (uint8_t i = 0; i < notificationQueueCount; i++)
+  {
+    drop_notification(&notificationQueue[(notificationQueueHead + i) % NOTIFICATION_QUEUE_DEPTH]);
+  }
+  
+  notificationQueueHead = 0;
+  notificationQueueCount = 0;
+}
+
+void request_radio_reinit(void)
+{
+  // Done from ble_loop(), not from inside whichever wait gave up
+  radioDown = true;
+  radioReinitRequested = true;
+}
+
+void reinit_radio(void)
+{
+  Serial.println(F("Radio not responding, re-initialising"));
+  
+  radioReinitRequested = false;
+  radioReinitAt = millis();
+  radioReinits++;
+  consecutiveTimeouts = 0;
+  
+  connected = false;
+  aci_idle = false;
+  clear_notification_queue();
+  
+  // Flushes the transport's queues and pin state, then restarts the nRF8001, which keeps its setup
+  // NOTE: The RedBearLab shield has no reset line, a RadioReset command stands in for it
+  lib_aci_init(&aci_state, false);
+  lib_aci_radio_reset();
+}
+
+void invalidate_pipe_shadows(boolean transmitPipesOnly)
+{
+  for (uint8_t pipe = 1; pipe <= NUMBER_OF_PIPES; pipe++)
+  {
+    if (transmitPipesOnly)
+    {
+      aci_pipe_type_t pipeType = services_pipe_type_mapping[pipe - 1].pipe_type;
+      if (ACI_TX != pipeType && ACI_TX_ACK != pipeType) continue;
+    }
+    
+    invalidate_pipe_shadow(pipe);
+  }
+}
+
+boolean pipe_shadow_matches(uint8_t pipe, uint8_t *buffer, uint8_t byteCount, boolean isFloat)
+{
+  if (pipe > NUMBER_OF_PIPES || byteCount > PIPE_SHADOW_SIZE) return false;
+  if (!(pipeShadowValid[pipe / 8] & (1 << (pipe % 8)))) return false;
+  
+  if (isFloat)
+  {
+    float lastValue, newValue;
+    memcpy(&lastValue, pipeShadowValues[pipe], sizeof(float));
+    memcpy(&newValue, buffer, sizeof(float));
+    
+    for (uint8_t i = 0; i < pipeDeadbandCount; i++)
+    {
+      if (pipeDeadbands[i].pipe == pipe) return (fabs(newValue - lastValue) <= pipeDeadbands[i].deadband);
+    }
+  }
+  
+  // Bytes, and floats without a deadband, must match exactly
+  return (memcmp(pipeShadowValues[pipe], buffer, byteCount) == 0);
+}
+
+void pipe_shadow_store(uint8_t pipe, uint8_t *buffer, uint8_t byteCount)
+{
+  if (pipe > NUMBER_OF_PIPES || byteCount > PIPE_SHADOW_SIZE) return;
+  
+  memcpy(pipeShadowValues[pipe], buffer, byteCount);
+  pipeShadowValid[pipe / 8] |= (1 << (pipe % 8));
+}
+
+void drain_notification_queue(void)
+{
+  while ((notificationQueueCount > 0) && (aci_state.data_credit_available >= 1))
+  {
+    PendingNotification *notification = &notificationQueue[notificationQueueHead];
+    
+    if (lib_aci_is_pipe_available(&aci_state, notification->pipe))
+    {
+      if (!lib_aci_send_data(notification->pipe, notification->buffer, notification->byteCount))
+      {
+        // ACI command queue is full, try again on the next pass
+        break;
+      }
+      
+      aci_state.data_credit_available--;
+      notificationsSent++;
+    }
+    else drop_notification(notification);  // Client closed the pipe while the value was queued
+    
+    notificationQueueHead = (notificationQueueHead + 1) % NOTIFICATION_QUEUE_DEPTH;
+    notificationQueueCount--;
+  }
+}
+
+void drain_bulk_transfer(void)
+{
+  if (bulkTransfer == NULL || !bulkTransfer->active) return;
+  
+  if (!lib_aci_is_pipe_available(&aci_state, bulkTransferPipe))
+  {
+    bulkTransfer->abort();  // Client has unsubscribed
+    return;
+  }
+  
+  // Queued notifications go first, the stream keeps every other credit busy
+  while ((notificationQueueCount == 0) && (aci_state.data_credit_available >= 1))
+  {
+    uint8_t buffer[NOTIFICATION_MAX_SIZE];
+    uint8_t creditsInFlight = aci_state.data_credit_total - aci_state.data_credit_available;
+    uint8_t byteCount = bulkTransfer->fragment(buffer, creditsInFlight, millis());
+    
+    if (byteCount == 0) break;
+    
+    if (!lib_aci_send_data(bulkTransferPipe, buffer, byteCount))
+    {
+      // ACI command queue is full, the same fragment goes on the next pass
+      break;
+    }
+    
+    aci_state.data_credit_available--;
+    bulkTransfer->fragmentSent(buffer, byteCount, millis());
+    
+    if (!bulkTransfer->active) break;  // That was the summary
+  }
+}
+
 void aci_setup(void)
 { 
   
@@ -154,6 +366,8 @@ void aci_loop()
   // We enter the if statement only when there is a ACI event available to be processed
   if (lib_aci_event_get(&aci_state, &aci_data))
   {
+    aci_idle = false;
+    
     aci_evt_t * aci_evt;
     aci_evt = &aci_data.evt;  
     
@@ -165,6 +379,8 @@ void aci_loop()
         case ACI_EVT_DEVICE_STARTED:
         { 
           aci_state.data_credit_total = aci_evt->params.device_started.credit_available;
+          invalidate_pipe_shadows(false);  // Local pipe data does not survive a reset
+          radioDown = false;
           switch(aci_evt->params.device_started.device_mode)
           {
             case ACI_DEVICE_SETUP:
@@ -232,6 +448,7 @@ void aci_loop()
       case ACI_EVT_CONNECTED:
 //        Serial.println(F("Evt Connected"));
         timing_change_done              = false;
+        connected                       = true;
         aci_state.data_credit_available = aci_state.data_credit_total;
         
         /*
@@ -242,6 +459,7 @@ void aci_loop()
         
       case ACI_EVT_PIPE_STATUS:
 //        Serial.println(F("Evt Pipe Status"));
+        invalidate_pipe_shadows(true);  // Newly subscribed client needs current values, not just changes
 //        if (lib_aci_is_pipe_available(&aci_state, PIPE_UART_OVER_BTLE_UART_TX_TX) && (false == timing_change_done))
 //        {
 //          lib_aci_change_timing_GAP_PPCP(); // change the timing on the link as specified in the nRFgo studio -> nRF8001 conf. -> GAP. 
@@ -260,6 +478,8 @@ void aci_loop()
         
       case ACI_EVT_DISCONNECTED:
         Serial.println(F("Evt Disconnected/Advertising timed out"));
+        connected = false;
+        clear_notification_queue();
         lib_aci_connect(ADVERTISING_TIMEOUT/* in seconds  : 0 means forever */, ADVERTISING_INTERVAL /* advertising interval 50ms*/);
 //        Serial.println(F("Advertising started"));        
         break;
@@ -349,6 +569,7 @@ void aci_loop()
     // No event in the ACI Event queue and if there is no event in the ACI command queue the arduino can go to sleep
     // Arduino can go to sleep now
     // Wakeup from sleep from the RDYN line
+    aci_idle = !setup_required;
   }
   
   
@@ -363,6 +584,10 @@ void aci_loop()
       setup_required = false;
     }
   }
+  
+  // Send whatever queued notifications the available data credits allow
+  drain_notification_queue();
+  drain_bulk_transfer();
 }
 
 //void setACIPostEventHandler(ACIPostEventHandler handlerFn) {
@@ -385,88 +610,279 @@ BLE::BLE(ACIPostEventHandler handlerFn) {
  _data_credit_pending = 0;
 }
 
-void BLE::waitForACIResponse() {
+BLEStatus BLE::waitForACIResponse() {
+  
+  PROFILE_BEGIN(ProfilePhaseACIResponse);
   
   _aci_cmd_pending = true;
-  while (_aci_cmd_pending) aci_loop();
+  BLEStatus status = waitUntilCleared(&_aci_cmd_pending, BLETimeoutCommandResponse, ACI_RESPONSE_TIMEOUT);
   
-  // Reset hung-loop detection
-  loopingSinceLastBark = false;
+  PROFILE_END(ProfilePhaseACIResponse);
+  
+  return status;
 }
 
-void BLE::waitForDataCredit() {
+BLEStatus BLE::waitForDataCredit() {
+  
+  PROFILE_BEGIN(ProfilePhaseDataCredit);
   
   _data_credit_pending = true;
-  while (_data_credit_pending) aci_loop();
+  BLEStatus status = waitUntilCleared(&_data_credit_pending, BLETimeoutDataCredit, DATA_CREDIT_TIMEOUT);
+  
+  PROFILE_END(ProfilePhaseDataCredit);
+  
+  return status;
+}
+
+BLEStatus BLE::waitUntilCleared(byte *pending, BLETimeoutClass timeoutClass, unsigned long timeout) {
+  
+  // Whichever comes first, this kind of wait's deadline or the end of the loop's radio budget
+  unsigned long budgetLeft = (radioWaitSpent < RADIO_WAIT_BUDGET) ? RADIO_WAIT_BUDGET - radioWaitSpent : 0;
+  boolean budgetLimited = budgetLeft < timeout;
+  if (budgetLimited) timeout = budgetLeft;
+  
+  unsigned long start = millis();
+  while (*pending && !radioDown && millis() - start < timeout) aci_loop();
+  radioWaitSpent += millis() - start;
+  
+  if (!*pending) {
+    
+    consecutiveTimeouts = 0;
+    return BLEStatusOK;
+  }
+  
+  *pending = false;  // Given up on, a late event clearing it again is harmless
+  if (radioDown) return BLEStatusRadioDown;
+  
+  // NOTE: A wait the budget cut short says nothing about the radio, so only waits that ran
+  //   their full deadline count towards RADIO_REINIT_TIMEOUTS
+  if (budgetLimited) {
+    
+    radioOverBudget++;
+    return BLEStatusTimedOut;
+  }
   
-  // Reset hung-loop detection
-  loopingSinceLastBark = false;
+  radioTimeouts[timeoutClass]++;
+  if (++consecutiveTimeouts >= RADIO_REINIT_TIMEOUTS) request_radio_reinit();
+  
+  return BLEStatusTimedOut;
 }
 
-boolean BLE::writeBufferToPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe) {
+boolean BLE::enqueueBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe) {
+  
+  if (!lib_aci_is_pipe_available(&aci_state, pipe) || byteCount > NOTIFICATION_MAX_SIZE) return false;
   
-  boolean success = false;
+  PendingNotification *notification = NULL;
   
-  if (lib_aci_is_pipe_available(&aci_state, pipe) && (aci_state.data_credit_available >= 1)) {
+  // A newer value supersedes one still waiting for the same pipe
+  for (uint8_t i = 0; i < notificationQueueCount; i++) {
     
-//    Serial.print(byteCount);
-//    Serial.println(F(" bytes sent to pipe"));
+    PendingNotification *queued = &notificationQueue[(notificationQueueHead + i) % NOTIFICATION_QUEUE_DEPTH];
+    if (queued->pipe == pipe) {
+      
+      notification = queued;
+      break;
+    }
+  }
+  
+  if (notification == NULL) {
     
-    success = lib_aci_send_data(pipe, buffer, byteCount);
+    if (notificationQueueCount == NOTIFICATION_QUEUE_DEPTH) {
+      
+      // Full, drop the oldest to make room
+      drop_notification(&notificationQueue[notificationQueueHead]);
+      notificationQueueHead = (notificationQueueHead + 1) % NOTIFICATION_QUEUE_DEPTH;
+      notificationQueueCount--;
+    }
     
-    if (success) {
+    notification = &notificationQueue[(notificationQueueHead + notificationQueueCount) % NOTIFICATION_QUEUE_DEPTH];
+    notificationQueueCount++;
+  }
+  
+  notification->pipe = pipe;
+  notification->byteCount = byteCount;
+  memcpy(notification->buffer, buffer, byteCount);
+  
+  return true;
+}
+
+BLEStatus BLE::flushNotifications(void) {
+  
+  while (notificationQueueCount > 0) {
+    
+    if (aci_state.data_credit_available == 0) {
       
-      aci_state.data_credit_available--;
+      BLEStatus status = waitForDataCredit();
+      if (status != BLEStatusOK) return status;
       
-      waitForDataCredit();
+    } else aci_loop();
+  }
+  
+  return BLEStatusOK;
+}
+
+uint8_t BLE::notificationQueueDepth(void) {
+  
+  return notificationQueueCount;
+}
+
+boolean BLE::notificationPendingForPipe(uint8_t pipe) {
+  
+  for (uint8_t i = 0; i < notificationQueueCount; i++) {
     
-    } else Serial.println(F("lib_aci_send_data() failed"));
+    if (notificationQueue[(notificationQueueHead + i) % NOTIFICATION_QUEUE_DEPTH].pipe == pipe) return true;
+  }
   
-  } //else Serial.println(F("Pipe not available or no remaining data credits"));
-  	
-  return success;
+  return false;
 }
 
+unsigned long BLE::sentNotificationCount(void) {
+  
+  return notificationsSent;
+}
 
-// ------------------------------
+unsigned long BLE::droppedNotificationCount(void) {
+  
+  return notificationsDropped;
+}
+
+void BLE::fillReport(BLEReport *report) {
+  
+  report->notificationsSent = notificationsSent;
+  report->notificationsDropped = notificationsDropped;
+  report->pipeWritesSent = pipeWritesSent;
+  report->pipeWritesSuppressed = pipeWritesSuppressed;
+  report->queueDepth = notificationQueueCount;
+}
+
+
+BLEStatus BLE::setBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe, boolean isFloat) {
+  
+  if (pipe_shadow_matches(pipe, buffer, byteCount, isFloat)) {
+    
+    pipeWritesSuppressed++;
+    return BLEStatusOK;
+  }
+  
+  if (radioDown) return BLEStatusRadioDown;
+  
+  if (radioWaitSpent >= RADIO_WAIT_BUDGET) {
+    
+    radioOverBudget++;
+    return BLEStatusOverBudget;
+  }
+  
+  if (!lib_aci_set_local_data(&aci_state, pipe, buffer, byteCount)) return BLEStatusQueueFull;
+  
+  BLEStatus status = waitForACIResponse();
+  
+  // Only a confirmed value is remembered and counted, anything else is sent again next time
+  if (status == BLEStatusOK) {
+    
+    pipe_shadow_store(pipe, buffer, byteCount);
+    pipeWritesSent++;
+  }
+  
+  return status;
+}
+
+boolean BLE::notifyBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe, boolean isFloat) {
+  
+  if (pipe_shadow_matches(pipe, buffer, byteCount, isFloat)) {
+    
+    pipeWritesSuppressed++;
+    return true;  // Client already has this value
+  }
+  
+  if (enqueueBufferForPipe(buffer, byteCount, pipe)) {
+    
+    pipe_shadow_store(pipe, buffer, byteCount);
+    pipeWritesSent++;
+    return true;
+    
+  } else return false;
+}
 
+void BLE::setBulkTransfer(BulkTransfer *transfer, uint8_t pipe) {
+  
+  bulkTransfer = transfer;
+  bulkTransferPipe = pipe;
+}
 
+boolean BLE::setDeadbandForCharacteristic(uint8_t pipe, float deadband) {
+  
+  for (uint8_t i = 0; i < pipeDeadbandCount; i++) {
+    
+    if (pipeDeadbands[i].pipe == pipe) {
+      
+      pipeDeadbands[i].deadband = deadband;
+      return true;
+    }
+  }
+  
+  if (pipeDeadbandCount == PIPE_DEADBAND_SLOTS) return false;
+  
+  pipeDeadbands[pipeDeadbandCount].pipe = pipe;
+  pipeDeadbands[pipeDeadbandCount].deadband = deadband;
+  pipeDeadbandCount++;
+  
+  return true;
+}
 
-void BLE::setValueForCharacteristic(uint8_t pipe, float value) {
+unsigned long BLE::sentPipeWriteCount(void) {
   
-  lib_aci_set_local_data(&aci_state, pipe, (uint8_t*) &value, sizeof(float));
+  return pipeWritesSent;
+}
+
+unsigned long BLE::suppressedPipeWriteCount(void) {
   
-  waitForACIResponse();
+  return pipeWritesSuppressed;
 }
 
-void BLE::setValueForCharacteristic(uint8_t pipe, uint8_t value) {
+
+// ------------------------------
+
+
+
+BLEStatus BLE::setValueForCharacteristic(uint8_t pipe, float value) {
   
-  lib_aci_set_local_data(&aci_state, pipe, (uint8_t*) &value, sizeof(uint8_t));
+  return setBufferForPipe((uint8_t*) &value, sizeof(float), pipe, true);
+}
+
+BLEStatus BLE::setValueForCharacteristic(uint8_t pipe, uint8_t value) {
   
-  waitForACIResponse();
+  return setBufferForPipe((uint8_t*) &value, sizeof(uint8_t), pipe, false);
 }
 
-void BLE::setValueForCharacteristic(uint8_t pipe, int value) {
+BLEStatus BLE::setValueForCharacteristic(uint8_t pipe, int16_t value) {
   
-  lib_aci_set_local_data(&aci_state, pipe, (uint8_t*) &value, sizeof(int));
+  return setBufferForPipe((uint8_t*) &value, sizeof(int16_t), pipe, false);
+}
+
+BLEStatus BLE::setValueForCharacteristic(uint8_t pipe, uint8_t *buffer, uint8_t byteCount) {
   
-  waitForACIResponse();
+  return setBufferForPipe(buffer, byteCount, pipe, false);
 }
 
 
 boolean BLE::notifyClientOfValueForCharacteristic(uint8_t pipe, float value) {
  
-  return writeBufferToPipe((uint8_t *) &value, sizeof(float), pipe);
+  return notifyBufferForPipe((uint8_t *) &value, sizeof(float), pipe, true);
 }
 
 boolean BLE::notifyClientOfValueForCharacteristic(uint8_t pipe, uint8_t value) {
  
-  return writeBufferToPipe((uint8_t *) &value, sizeof(uint8_t), pipe);
+  return notifyBufferForPipe((uint8_t *) &value, sizeof(uint8_t), pipe, false);
 }
 
-boolean BLE::notifyClientOfValueForCharacteristic(uint8_t pipe, int value) {
+boolean BLE::notifyClientOfValueForCharacteristic(uint8_t pipe, int16_t value) {
   
-  return writeBufferToPipe((uint8_t *) &value, sizeof(int), pipe);
+  return notifyBufferForPipe((uint8_t *) &value, sizeof(int16_t), pipe, false);
+}
+
+boolean BLE::notifyClientOfValueForCharacteristic(uint8_t pipe, uint8_t *buffer, uint8_t byteCount) {
+  
+  return enqueueBufferForPipe(buffer, byteCount, pipe);
 }
 
 void BLE::ble_setup(void) {
@@ -476,5 +892,49 @@ void BLE::ble_setup(void) {
 
 void BLE::ble_loop(void) {
   
+  // A fresh budget for the next pass through loop()
+  radioWaitSpent = 0;
+  
+  if (radioReinitRequested || (radioDown && millis() - radioReinitAt >= RADIO_REINIT_RETRY)) reinit_radio();
+  
   aci_loop();
 }
+
+boolean BLE::readyToSleep(void) {
+  
+  if (!aci_idle || _aci_cmd_pending || _data_credit_pending) return false;
+  if (notificationQueueCount > 0) return false;
+  if (bulkTransfer != NULL && bulkTransfer->active) return false;
+  
+  return true;
+}
+
+unsigned long BLE::timeoutCount(BLETimeoutClass timeoutClass) {
+  
+  return radioTimeouts[timeoutClass];
+}
+
+unsigned long BLE::overBudgetCount(void) {
+  
+  return radioOverBudget;
+}
+
+unsigned long BLE::radioReinitCount(void) {
+  
+  return radioReinits;
+}
+
+boolean BLE::radioIsDown(void) {
+  
+  return radioDown;
+}
+
+boolean BLE::isConnected(void) {
+  
+  return connected;
+}
+
+uint8_t BLE::radioWakePin(void) {
+  
+  return aci_state.aci_pins.rdyn_pin;
+}
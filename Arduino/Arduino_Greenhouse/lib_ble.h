@@ -10,9 +10,53 @@
 
 #include <lib_aci.h>
 #include <aci_setup.h>
+#include "lib_bulkTransfer.h"
 
 typedef void (*ACIPostEventHandler)(aci_state_t *aci_state, aci_evt_t *aci_evt);
 
+#define NOTIFICATION_QUEUE_DEPTH 8  // Pending notifications held while waiting on data credits
+#define NOTIFICATION_MAX_SIZE 20  // bytes, largest payload of a single nRF8001 packet
+
+#define PIPE_SHADOW_SIZE 4  // bytes, largest scalar value remembered per pipe
+#define PIPE_DEADBAND_SLOTS 6  // Number of pipes that can be given a float deadband
+
+#define ACI_RESPONSE_TIMEOUT 100UL  // ms, the nRF8001 answers SetLocalData within a few ms
+#define DATA_CREDIT_TIMEOUT 500UL  // ms, a credit comes back within a connection interval, 152.5ms at most with our GAP settings
+#define RADIO_WAIT_BUDGET 1000UL  // ms of waiting on the radio allowed between two ble_loop() calls
+#define RADIO_REINIT_TIMEOUTS 3  // Consecutive time-outs before the nRF8001 is re-initialised
+#define RADIO_REINIT_RETRY 30000UL  // ms, re-initialise again if it still hasn't restarted
+
+#define BLE_COMMAND_REPORT 1  // Written to the Diagnostics Report after DIAGNOSTICS_REPORT_BLE
+
+enum BLEStatus {
+  
+  BLEStatusOK,
+  BLEStatusTimedOut,  // Deadline passed waiting for the radio, which may still complete it later
+  BLEStatusOverBudget,  // RADIO_WAIT_BUDGET already spent, nothing was sent
+  BLEStatusRadioDown,  // Re-initialising after repeated time-outs, nothing was sent
+  BLEStatusQueueFull  // ACI command queue full, or the value too long for it, nothing was sent
+  
+};
+
+enum BLETimeoutClass {
+  
+  BLETimeoutCommandResponse,
+  BLETimeoutDataCredit,
+  BLETimeoutClassCount
+  
+};
+
+// Notified once after BLE_COMMAND_REPORT, counts since power-up
+typedef struct __attribute__((packed)) {
+  
+  uint32_t notificationsSent;
+  uint32_t notificationsDropped;  // Superseded in a full queue, or for a pipe the client closed
+  uint32_t pipeWritesSent;
+  uint32_t pipeWritesSuppressed;  // Unchanged, or within the deadband
+  uint8_t queueDepth;  // Notifications still waiting, not counting this report
+  
+} BLEReport;
+
 // Class Definition
 class BLE {
   
@@ -21,29 +65,67 @@ class BLE {
     BLE(ACIPostEventHandler handlerFn);
     
     // Set LOCAL pipe value
-    void setValueForCharacteristic(uint8_t pipe, float value);
-    void setValueForCharacteristic(uint8_t pipe, uint8_t value);
-    void setValueForCharacteristic(uint8_t pipe, int value);
+    // NOTE: Skipped when unchanged from the last value set, or within the pipe's deadband for floats.
+    //   A value that wasn't sent isn't remembered as set, so setting it again retries
+    BLEStatus setValueForCharacteristic(uint8_t pipe, float value);
+    BLEStatus setValueForCharacteristic(uint8_t pipe, uint8_t value);
+    BLEStatus setValueForCharacteristic(uint8_t pipe, int16_t value);
+    BLEStatus setValueForCharacteristic(uint8_t pipe, uint8_t *buffer, uint8_t byteCount);
     
     // Transmit value to BLE master
+    // NOTE: Values are queued and sent from ble_loop() as data credits allow, never blocks
+    //   Scalar values are skipped the same way as setValueForCharacteristic()
     boolean notifyClientOfValueForCharacteristic(uint8_t pipe, float value);
     boolean notifyClientOfValueForCharacteristic(uint8_t pipe, uint8_t value);
-    boolean notifyClientOfValueForCharacteristic(uint8_t pipe, int value);
+    boolean notifyClientOfValueForCharacteristic(uint8_t pipe, int16_t value);
+    boolean notifyClientOfValueForCharacteristic(uint8_t pipe, uint8_t *buffer, uint8_t byteCount);
+    
+    // Notification queue
+    BLEStatus flushNotifications(void);  // Blocks until every queued notification has been sent, or a credit times out
+    uint8_t notificationQueueDepth(void);
+    boolean notificationPendingForPipe(uint8_t pipe);  // A second one would supersede it, see enqueueBufferForPipe()
+    unsigned long sentNotificationCount(void);
+    unsigned long droppedNotificationCount(void);
+    void fillReport(BLEReport *report);
+    
+    // Bulk transfer
+    // NOTE: Its fragments are sent from ble_loop() with whatever credits the queue leaves
+    void setBulkTransfer(BulkTransfer *transfer, uint8_t pipe);
+    
+    // Pipe shadow cache
+    boolean setDeadbandForCharacteristic(uint8_t pipe, float deadband);  // Absolute, applies to float values only
+    unsigned long sentPipeWriteCount(void);
+    unsigned long suppressedPipeWriteCount(void);
+    
+    // Radio health
+    unsigned long timeoutCount(BLETimeoutClass timeoutClass);
+    unsigned long overBudgetCount(void);  // Writes skipped, and waits cut short, by RADIO_WAIT_BUDGET
+    unsigned long radioReinitCount(void);
+    boolean radioIsDown(void);
 
     void ble_setup(void);
     void ble_loop(void); 
+    
+    // Sleep
+    // NOTE: Ready once the last ble_loop() found the radio idle with nothing left to send,
+    //   the nRF8001 then pulls radioWakePin() low when it next has an event
+    boolean readyToSleep(void);
+    boolean isConnected(void);
+    uint8_t radioWakePin(void);
  
     byte _aci_cmd_pending;
     byte _data_credit_pending;
     boolean timing_change_done;
-    volatile boolean loopingSinceLastBark;
     
   private:
     
     void processACIEvent(aci_state_t *aci_state, aci_evt_t *aci_evt);
-    void waitForACIResponse();
-    void waitForDataCredit();
-    boolean writeBufferToPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe);
+    BLEStatus waitForACIResponse();
+    BLEStatus waitForDataCredit();
+    BLEStatus waitUntilCleared(byte *pending, BLETimeoutClass timeoutClass, unsigned long timeout);
+    boolean enqueueBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe);
+    BLEStatus setBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe, boolean isFloat);
+    boolean notifyBufferForPipe(uint8_t *buffer, uint8_t byteCount, uint8_t pipe, boolean isFloat);
 };
 
 void setACIPostEventHandler(ACIPostEventHandler handlerFn);
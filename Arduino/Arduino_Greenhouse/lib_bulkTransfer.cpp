@@ -0,0 +1,137 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include <stddef.h>
+#include <string.h>
+#include "lib_configStore.h"
+#include "lib_bulkTransfer.h"
+
+#define CRC_INITIAL 0xFFFF
+
+
+BulkTransfer::BulkTransfer(void) {
+  
+  active = false;
+  transferCount = 0;
+  bytesSent = 0;
+  lastElapsed = 0;
+  lastBytesPerSecond = 0;
+  
+  _streamCount = 0;
+  _index = -1;
+}
+
+boolean BulkTransfer::addStream(uint8_t stream, BulkLengthFn lengthFn, BulkReadFn readFn) {
+  
+  if (_streamCount == BULK_MAX_STREAMS || _streamIndex(stream) >= 0) return false;
+  
+  _streams[_streamCount] = stream;
+  _lengthFns[_streamCount] = lengthFn;
+  _readFns[_streamCount] = readFn;
+  _streamCount++;
+  
+  return true;
+}
+
+void BulkTransfer::start(uint8_t stream, uint16_t fromSequence) {
+  
+  active = true;
+  
+  _stream = stream;
+  _index = _streamIndex(stream);
+  _length = (_index >= 0) ? _lengthFns[_index]() : 0;
+  _offset = (uint32_t) fromSequence * BULK_FRAGMENT_PAYLOAD;
+  if (_offset > _length) _offset = _length;
+  
+  _started = 0;
+  _payloadSent = 0;
+  
+  // The client already has everything before the resume point, but the CRC covers it too
+  _crc = CRC_INITIAL;
+  uint8_t buffer[BULK_FRAGMENT_PAYLOAD];
+  
+  for (uint32_t offset = 0; offset < _offset; offset += BULK_FRAGMENT_PAYLOAD) {
+    
+    uint8_t byteCount = (_offset - offset < BULK_FRAGMENT_PAYLOAD) ? _offset - offset : BULK_FRAGMENT_PAYLOAD;
+    _readFns[_index](offset, buffer, byteCount);
+    
+    for (uint8_t i = 0; i < byteCount; i++) _crc = crc16Update(_crc, buffer[i]);
+  }
+}
+
+void BulkTransfer::abort(void) {
+  
+  active = false;
+}
+
+uint8_t BulkTransfer::fragment(uint8_t *buffer, uint8_t creditsInFlight, unsigned long now) {
+  
+  if (!active) return 0;
+  
+  if (_offset < _length) {
+    
+    BulkFragment *fragment = (BulkFragment *) buffer;
+    uint8_t byteCount = (_length - _offset < BULK_FRAGMENT_PAYLOAD) ? _length - _offset : BULK_FRAGMENT_PAYLOAD;
+    
+    fragment->sequence = _offset / BULK_FRAGMENT_PAYLOAD;
+    _readFns[_index](_offset, fragment->data, byteCount);
+    
+    return offsetof(BulkFragment, data) + byteCount;
+  }
+  
+  // Everything's been handed to the radio, wait for it to go out before timing the stream
+  if (creditsInFlight > 0) return 0;
+  
+  BulkSummary *summary = (BulkSummary *) buffer;
+  summary->sequence = BULK_SEQUENCE_END;
+  summary->stream = _stream;
+  summary->status = (_index >= 0) ? BulkStatusComplete : BulkStatusUnknownStream;
+  summary->length = _length;
+  summary->crc = _crc;
+  summary->elapsed = (_payloadSent > 0) ? now - _started : 0;
+  
+  unsigned long bytesPerSecond = (summary->elapsed > 0) ? (_payloadSent * 1000UL) / summary->elapsed : 0;
+  summary->bytesPerSecond = (bytesPerSecond > 0xFFFF) ? 0xFFFF : bytesPerSecond;
+  
+  return sizeof(BulkSummary);
+}
+
+void BulkTransfer::fragmentSent(const uint8_t *buffer, uint8_t byteCount, unsigned long now) {
+  
+  const BulkSummary *summary = (const BulkSummary *) buffer;
+  
+  if (summary->sequence == BULK_SEQUENCE_END && _offset >= _length) {
+    
+    active = false;
+    transferCount++;
+    lastElapsed = summary->elapsed;
+    lastBytesPerSecond = summary->bytesPerSecond;
+    return;
+  }
+  
+  if (_payloadSent == 0) _started = now;
+  
+  const BulkFragment *fragment = (const BulkFragment *) buffer;
+  uint8_t payload = byteCount - offsetof(BulkFragment, data);
+  
+  for (uint8_t i = 0; i < payload; i++) _crc = crc16Update(_crc, fragment->data[i]);
+  
+  _offset += payload;
+  _payloadSent += payload;
+  bytesSent += payload;
+}
+
+int8_t BulkTransfer::_streamIndex(uint8_t stream) {
+  
+  for (uint8_t i = 0; i < _streamCount; i++) {
+    
+    if (_streams[i] == stream) return i;
+  }
+  
+  return -1;
+}
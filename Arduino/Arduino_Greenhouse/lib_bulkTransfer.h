@@ -0,0 +1,101 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef BulkTransfer_h
+#define BulkTransfer_h
+
+#include "Arduino.h"
+
+#define BULK_MAX_STREAMS 4
+#define BULK_FRAGMENT_PAYLOAD 18  // bytes, a 20-byte packet less the sequence number
+#define BULK_SEQUENCE_END 0xFFFF  // Sequence number of the summary that ends a stream
+
+#define BULK_COMMAND_ABORT 0  // Written to the Bulk Transfer characteristic
+#define BULK_COMMAND_START 1  // Followed by the uint8 stream and, to resume, the uint16 sequence number to start at
+
+// TYPES
+// -------------------------------------------------
+typedef uint32_t (*BulkLengthFn)(void);
+typedef void (*BulkReadFn)(uint32_t offset, uint8_t *buffer, uint8_t byteCount);
+
+enum BulkStatus {
+  
+  BulkStatusComplete,
+  BulkStatusUnknownStream
+  
+};
+
+// Notified over the Bulk Transfer characteristic
+// NOTE: Multi-byte fields are little-endian, as laid out by the AVR
+typedef struct __attribute__((packed)) {
+  
+  uint16_t sequence;  // Fragment n carries the stream's bytes from n * BULK_FRAGMENT_PAYLOAD
+  uint8_t data[BULK_FRAGMENT_PAYLOAD];  // The last fragment is short
+  
+} BulkFragment;
+
+// Sent with sequence number BULK_SEQUENCE_END once every fragment's credit has come back
+typedef struct __attribute__((packed)) {
+  
+  uint16_t sequence;  // BULK_SEQUENCE_END
+  uint8_t stream;
+  uint8_t status;  // BulkStatus
+  uint32_t length;  // bytes in the whole stream
+  uint16_t crc;  // CRC-16 of the whole stream, including any part skipped by resuming
+  uint32_t elapsed;  // ms from the first fragment sent to the last one acknowledged
+  uint16_t bytesPerSecond;  // Payload sent this time over elapsed
+  
+} BulkSummary;
+
+
+// Class Definition
+// -------------------------------------------------
+// Streams a registered byte source as numbered fragments, as fast as data credits come back.
+//   The BLE layer pulls fragments from aci_loop() whenever the notification queue is empty
+//   and a credit is free, so a stream keeps every credit in flight instead of one.
+// NOTE: A client that loses fragments, e.g. to a disconnect, restarts the stream at the
+//   first sequence number it's missing.  The CRC still covers the whole stream.
+class BulkTransfer {
+  
+  public:
+    BulkTransfer(void);
+    
+    boolean addStream(uint8_t stream, BulkLengthFn lengthFn, BulkReadFn readFn);
+    
+    void start(uint8_t stream, uint16_t fromSequence);
+    void abort(void);
+    
+    // Called by the BLE layer
+    uint8_t fragment(uint8_t *buffer, uint8_t creditsInFlight, unsigned long now);  // Returns byte count, 0 if nothing is ready
+    void fragmentSent(const uint8_t *buffer, uint8_t byteCount, unsigned long now);
+    
+    boolean active;
+    
+    unsigned int transferCount;  // Streams completed
+    unsigned long bytesSent;  // Payload, every stream
+    unsigned long lastElapsed;  // ms
+    uint16_t lastBytesPerSecond;
+  
+  private:
+    int8_t _streamIndex(uint8_t stream);
+    
+    uint8_t _streams[BULK_MAX_STREAMS];
+    BulkLengthFn _lengthFns[BULK_MAX_STREAMS];
+    BulkReadFn _readFns[BULK_MAX_STREAMS];
+    uint8_t _streamCount;
+    
+    // Current stream
+    uint8_t _stream;
+    int8_t _index;
+    uint32_t _length;
+    uint32_t _offset;
+    uint16_t _crc;
+    unsigned long _started;  // ms, first fragment sent
+    unsigned long _payloadSent;
+};
+
+#endif
@@ -0,0 +1,207 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_configStore.h"
+#include "lib_eepromGuard.h"
+#include "lib_hal.h"
+
+#define CRC_INITIAL 0xFFFF
+
+
+ConfigStore::ConfigStore(uint16_t startAddress, uint16_t length, uint8_t schemaVersion, uint8_t payloadSize) {
+  
+  _startAddress = startAddress;
+  _schemaVersion = schemaVersion;
+  _payloadSize = payloadSize;
+  _slotSize = CONFIG_RECORD_SIZE(payloadSize);
+  
+  slotCount = length / _slotSize;
+  lastBytesWritten = 0;
+  totalBytesWritten = 0;
+  persistCount = 0;
+  
+  dirty = false;
+  pendingChanges = 0;
+  committedChanges = 0;
+  _committing = false;
+  
+  _hasRecord = false;
+  _currentSlot = 0;
+  _sequence = 0;
+}
+
+boolean ConfigStore::restore(void *payload) {
+  
+  _hasRecord = false;
+  
+  for (uint8_t slot = 0; slot < slotCount; slot++) {
+    
+    ConfigRecordHeader header;
+    if (!_slotIsValid(slot, &header)) continue;
+    
+    // NOTE: Sequence numbers wrap, newer is a positive difference
+    if (!_hasRecord || (int16_t)(header.sequence - _sequence) > 0) {
+      
+      _hasRecord = true;
+      _currentSlot = slot;
+      _sequence = header.sequence;
+    }
+  }
+  
+  if (!_hasRecord) return false;
+  
+  uint16_t address = _slotAddress(_currentSlot) + sizeof(ConfigRecordHeader);
+  uint8_t *bytes = (uint8_t *) payload;
+  for (uint8_t i = 0; i < _payloadSize; i++) bytes[i] = eepromRead(address + i);
+  
+  return true;
+}
+
+void ConfigStore::persist(const void *payload) {
+  
+  const uint8_t *bytes = (const uint8_t *) payload;
+  lastBytesWritten = 0;
+  
+  if (_hasRecord && _payloadMatches(_currentSlot, bytes)) return;  // Nothing changed
+  
+  uint8_t slot = _hasRecord ? (_currentSlot + 1) % slotCount : 0;
+  
+  ConfigRecordHeader header;
+  header.sequence = _hasRecord ? _sequence + 1 : 0;
+  header.schemaVersion = _schemaVersion;
+  header.length = _payloadSize;
+  
+  // Header first, so an interrupted record can't pass as the stale one it's replacing
+  uint16_t address = _slotAddress(slot);
+  uint16_t crc = CRC_INITIAL;
+  
+  const uint8_t *headerBytes = (const uint8_t *) &header;
+  for (uint8_t i = 0; i < sizeof(ConfigRecordHeader); i++) {
+    
+    _writeByte(address++, headerBytes[i]);
+    crc = crc16Update(crc, headerBytes[i]);
+  }
+  
+  for (uint8_t i = 0; i < _payloadSize; i++) {
+    
+    _writeByte(address++, bytes[i]);
+    crc = crc16Update(crc, bytes[i]);
+  }
+  
+  _writeByte(address++, crc & 0xFF);
+  _writeByte(address, crc >> 8);
+  
+  _hasRecord = true;
+  _currentSlot = slot;
+  _sequence = header.sequence;
+  
+  totalBytesWritten += lastBytesWritten;
+  persistCount++;
+}
+
+void ConfigStore::markDirty(unsigned long now) {
+  
+  dirty = true;
+  pendingChanges++;
+  _lastChange = now;  // Every edit restarts the quiet period
+}
+
+boolean ConfigStore::commitIfQuiet(const void *payload, unsigned long now, unsigned long quietPeriod) {
+  
+  if (!dirty || (now - _lastChange) < quietPeriod) return false;
+  
+  commit(payload);
+  return true;
+}
+
+void ConfigStore::commit(const void *payload) {
+  
+  // NOTE: The watchdog interrupt can commit too, it mustn't start a record over one half-written.
+  //   Checked and claimed with interrupts off, so it can't slip in between and write the same payload twice
+  uint8_t interruptState = hal_disableInterrupts();
+  boolean claimed = dirty && !_committing;
+  if (claimed) _committing = true;
+  hal_restoreInterrupts(interruptState);
+  
+  if (!claimed) return;
+  
+  dirty = false;
+  committedChanges += pendingChanges;
+  pendingChanges = 0;
+  
+  persist(payload);
+  
+  _committing = false;
+}
+
+void ConfigStore::fillReport(ConfigReport *report) {
+  
+  report->pendingChanges = pendingChanges;
+  report->committedChanges = committedChanges;
+  report->persistCount = persistCount;
+  report->totalBytesWritten = totalBytesWritten;
+  report->slotCount = slotCount;
+}
+
+uint16_t ConfigStore::_slotAddress(uint8_t slot) {
+  
+  return _startAddress + (uint16_t) slot * _slotSize;
+}
+
+boolean ConfigStore::_slotIsValid(uint8_t slot, ConfigRecordHeader *header) {
+  
+  uint16_t address = _slotAddress(slot);
+  uint16_t crc = CRC_INITIAL;
+  
+  uint8_t *headerBytes = (uint8_t *) header;
+  for (uint8_t i = 0; i < sizeof(ConfigRecordHeader); i++) {
+    
+    headerBytes[i] = eepromRead(address++);
+    crc = crc16Update(crc, headerBytes[i]);
+  }
+  
+  // A record from another layout can't be trusted even with a good CRC
+  if (header->schemaVersion != _schemaVersion || header->length != _payloadSize) return false;
+  
+  for (uint8_t i = 0; i < _payloadSize; i++) crc = crc16Update(crc, eepromRead(address++));
+  
+  uint16_t storedCRC = eepromRead(address) | ((uint16_t) eepromRead(address + 1) << 8);
+  return (crc == storedCRC);
+}
+
+boolean ConfigStore::_payloadMatches(uint8_t slot, const uint8_t *payload) {
+  
+  uint16_t address = _slotAddress(slot) + sizeof(ConfigRecordHeader);
+  
+  for (uint8_t i = 0; i < _payloadSize; i++) {
+    
+    if (eepromRead(address + i) != payload[i]) return false;
+  }
+  
+  return true;
+}
+
+void ConfigStore::_writeByte(uint16_t address, uint8_t value) {
+  
+  // Update-if-different, an EEPROM write is ~3.3ms and one of the cell's ~100,000 erase cycles
+  if (eepromRead(address) == value) return;
+  
+  eepromWrite(address, value);
+  lastBytesWritten++;
+}
+
+
+// CRC
+// ----------------------------------------------------
+uint16_t crc16Update(uint16_t crc, uint8_t data) {
+  
+  data ^= crc & 0xFF;
+  data ^= data << 4;
+  
+  return ((((uint16_t) data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t) data << 3));
+}
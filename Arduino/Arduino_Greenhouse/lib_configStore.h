@@ -0,0 +1,91 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef ConfigStore_h
+#define ConfigStore_h
+
+#include "Arduino.h"
+
+#define CONFIG_COMMAND_REPORT 1  // Written to the Diagnostics Report after DIAGNOSTICS_REPORT_CONFIG
+
+// TYPES
+// -------------------------------------------------
+// Every slot holds one record: this header, the payload, then a CRC-16 of both
+typedef struct __attribute__((packed)) {
+  
+  uint16_t sequence;  // Increments with every record written, the highest valid one is current
+  uint8_t schemaVersion;
+  uint8_t length;  // Payload bytes
+  
+} ConfigRecordHeader;
+
+#define CONFIG_RECORD_SIZE(payloadSize) (sizeof(ConfigRecordHeader) + (payloadSize) + sizeof(uint16_t))  // bytes, one slot
+
+// Notified once after CONFIG_COMMAND_REPORT, counts since power-up
+typedef struct __attribute__((packed)) {
+  
+  uint16_t pendingChanges;  // Edits waiting out the quiet period
+  uint32_t committedChanges;  // Edits written out...
+  uint16_t persistCount;  // ...in this many records
+  uint32_t totalBytesWritten;  // EEPROM cells, unchanged bytes cost nothing
+  uint8_t slotCount;
+  
+} ConfigReport;
+
+
+// Class Definition
+// -------------------------------------------------
+// Log-structured store for a fixed-size configuration struct.  Each persist() writes the
+//   next slot round the region, so wear is spread over every slot, and only the bytes that
+//   differ from the stale record already in that slot are written.
+// NOTE: A record interrupted by a reset fails its CRC, and restore() falls back to the one before it
+class ConfigStore {
+  
+  public:
+    ConfigStore(uint16_t startAddress, uint16_t length, uint8_t schemaVersion, uint8_t payloadSize);
+    
+    boolean restore(void *payload);  // Loads the newest valid record, false if there is none
+    void persist(const void *payload);
+    
+    // Deferred commits, so a burst of edits shares one record
+    void markDirty(unsigned long now);
+    boolean commitIfQuiet(const void *payload, unsigned long now, unsigned long quietPeriod);  // Returns true if it committed
+    void commit(const void *payload);  // Immediately, if anything is pending
+    
+    void fillReport(ConfigReport *report);
+    
+    volatile boolean dirty;  // Read from the watchdog interrupt
+    unsigned int pendingChanges;  // Edits since the last commit
+    unsigned long committedChanges;  // Edits written out, across persistCount records
+    
+    uint8_t slotCount;
+    uint16_t lastBytesWritten;  // EEPROM cells written by the last persist(), unchanged bytes cost nothing
+    unsigned long totalBytesWritten;
+    unsigned int persistCount;  // Records written, identical payloads are skipped
+    
+  private:
+    uint16_t _slotAddress(uint8_t slot);
+    boolean _slotIsValid(uint8_t slot, ConfigRecordHeader *header);
+    boolean _payloadMatches(uint8_t slot, const uint8_t *payload);
+    void _writeByte(uint16_t address, uint8_t value);
+    
+    uint16_t _startAddress;
+    uint8_t _schemaVersion;
+    uint8_t _payloadSize;
+    uint16_t _slotSize;
+    
+    unsigned long _lastChange;  // ms
+    volatile boolean _committing;
+    
+    boolean _hasRecord;
+    uint8_t _currentSlot;
+    uint16_t _sequence;
+};
+
+uint16_t crc16Update(uint16_t crc, uint8_t data);  // CRC-16/CCITT, reflected, as avr-libc's _crc_ccitt_update()
+
+#endif
@@ -0,0 +1,39 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include <EEPROM.h>
+#include "lib_eepromGuard.h"
+
+static volatile boolean busy = false;
+
+uint8_t eepromRead(uint16_t address) {
+  
+  // Restored rather than cleared, so a handler's own access leaves the flag as it found it
+  boolean wasBusy = busy;
+  busy = true;
+  
+  uint8_t value = EEPROM.read(address);
+  
+  busy = wasBusy;
+  return value;
+}
+
+void eepromWrite(uint16_t address, uint8_t value) {
+  
+  boolean wasBusy = busy;
+  busy = true;
+  
+  EEPROM.write(address, value);
+  
+  busy = wasBusy;
+}
+
+boolean eepromBusy(void) {
+  
+  return busy;
+}
@@ -0,0 +1,24 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef EepromGuard_h
+#define EepromGuard_h
+
+#include "Arduino.h"
+
+// EEPROM Guard
+// -------------------------------------------------
+// Byte access to the EEPROM that an interrupt handler can see is under way.  Each access is
+//   an address load then a strobe, and a handler that used the EEPROM in between would leave
+//   the main loop's read or write aimed at its own address.  Every access goes through these,
+//   and a handler that finds eepromBusy() leaves the EEPROM alone.
+// NOTE: The watchdog's last-gasp configuration commit is the only handler that touches it
+uint8_t eepromRead(uint16_t address);
+void eepromWrite(uint16_t address, uint8_t value);
+boolean eepromBusy(void);
+
+#endif
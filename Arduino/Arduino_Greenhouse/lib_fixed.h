@@ -0,0 +1,127 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Fixed_h
+#define Fixed_h
+
+#include "Arduino.h"
+
+#define FIXED_FRACTION_BITS 16  // Q15.16, ±32767 in steps of 1/65536
+#define FIXED_ONE 65536L
+#define FIXED_RAW_MAX 2147483647L
+#define FIXED_RAW_MIN (-FIXED_RAW_MAX - 1)
+
+
+// Class Definition
+// -------------------------------------------------
+// Signed Q15.16 fixed-point number, for the control path on an MCU without an FPU.
+// NOTE: Sums and products saturate at the ends of the range instead of wrapping, so an
+//   out-of-range venting necessity still drives the vent flap the right way.
+// NOTE: Multiplying is done as four 16x16 partial products so avr-gcc never calls its
+//   64-bit multiply, and the host build gives bit-identical results.
+class Fixed {
+  
+  public:
+    Fixed(void) { raw = 0; }
+    Fixed(float value) { raw = (int32_t)(value * FIXED_ONE + ((value < 0) ? -0.5f : 0.5f)); }  // Slow, for constants and configuration
+    
+    static Fixed fromRaw(int32_t rawValue) { Fixed value; value.raw = rawValue; return value; }
+    
+    float toFloat(void) const { return (float) raw / FIXED_ONE; }
+    int16_t toInt(void) const { return (int16_t)((raw < 0) ? -(-raw >> FIXED_FRACTION_BITS) : (raw >> FIXED_FRACTION_BITS)); }  // Truncates, like a float cast
+    
+    Fixed operator-(void) const { return fromRaw((raw == FIXED_RAW_MIN) ? FIXED_RAW_MAX : -raw); }
+    Fixed &operator+=(Fixed other);
+    Fixed &operator-=(Fixed other);
+    
+    int32_t raw;
+};
+
+Fixed operator+(Fixed a, Fixed b);
+Fixed operator-(Fixed a, Fixed b);
+Fixed operator*(Fixed a, Fixed b);
+
+inline bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+inline bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+inline bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+inline bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+inline bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+
+// Class Implementation
+// -------------------------------------------------
+inline int32_t _fixedSaturate(boolean negative) {
+  
+  return negative ? FIXED_RAW_MIN : FIXED_RAW_MAX;
+}
+
+inline Fixed operator+(Fixed a, Fixed b) {
+  
+  int32_t sum;
+  if (__builtin_add_overflow(a.raw, b.raw, &sum)) sum = _fixedSaturate(a.raw < 0);
+  
+  return Fixed::fromRaw(sum);
+}
+
+inline Fixed operator-(Fixed a, Fixed b) {
+  
+  int32_t difference;
+  if (__builtin_sub_overflow(a.raw, b.raw, &difference)) difference = _fixedSaturate(a.raw < 0);
+  
+  return Fixed::fromRaw(difference);
+}
+
+inline Fixed operator*(Fixed a, Fixed b) {
+  
+  boolean negative = (a.raw ^ b.raw) < 0;
+  
+  // a = aHigh·2¹⁶ + aLow, with the sign carried in the high half
+  int16_t aHigh = (int16_t)(a.raw >> 16), bHigh = (int16_t)(b.raw >> 16);
+  uint16_t aLow = (uint16_t) a.raw, bLow = (uint16_t) b.raw;
+  
+  int32_t high = (int32_t) aHigh * bHigh;
+  if (high > 32767L || high < -32768L) return Fixed::fromRaw(_fixedSaturate(negative));
+  
+  // (a·b) >> 16, each partial product already at the result's scale
+  int32_t product = high * FIXED_ONE;
+  int32_t crossA = (int32_t) aHigh * (int32_t) bLow;
+  int32_t crossB = (int32_t) bHigh * (int32_t) aLow;
+  int32_t low = (int32_t)(((uint32_t) aLow * bLow) >> 16);
+  
+  if (__builtin_add_overflow(product, crossA, &product) ||
+      __builtin_add_overflow(product, crossB, &product) ||
+      __builtin_add_overflow(product, low, &product)) return Fixed::fromRaw(_fixedSaturate(negative));
+  
+  return Fixed::fromRaw(product);
+}
+
+inline Fixed &Fixed::operator+=(Fixed other) { *this = *this + other; return *this; }
+inline Fixed &Fixed::operator-=(Fixed other) { *this = *this - other; return *this; }
+
+
+// Control Path Number Format
+// -------------------------------------------------
+// Everything from the sensors' converted readings to the vent flap angle uses control_t.
+//   Building with GREENHOUSE_FIXED_POINT switches it to Fixed, otherwise the float
+//   arithmetic remains the reference implementation.
+// NOTE: The Arduino IDE has no per-sketch build flags, uncomment this to select it there
+//#define GREENHOUSE_FIXED_POINT
+
+#ifdef GREENHOUSE_FIXED_POINT
+typedef Fixed control_t;
+#else
+typedef double control_t;
+#endif
+
+// Leaving the control path, e.g. for BLE characteristics and telemetry
+inline float toFloat(double value) { return (float) value; }
+inline float toFloat(Fixed value) { return value.toFloat(); }
+inline int16_t toInt(double value) { return (int16_t) value; }
+inline int16_t toInt(Fixed value) { return value.toInt(); }
+
+#endif
@@ -0,0 +1,133 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_fixedPID.h"
+#include "lib_hal.h"
+
+FixedPID::FixedPID(Fixed *input, Fixed *output, Fixed *setpoint, double Kp, double Ki, double Kd, int controllerDirection) {
+  
+  _input = input;
+  _output = output;
+  _setpoint = setpoint;
+  _inAuto = false;
+  
+  SetOutputLimits(0, 255);  // PID_v1's default, the PWM range
+  
+  _sampleTime = 100;  // ms
+  
+  _controllerDirection = controllerDirection;
+  SetTunings(Kp, Ki, Kd);
+  
+  _lastTime = hal_millis64() - _sampleTime;
+}
+
+bool FixedPID::Compute(void) {
+  
+  if (!_inAuto) return false;
+  
+  uint64_t now = hal_millis64();
+  if (now - _lastTime < _sampleTime) return false;
+  
+  Fixed input = *_input;
+  Fixed error = *_setpoint - input;
+  
+  _iTerm = _clamp(_iTerm + _ki * error);
+  
+  // Derivative on measurement, no kick when the setpoint moves
+  Fixed dInput = input - _lastInput;
+  
+  *_output = _clamp(_kp * error + _iTerm - _kd * dInput);
+  
+  _lastInput = input;
+  _lastTime = now;
+  
+  return true;
+}
+
+void FixedPID::SetTunings(double Kp, double Ki, double Kd) {
+  
+  if (Kp < 0 || Ki < 0 || Kd < 0) return;
+  
+  _dispKp = Kp;
+  _dispKi = Ki;
+  _dispKd = Kd;
+  
+  _scaleTunings();
+}
+
+void FixedPID::SetSampleTime(int newSampleTime) {
+  
+  if (newSampleTime > 0) {
+    
+    _sampleTime = (unsigned long) newSampleTime;
+    _scaleTunings();  // NOTE: From the entered gains, rescaling the Fixed ones would compound rounding
+  }
+}
+
+void FixedPID::SetOutputLimits(double min, double max) {
+  
+  if (min >= max) return;
+  
+  _outMin = Fixed((float) min);
+  _outMax = Fixed((float) max);
+  
+  if (_inAuto) {
+    
+    *_output = _clamp(*_output);
+    _iTerm = _clamp(_iTerm);
+  }
+}
+
+void FixedPID::SetMode(int mode) {
+  
+  boolean newAuto = (mode == AUTOMATIC);
+  
+  if (newAuto && !_inAuto) {
+    
+    // Bumpless transfer from manual
+    _iTerm = _clamp(*_output);
+    _lastInput = *_input;
+  }
+  
+  _inAuto = newAuto;
+}
+
+void FixedPID::SetControllerDirection(int direction) {
+  
+  _controllerDirection = direction;
+  _scaleTunings();
+}
+
+double FixedPID::GetKp(void) { return _dispKp; }
+double FixedPID::GetKi(void) { return _dispKi; }
+double FixedPID::GetKd(void) { return _dispKd; }
+int FixedPID::GetMode(void) { return _inAuto ? AUTOMATIC : MANUAL; }
+int FixedPID::GetDirection(void) { return _controllerDirection; }
+
+void FixedPID::_scaleTunings(void) {
+  
+  float sampleTimeInSec = (float) _sampleTime / 1000.0f;
+  
+  _kp = Fixed((float) _dispKp);
+  _ki = Fixed((float) (_dispKi * sampleTimeInSec));
+  _kd = Fixed((float) (_dispKd / sampleTimeInSec));
+  
+  if (_controllerDirection == REVERSE) {
+    
+    _kp = -_kp;
+    _ki = -_ki;
+    _kd = -_kd;
+  }
+}
+
+Fixed FixedPID::_clamp(Fixed value) {
+  
+  if (value > _outMax) return _outMax;
+  else if (value < _outMin) return _outMin;
+  else return value;
+}
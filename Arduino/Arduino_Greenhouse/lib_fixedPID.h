@@ -0,0 +1,67 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef FixedPID_h
+#define FixedPID_h
+
+#include <PID_v1.h>
+#include "lib_fixed.h"
+
+
+// Class Definition
+// -------------------------------------------------
+// PID_v1's controller with its interface unchanged, computing in Fixed.  Gains are still
+//   given as floats, and scaled by the sample time when they're set, so Compute() is
+//   just three multiplies and some saturating sums.
+class FixedPID {
+  
+  public:
+    FixedPID(Fixed *input, Fixed *output, Fixed *setpoint, double Kp, double Ki, double Kd, int controllerDirection);
+    
+    void SetMode(int mode);
+    bool Compute(void);
+    void SetOutputLimits(double min, double max);
+    
+    void SetTunings(double Kp, double Ki, double Kd);
+    void SetControllerDirection(int direction);
+    void SetSampleTime(int newSampleTime);  // ms
+    
+    double GetKp(void);
+    double GetKi(void);
+    double GetKd(void);
+    int GetMode(void);
+    int GetDirection(void);
+  
+  private:
+    void _scaleTunings(void);
+    Fixed _clamp(Fixed value);
+    
+    double _dispKp, _dispKi, _dispKd;  // As entered
+    Fixed _kp, _ki, _kd;  // Scaled by the sample time and direction
+    
+    int _controllerDirection;
+    
+    Fixed *_input;
+    Fixed *_output;
+    Fixed *_setpoint;
+    
+    uint64_t _lastTime;  // ms, hal_millis64()
+    Fixed _iTerm, _lastInput;
+    
+    unsigned long _sampleTime;
+    Fixed _outMin, _outMax;
+    boolean _inAuto;
+};
+
+// The vent flap's controller, in the control path's number format
+#ifdef GREENHOUSE_FIXED_POINT
+typedef FixedPID ControlPID;
+#else
+typedef PID ControlPID;
+#endif
+
+#endif
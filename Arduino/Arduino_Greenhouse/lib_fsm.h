@@ -8,38 +8,106 @@
 #ifndef FiniteStateMachine_h
 #define FiniteStateMachine_h
 
-typedef void (* FSM_HandlerFn) (uint8_t fromState, uint8_t toState);
+#include "Arduino.h"
+#include <avr/pgmspace.h>
+
+#define FSM_ALLOW(state) (1 << (state))  // Builds a row of the transition bitmap
+
+// Default hooks, for a machine that only needs its state and counters
+struct FSMNoHooks {
+  
+  static void enter(uint8_t state, uint8_t fromState) { }
+  static void leave(uint8_t state, uint8_t toState) { }
+};
+
 
 // Class Definition
+// -------------------------------------------------
+// A state machine over an enum of up to eight states.  Which transitions are allowed is a
+//   bitmap in flash, one byte per from-state with a bit per to-state, so checking one is a
+//   single PROGMEM read.  Hooks supplies static enter() and leave() functions, called with
+//   the state being entered or left, which the compiler resolves and can inline.
+// NOTE: Nothing is allocated, the machine is a few bytes of state and its counters.
+template <typename State, uint8_t StateCount, typename Hooks = FSMNoHooks>
 class FiniteStateMachine {
   
+  static_assert(StateCount <= 8, "Transition bitmap rows are one byte");
+  
   public:
-    FiniteStateMachine(uint8_t stateCount, FSM_HandlerFn stateWillChangeHandler, FSM_HandlerFn stateDidChangeHandler);
-//    ~FiniteStateMachine();
-    void initialize();
-    int getCurrentState();
-    void setCanTransition(uint8_t fromState, uint8_t toState, boolean canTransition);
-    boolean canTransitionToState(uint8_t toState);
-    boolean transitionToState(uint8_t toState);
-//    void setWillLeaveHandler(int state, FSM_HandlerFn handlerFn);
-//    void setDidLeaveHandler(int state, FSM_HandlerFn handlerFn);
-//    void setWillEnterHandler(int state, FSM_HandlerFn handlerFn);
-//    void setDidEnterHandler(int state, FSM_HandlerFn handlerFn);
+    FiniteStateMachine(State initialState, const uint8_t *transitions);  // transitions in PROGMEM, StateCount rows
     
+    void begin(void);  // Enters the initial state
     
+    State currentState(void);
+    boolean canTransitionToState(State toState);
+    boolean transitionToState(State toState);  // false if not allowed, staying put always is
     
+    // Diagnostics
+    uint16_t entryCounts[StateCount];
+    unsigned long transitionCount;
+    unsigned long rejectedCount;
+  
   private:
-    uint8_t _stateCount;
+    const uint8_t *_transitions;
     uint8_t _currentState;
-    boolean **_transitionMap;
-    
-    FSM_HandlerFn _stateWillChangeHandler;
-    FSM_HandlerFn _stateDidChangeHandler;
-    
-//    FSM_HandlerFn *_willLeaveHandlers;
-//    FSM_HandlerFn *_didLeaveHandlers;
-//    FSM_HandlerFn *_willEnterHandlers;
-//    FSM_HandlerFn *_didEnterHandlers;
 };
 
+
+// Class Implementation
+// -------------------------------------------------
+template <typename State, uint8_t StateCount, typename Hooks>
+FiniteStateMachine<State, StateCount, Hooks>::FiniteStateMachine(State initialState, const uint8_t *transitions) {
+  
+  _transitions = transitions;
+  _currentState = initialState;
+  
+  for (uint8_t i = 0; i < StateCount; i++) entryCounts[i] = 0;
+  transitionCount = 0;
+  rejectedCount = 0;
+}
+
+template <typename State, uint8_t StateCount, typename Hooks>
+void FiniteStateMachine<State, StateCount, Hooks>::begin(void) {
+  
+  entryCounts[_currentState]++;
+  Hooks::enter(_currentState, _currentState);
+}
+
+template <typename State, uint8_t StateCount, typename Hooks>
+State FiniteStateMachine<State, StateCount, Hooks>::currentState(void) {
+  
+  return (State) _currentState;
+}
+
+template <typename State, uint8_t StateCount, typename Hooks>
+boolean FiniteStateMachine<State, StateCount, Hooks>::canTransitionToState(State toState) {
+  
+  if ((uint8_t) toState >= StateCount) return false;
+  
+  return (pgm_read_byte(&_transitions[_currentState]) & FSM_ALLOW(toState)) != 0;
+}
+
+template <typename State, uint8_t StateCount, typename Hooks>
+boolean FiniteStateMachine<State, StateCount, Hooks>::transitionToState(State toState) {
+  
+  if ((uint8_t) toState == _currentState) return true;
+  
+  if (!canTransitionToState(toState)) {
+    
+    rejectedCount++;
+    return false;
+  }
+  
+  uint8_t fromState = _currentState;
+  Hooks::leave(fromState, toState);
+  
+  _currentState = toState;
+  entryCounts[_currentState]++;
+  transitionCount++;
+  
+  Hooks::enter(_currentState, fromState);
+  
+  return true;
+}
+
 #endif
@@ -0,0 +1,82 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef HAL_h
+#define HAL_h
+
+// Hardware Abstraction Layer
+// -------------------------------------------------
+// Everything else goes through the Arduino core API (millis(), EEPROM, Servo,
+//   SPI, lib_aci), which the host build in Arduino/host/ provides fakes for.  These are
+//   the few remaining hardware touches that have no core equivalent.
+//
+//   AVR backend: lib_hal_avr.cpp
+//   Linux backend: Arduino/host/src/hal_linux.cpp
+
+// Watchdog
+// NOTE: Interrupt-then-reset mode.  A loop that stops feeding it for ~4s gets the handler
+//   run from the watchdog interrupt, then a reset ~4s later unless it starts feeding again.
+typedef void (*WatchdogHandler)(void);
+
+void hal_startWatchdogTimer(WatchdogHandler beforeReset);
+void hal_feedWatchdog(void);
+
+// Monotonic clock
+// NOTE: millis() extended to 64 bits, so it never wraps (the 32-bit count does every ~49.7 days).
+//   Wraps are counted as they're seen, so it must be read at least once per wrap, which the
+//   scheduler does every loop().  Safe to call from an interrupt handler.
+uint64_t hal_millis64(void);
+
+// Interrupts
+// NOTE: Returns the state to hand back to hal_restoreInterrupts(), which puts it back rather than
+//   enabling them, so a critical section can be entered from a handler or from another one
+uint8_t hal_disableInterrupts(void);
+void hal_restoreInterrupts(uint8_t state);
+
+// Sleep
+// NOTE: Wakes early when wakePin goes low, for the nRF8001's RDYN line, which must be on
+//   port B (pins 8-13) for its pin change interrupt.  Idle keeps Timer0 and the servo pulses
+//   running.  Power-down stops both and wakes on the watchdog, so millis() is advanced by the
+//   time slept afterwards: the whole watchdog period, or half of it for an early wake, when
+//   no clock was running to say.  maxMillis is rounded down to a watchdog period, 16ms to 2s.
+enum HalSleepMode {
+  
+  HalSleepIdle,
+  HalSleepPowerDown
+  
+};
+
+unsigned long hal_sleep(HalSleepMode mode, unsigned long maxMillis, uint8_t wakePin, boolean *wokeByPin);  // Returns ms slept
+
+// Supply voltage, measured against the internal 1.1V bandgap
+// NOTE: Falls well before the brown-out detector trips, so there's time to save state
+uint16_t hal_supplyMillivolts(void);
+
+// Two-wire interface (I2C) master
+// NOTE: Interrupt driven, hal_twiStart() returns at once and the handler is called from the
+//   interrupt when the transfer ends.  It may start the next one.  writeLength bytes of data are
+//   sent, then after a repeated start readLength bytes read back over them.  With neither, only
+//   the address is sent, which is all an HIH6100 measurement request is.
+enum HalTwiResult {
+  
+  HalTwiOK,
+  HalTwiAddressNack,  // Nothing answered the address
+  HalTwiDataNack,
+  HalTwiBusError  // Arbitration lost, or an illegal start or stop on the lines
+  
+};
+
+typedef void (*TwiDoneHandler)(HalTwiResult result, uint8_t byteCount);
+
+void hal_twiBegin(uint32_t frequency, TwiDoneHandler done);  // Hz
+void hal_twiStart(uint8_t address, uint8_t *data, uint8_t writeLength, uint8_t readLength);
+void hal_twiReset(void);  // Abandons the transfer in progress, without calling the handler
+
+// 8-bit shift register (SDA line switches for the HIH6100 sensors)
+void hal_shiftRegisterWrite(uint8_t latchPin, uint8_t dataPin, uint8_t clockPin, uint8_t value);
+
+#endif
@@ -0,0 +1,349 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#if defined(__AVR__)
+
+#include "Arduino.h"
+#include <avr/wdt.h>
+#include <avr/sleep.h>
+#include <util/twi.h>
+#include "lib_hal.h"
+
+// WATCHDOG
+// ----------------------------------------------------
+
+// Enable the Watchdog timer and configure timer duration
+#define BANDGAP_MILLIVOLTS 1100UL  // Nominal, ±10% part to part
+#define ADC_FULL_SCALE 1023UL
+
+#define WATCHDOG_PERIOD_MILLIS(prescaler) (16UL << (prescaler))  // 2K cycles of the 128kHz oscillator, doubling per step
+#define WATCHDOG_SLEEP_PRESCALER_MAX 7  // 2s, the longest without WDP3
+
+static volatile WatchdogHandler watchdogHandler = NULL;
+static volatile boolean watchdogWaking = false;  // Set while sleeping, the next interrupt is a wake-up, not a bark
+static volatile boolean pinWoke = false;
+
+extern volatile unsigned long timer0_millis;  // The Arduino core's millis() count, wiring.c
+
+static void configureWatchdog(void) {
+  
+  cli();
+  wdt_reset();
+  
+  // Clear the reset flag, the WDRF bit (bit 3) of MCUSR.
+  MCUSR = MCUSR & B11110111;
+    
+  // Set the WDCE bit (bit 4) and the WDE bit (bit 3) 
+  // of WDTCSR. The WDCE bit must be set in order to 
+  // change WDE or the watchdog prescalers. Setting the 
+  // WDCE bit will allow updtaes to the prescalers and 
+  // WDE for 4 clock cycles then it will be reset by 
+  // hardware.
+  WDTCSR = WDTCSR | B00011000; 
+  
+  // Interrupt and reset enabled (WDIE, WDE) with the 512K
+  // prescaler, a time-out interval of about 4.0 s.  The first
+  // time-out runs the interrupt and clears WDIE, the next resets.
+  WDTCSR = B01101000;
+  
+  sei();
+}
+
+void hal_startWatchdogTimer(WatchdogHandler beforeReset) {
+  
+  watchdogHandler = beforeReset;
+  configureWatchdog();
+}
+
+void hal_feedWatchdog(void) {
+  
+  wdt_reset();
+  WDTCSR = WDTCSR | B01000000;  // Re-arm the interrupt in case it fired and the loop has since recovered
+}
+
+ISR(WDT_vect) {
+  
+  if (watchdogWaking) {
+    
+    watchdogWaking = false;
+    return;
+  }
+  
+  // Last chance before the reset, the loop hasn't fed us for a whole time-out
+  if (watchdogHandler) watchdogHandler();
+}
+
+
+// MONOTONIC CLOCK
+// ----------------------------------------------------
+static uint32_t clockLastMillis = 0;  // timer0_millis when last read
+static uint32_t clockWraps = 0;  // High word
+
+uint64_t hal_millis64(void) {
+  
+  // NOTE: Restores rather than enables interrupts, so it can be called from a handler
+  uint8_t oldSREG = SREG;
+  cli();
+  
+  uint32_t ticks = timer0_millis;
+  if (ticks < clockLastMillis) clockWraps++;
+  clockLastMillis = ticks;
+  
+  uint64_t result = ((uint64_t) clockWraps << 32) | ticks;
+  SREG = oldSREG;
+  
+  return result;
+}
+
+// INTERRUPTS
+// ----------------------------------------------------
+uint8_t hal_disableInterrupts(void) {
+  
+  uint8_t oldSREG = SREG;
+  cli();
+  
+  return oldSREG;
+}
+
+void hal_restoreInterrupts(uint8_t state) {
+  
+  SREG = state;
+}
+
+
+// SLEEP
+// ----------------------------------------------------
+ISR(PCINT0_vect) {
+  
+  pinWoke = true;
+}
+
+static unsigned long sleepIdle(unsigned long maxMillis, uint8_t wakePin, boolean *wokeByPin) {
+  
+  unsigned long start = millis();
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  
+  // Timer0's overflow wakes us every ~1ms, check the pin each time
+  while (millis() - start < maxMillis) {
+    
+    if (digitalRead(wakePin) == LOW) {
+      
+      *wokeByPin = true;
+      break;
+    }
+    
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+  }
+  
+  return millis() - start;
+}
+
+static unsigned long sleepPowerDown(unsigned long maxMillis, uint8_t wakePin, boolean *wokeByPin) {
+  
+  uint8_t prescaler = 0;
+  while (prescaler < WATCHDOG_SLEEP_PRESCALER_MAX && WATCHDOG_PERIOD_MILLIS(prescaler + 1) <= maxMillis) prescaler++;
+  
+  cli();
+  
+  if (digitalRead(wakePin) == LOW) {  // Already waiting for us
+    
+    sei();
+    *wokeByPin = true;
+    return 0;
+  }
+  
+  // Watchdog as a plain interrupt for the length of the sleep
+  wdt_reset();
+  WDTCSR = WDTCSR | B00011000;
+  WDTCSR = _BV(WDIE) | prescaler;
+  watchdogWaking = true;
+  
+  // RDYN's pin change interrupt
+  pinWoke = false;
+  *digitalPinToPCMSK(wakePin) |= _BV(digitalPinToPCMSKbit(wakePin));
+  PCIFR = _BV(digitalPinToPCICRbit(wakePin));
+  PCICR |= _BV(digitalPinToPCICRbit(wakePin));
+  
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  sei();  // NOTE: The instruction after sei() always runs, so a wake-up can't slip in before the sleep
+  sleep_cpu();
+  sleep_disable();
+  
+  PCICR &= ~_BV(digitalPinToPCICRbit(wakePin));
+  *digitalPinToPCMSK(wakePin) &= ~_BV(digitalPinToPCMSKbit(wakePin));
+  
+  // No clock ran, so an early wake could have been anywhere in the period
+  unsigned long slept = WATCHDOG_PERIOD_MILLIS(prescaler);
+  if (pinWoke) {
+    
+    slept /= 2;
+    *wokeByPin = true;
+  }
+  
+  cli();
+  watchdogWaking = false;
+  timer0_millis += slept;
+  sei();
+  
+  configureWatchdog();
+  
+  return slept;
+}
+
+unsigned long hal_sleep(HalSleepMode mode, unsigned long maxMillis, uint8_t wakePin, boolean *wokeByPin) {
+  
+  *wokeByPin = false;
+  
+  if (mode == HalSleepPowerDown) return sleepPowerDown(maxMillis, wakePin, wokeByPin);
+  else return sleepIdle(maxMillis, wakePin, wokeByPin);
+}
+
+uint16_t hal_supplyMillivolts(void) {
+  
+  // Measure the bandgap with AVcc as the reference
+  // NOTE: analogRead() sets ADMUX itself, so this doesn't disturb it
+  ADMUX = _BV(REFS0) | _BV(MUX3) | _BV(MUX2) | _BV(MUX1);
+  delay(2);  // Let the reference settle
+  
+  ADCSRA |= _BV(ADSC);
+  while (bit_is_set(ADCSRA, ADSC)) {}
+  
+  uint16_t reading = ADCL;
+  reading |= ADCH << 8;
+  
+  return (reading == 0) ? 0xFFFF : (uint16_t)((BANDGAP_MILLIVOLTS * ADC_FULL_SCALE) / reading);
+}
+
+
+
+// TWO-WIRE INTERFACE
+// ----------------------------------------------------
+#define TWI_ENABLED (_BV(TWEN) | _BV(TWIE))  // Owns SDA and SCL, interrupts on each bus event
+#define TWI_CONTINUE (TWI_ENABLED | _BV(TWINT))  // Writing TWINT back starts the next step
+
+static TwiDoneHandler twiDone = NULL;
+static volatile uint8_t twiAddress;
+static uint8_t *volatile twiData;
+static volatile uint8_t twiWriteLength;
+static volatile uint8_t twiReadLength;
+static volatile uint8_t twiIndex;
+static volatile boolean twiReading;
+
+static void twiFinish(HalTwiResult result) {
+  
+  // Wait out the stop, a start written while it's pending would be lost (~10µs at 400kHz)
+  TWCR = TWI_CONTINUE | _BV(TWSTO);
+  while (TWCR & _BV(TWSTO)) {}
+  
+  if (twiDone) twiDone(result, twiIndex);
+}
+
+void hal_twiBegin(uint32_t frequency, TwiDoneHandler done) {
+  
+  twiDone = done;
+  
+  // Internal pull-ups as well as the board's 2.2K, in case a sensor is unplugged
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+  
+  TWSR = 0;  // Prescaler of 1
+  TWBR = ((F_CPU / frequency) - 16) / 2;
+  TWCR = TWI_ENABLED;
+}
+
+void hal_twiStart(uint8_t address, uint8_t *data, uint8_t writeLength, uint8_t readLength) {
+  
+  twiAddress = address;
+  twiData = data;
+  twiWriteLength = writeLength;
+  twiReadLength = readLength;
+  twiIndex = 0;
+  twiReading = (writeLength == 0 && readLength > 0);
+  
+  TWCR = TWI_CONTINUE | _BV(TWSTA);
+}
+
+void hal_twiReset(void) {
+  
+  // Switching the peripheral off releases both lines whatever state it was left in
+  TWCR = 0;
+  TWCR = TWI_ENABLED;
+}
+
+ISR(TWI_vect) {
+  
+  switch (TW_STATUS) {
+    
+    case TW_START:
+    case TW_REP_START:
+      TWDR = (twiAddress << 1) | (twiReading ? TW_READ : TW_WRITE);
+      TWCR = TWI_CONTINUE;
+      break;
+    
+    // Master transmitter
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (twiIndex < twiWriteLength) {
+        
+        TWDR = twiData[twiIndex++];
+        TWCR = TWI_CONTINUE;
+        
+      } else if (twiReadLength > 0) {
+        
+        twiReading = true;
+        twiIndex = 0;
+        TWCR = TWI_CONTINUE | _BV(TWSTA);
+        
+      } else twiFinish(HalTwiOK);
+      break;
+    
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+      twiFinish(HalTwiAddressNack);
+      break;
+    
+    case TW_MT_DATA_NACK:
+      twiFinish(HalTwiDataNack);
+      break;
+    
+    case TW_MT_ARB_LOST:  // Same code as TW_MR_ARB_LOST
+      TWCR = TWI_CONTINUE;  // Another master has the bus, let go without a stop
+      if (twiDone) twiDone(HalTwiBusError, twiIndex);
+      break;
+    
+    // Master receiver
+    case TW_MR_DATA_ACK:
+      twiData[twiIndex++] = TWDR;
+      // Fall through
+    case TW_MR_SLA_ACK:
+      TWCR = TWI_CONTINUE | ((twiIndex + 1 < twiReadLength) ? _BV(TWEA) : 0);  // NACK the last byte
+      break;
+    
+    case TW_MR_DATA_NACK:
+      twiData[twiIndex++] = TWDR;
+      twiFinish(HalTwiOK);
+      break;
+    
+    case TW_BUS_ERROR:
+    default:
+      twiFinish(HalTwiBusError);  // The stop also clears the error
+      break;
+  }
+}
+
+
+void hal_shiftRegisterWrite(uint8_t latchPin, uint8_t dataPin, uint8_t clockPin, uint8_t value) {
+  
+   digitalWrite(latchPin, LOW);
+   shiftOut(dataPin, clockPin, LSBFIRST, value);
+   digitalWrite(latchPin, HIGH);
+}
+
+#endif
@@ -7,7 +7,6 @@
 
 #import "Arduino.h"
 #import "lib_hih6100.h"
-#include <Wire.h>
 
 
 HIH6100_Sensor::HIH6100_Sensor(void) {
@@ -15,16 +14,31 @@ HIH6100_Sensor::HIH6100_Sensor(void) {
   state = HIH6100StateUndefined;
 }
 
-boolean HIH6100_Sensor::performMeasurement(void) {
+boolean HIH6100_Sensor::requestMeasurement(TwiTransaction *transaction, TwiCallback callback, void *context) {
   
-  byte _status;
-  unsigned int H_dat, T_dat;
-  float RH, T_C;
-   
-  _status = this->_requestData(&H_dat, &T_dat);
+  // A Measurement Request is just the address with the write bit, no data
+  return _queue(transaction, 0, callback, context);
+}
+
+boolean HIH6100_Sensor::requestResult(TwiTransaction *transaction, TwiCallback callback, void *context) {
+  
+  return _queue(transaction, HIH6100_RESULT_LENGTH, callback, context);
+}
 
+boolean HIH6100_Sensor::decodeResult(TwiTransaction *transaction) {
+  
+  if (transaction->status != TwiStatusOK || transaction->byteCount != HIH6100_RESULT_LENGTH) {
+    
+    state = HIH6100StateNoResponse;
+    return false;
+  }
+  
+  byte *bytes = transaction->data;
+  unsigned int H_dat = (((unsigned int) bytes[0] & 0x3f) << 8) | bytes[1];
+  unsigned int T_dat = ((((unsigned int) bytes[2]) << 8) | bytes[3]) / 4;
+  
   // Decode the device status
-  switch (_status) {
+  switch ((bytes[0] >> 6) & 0x03) {
     
     case 0: state = HIH6100StateNormal; break;
     case 1: state = HIH6100StateStale; break;  // Hasn't performed a measurement since we last read
@@ -33,48 +47,34 @@ boolean HIH6100_Sensor::performMeasurement(void) {
   }       
   
   // Convert raw values to appropriate units
+#ifdef GREENHOUSE_FIXED_POINT
+  humidity = Fixed::fromRaw((int32_t)(((uint32_t) H_dat * HIH6100_HUMIDITY_SCALE) >> HIH6100_SCALE_SHIFT));
+  temperature = Fixed::fromRaw((int32_t)(((uint32_t) T_dat * HIH6100_TEMPERATURE_SCALE) >> HIH6100_SCALE_SHIFT) - 40L * FIXED_ONE);
+#else
   humidity = (float) H_dat * 6.10e-3;
   temperature = (float) T_dat * 1.007e-2 - 40.0;
+#endif
 
   return (state == HIH6100StateNormal);
 }
 
-byte HIH6100_Sensor::_requestData(unsigned int *p_H_dat, unsigned int *p_T_dat) {
-  
-  byte address, Hum_H, Hum_L, Temp_H, Temp_L, _status;
-  unsigned int H_dat, T_dat;
-  address = 0x27;
-  Wire.beginTransmission(address); 
-  Wire.endTransmission();
-  delay(100);
-  
-  Wire.requestFrom((int)address, (int) 4);
-  
-  if (Wire.available() == 4) {
-    
-    Hum_H = Wire.read();
-    Hum_L = Wire.read();
-    Temp_H = Wire.read();
-    Temp_L = Wire.read();
-    Wire.endTransmission();
+boolean HIH6100_Sensor::_queue(TwiTransaction *transaction, uint8_t readLength, TwiCallback callback, void *context) {
   
-  } else Serial.println("Didn't get bytes from HIH");
+  transaction->address = HIH6100_ADDRESS;
+  transaction->writeLength = 0;
+  transaction->readLength = readLength;
+  transaction->timeout = TWI_DEFAULT_TIMEOUT;
+  transaction->callback = callback;
+  transaction->context = context;
   
-  _status = (Hum_H >> 6) & 0x03;
-  Hum_H = Hum_H & 0x3f;
-  H_dat = (((unsigned int)Hum_H) << 8) | Hum_L;
-  T_dat = (((unsigned int)Temp_H) << 8) | Temp_L;
-  T_dat = T_dat / 4;
-  *p_H_dat = H_dat;
-  *p_T_dat = T_dat;
-  return(_status);
+  return twiBus.queue(transaction);
 }
 
 void HIH6100_Sensor::printStatus(void) {
   
   Serial.print("HIH6100: ");
-  Serial.print(humidity);
+  Serial.print(toFloat(humidity));
   Serial.print("  % humidity, ");
-  Serial.print(temperature);
+  Serial.print(toFloat(temperature));
   Serial.println(" deg C");
 }
@@ -19,24 +19,29 @@
 
 #ifndef HIH6100_Sensor_h
 #define HIH6100_Sensor_h
+
+#include "lib_fixed.h"
+#include "lib_twi.h"
+
+#define HIH6100_ADDRESS 0x27
+#define HIH6100_CONVERSION_TIME 50  // ms, datasheet gives 36.65ms typical
+#define HIH6100_RESULT_LENGTH 4  // bytes, humidity then temperature
+
+// Counts to units, as Q15.16 raw values scaled up a further 2^7 so the 14-bit counts keep their precision
+#define HIH6100_HUMIDITY_SCALE 51171UL  // 6.10e-3 %RH per count
+#define HIH6100_TEMPERATURE_SCALE 84474UL  // 1.007e-2 °C per count
+#define HIH6100_SCALE_SHIFT 7
     
 // TYPES
 // -------------------------------------------------
-typedef enum HoneywellSensor {
-  
-  HoneywellSensorNone,
-  HoneywellSensorExterior,
-  HoneywellSensorInterior
-  
-};
-
 typedef enum HIH6100State {
   
   HIH6100StateUndefined,
   HIH6100StateNormal,
   HIH6100StateStale,
   HIH6100StateCommandMode,
-  HIH6100StateDiagnostic
+  HIH6100StateDiagnostic,
+  HIH6100StateNoResponse  // The fetch failed on the bus, readings are from before
 };
 
 
@@ -47,16 +52,20 @@ class HIH6100_Sensor {
   
   public:
     HIH6100_Sensor(void);
-    boolean performMeasurement(void);
     void printStatus(void);
     
+    // Measurement in three steps through twiBus, the callbacks run from TwiBus::loop()
+    // NOTE: All HIH6100s share one address, so one request starts every sensor enabled on the bus
+    static boolean requestMeasurement(TwiTransaction *transaction, TwiCallback callback, void *context);
+    static boolean requestResult(TwiTransaction *transaction, TwiCallback callback, void *context);  // No sooner than HIH6100_CONVERSION_TIME after
+    boolean decodeResult(TwiTransaction *transaction);  // From requestResult()'s callback, true for a fresh reading
+    
     HIH6100State state;  // Status of the sensor device
-    float temperature;  // °C
-    float humidity;  // % relative humidity
+    control_t temperature;  // °C
+    control_t humidity;  // % relative humidity
     
   private:
-    byte _requestData(unsigned int *p_H_dat, unsigned int *p_T_dat);
-    void _print_float(float f, int num_digits);
+    static boolean _queue(TwiTransaction *transaction, uint8_t readLength, TwiCallback callback, void *context);
 };
 
 #endif
@@ -0,0 +1,241 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include <stddef.h>
+#include <string.h>
+#include "constants.h"
+#include "lib_configStore.h"
+#include "lib_history.h"
+#include "lib_eepromGuard.h"
+
+#define CRC_INITIAL 0xFFFF
+#define HISTORY_SAMPLE_MAX_SIZE (HistoryChannelCount * 3)  // A 17-bit zig-zag difference needs three varint bytes
+
+// Counts per unit, coarse enough that consecutive averages mostly differ by a one-byte varint
+static const float channelScales[HistoryChannelCount] = { 10.0f, 10.0f, 10.0f, 10.0f, 1.0f, 1.0f };
+
+static uint16_t headerCRC(const HistoryBlockHeader *header) {
+  
+  uint16_t crc = CRC_INITIAL;
+  const uint8_t *headerBytes = (const uint8_t *) header;
+  for (uint8_t i = 0; i < offsetof(HistoryBlockHeader, crc); i++) crc = crc16Update(crc, headerBytes[i]);
+  
+  return crc;
+}
+
+
+HistoryLog::HistoryLog(uint16_t startAddress, uint16_t length) {
+  
+  _startAddress = startAddress;
+  blockCount = length / HISTORY_BLOCK_SIZE;
+  
+  samplesLogged = 0;
+  bytesLogged = 0;
+  
+  _hasBlock = false;
+  _currentBlock = 0;
+  _sequence = 0;
+  _writeOffset = 0;
+  _header.sampleCount = 0;
+  
+  for (uint8_t i = 0; i < HistoryChannelCount; i++) {
+    
+    _sums[i] = 0;
+    _counts[i] = 0;
+  }
+}
+
+void HistoryLog::begin(void) {
+  
+  _hasBlock = false;
+  
+  for (uint8_t block = 0; block < blockCount; block++) {
+    
+    HistoryBlockHeader header;
+    if (!_readHeader(block, &header)) continue;
+    
+    // NOTE: Sequence numbers wrap, newer is a positive difference
+    if (!_hasBlock || (int16_t)(header.sequence - _sequence) > 0) {
+      
+      _hasBlock = true;
+      _currentBlock = block;
+      _sequence = header.sequence;
+    }
+  }
+  
+  // The clock restarted with us, so the newest block can't be continued
+  _writeOffset = 0;
+}
+
+void HistoryLog::addMeasurement(HistoryChannel channel, float value) {
+  
+  if (value == UNAVAILABLE_f || value != value) return;  // Unavailable or NaN
+  
+  float scaled = value * channelScales[channel];
+  if (scaled > 32767.0f) scaled = 32767.0f;
+  if (scaled < -32767.0f) scaled = -32767.0f;
+  
+  _sums[channel] += (int32_t)(scaled + ((scaled < 0) ? -0.5f : 0.5f));
+  _counts[channel]++;
+}
+
+boolean HistoryLog::logSample(uint32_t time, uint16_t interval, boolean clockSet) {
+  
+  // Interval averages, rounded to the nearest count
+  int16_t values[HistoryChannelCount];
+  boolean measured = false;
+  
+  for (uint8_t i = 0; i < HistoryChannelCount; i++) {
+    
+    if (_counts[i] == 0) values[i] = HISTORY_VALUE_UNAVAILABLE;
+    else {
+      
+      int32_t half = (_sums[i] < 0) ? -(int32_t)(_counts[i] / 2) : (int32_t)(_counts[i] / 2);
+      values[i] = (int16_t)((_sums[i] + half) / _counts[i]);
+      measured = true;
+    }
+    
+    _sums[i] = 0;
+    _counts[i] = 0;
+  }
+  
+  if (!measured) return false;
+  
+  uint8_t flags = clockSet ? HISTORY_FLAG_CLOCK_SET : 0;
+  uint8_t bytes[HISTORY_SAMPLE_MAX_SIZE];
+  uint8_t size = 0;
+  
+  // Continue the current block only if this sample lands where its timestamps say it will
+  boolean continues = (_writeOffset != 0) && flags == _header.flags && interval == _header.interval && _header.sampleCount < 0xFF;
+  if (continues) {
+    
+    uint32_t expected = _header.startTime + (uint32_t) _header.sampleCount * interval;
+    int32_t drift = (int32_t)(time - expected);
+    if (drift < 0) drift = -drift;
+    
+    size = _encodeSample(values, bytes);
+    continues = (drift <= interval / 2) && (_writeOffset + size <= HISTORY_BLOCK_SIZE);
+  }
+  
+  if (!continues) {
+    
+    _startBlock(time, interval, flags);
+    
+    for (uint8_t i = 0; i < HistoryChannelCount; i++) _previous[i] = 0;
+    size = _encodeSample(values, bytes);
+  }
+  
+  // Sample first, then the count that makes it visible
+  uint16_t address = _blockAddress(_currentBlock);
+  for (uint8_t i = 0; i < size; i++) _writeByte(address + _writeOffset++, bytes[i]);
+  
+  _header.sampleCount++;
+  _writeByte(address + offsetof(HistoryBlockHeader, sampleCount), _header.sampleCount);
+  
+  for (uint8_t i = 0; i < HistoryChannelCount; i++) _previous[i] = values[i];
+  
+  samplesLogged++;
+  bytesLogged += size;
+  
+  return true;
+}
+
+
+// BLOCKS
+// ----------------------------------------------------
+uint16_t HistoryLog::_blockAddress(uint8_t block) {
+  
+  return _startAddress + (uint16_t) block * HISTORY_BLOCK_SIZE;
+}
+
+boolean HistoryLog::_readHeader(uint8_t block, HistoryBlockHeader *header) {
+  
+  uint16_t address = _blockAddress(block);
+  
+  uint8_t *headerBytes = (uint8_t *) header;
+  for (uint8_t i = 0; i < sizeof(HistoryBlockHeader); i++) headerBytes[i] = eepromRead(address + i);
+  
+  return historyHeaderValid(header);
+}
+
+void HistoryLog::_startBlock(uint32_t time, uint16_t interval, uint8_t flags) {
+  
+  _currentBlock = _hasBlock ? (_currentBlock + 1) % blockCount : 0;
+  _sequence = _hasBlock ? _sequence + 1 : 0;
+  _hasBlock = true;
+  
+  _header.sequence = _sequence;
+  _header.startTime = time;
+  _header.interval = interval;
+  _header.flags = flags;
+  _header.sampleCount = 0;
+  
+  _header.crc = headerCRC(&_header);
+  
+  // Count first, so the samples being overwritten stop counting before the header changes
+  uint16_t address = _blockAddress(_currentBlock);
+  _writeByte(address + offsetof(HistoryBlockHeader, sampleCount), 0);
+  const uint8_t *headerBytes = (const uint8_t *) &_header;
+  for (uint8_t i = 0; i < offsetof(HistoryBlockHeader, sampleCount); i++) _writeByte(address + i, headerBytes[i]);
+  
+  _writeOffset = sizeof(HistoryBlockHeader);
+}
+
+uint8_t HistoryLog::_encodeSample(const int16_t *values, uint8_t *bytes) {
+  
+  uint8_t size = 0;
+  
+  for (uint8_t i = 0; i < HistoryChannelCount; i++) {
+    
+    // Zig-zag, so small differences of either sign stay small
+    int32_t delta = (int32_t) values[i] - _previous[i];
+    uint32_t zigzag = ((uint32_t) delta << 1) ^ (uint32_t)(delta >> 31);
+    
+    // Varint, 7 bits a byte, least significant first
+    while (zigzag >= 0x80) {
+      
+      bytes[size++] = (zigzag & 0x7F) | 0x80;
+      zigzag >>= 7;
+    }
+    bytes[size++] = zigzag;
+  }
+  
+  return size;
+}
+
+void HistoryLog::_writeByte(uint16_t address, uint8_t value) {
+  
+  // Update-if-different, as ConfigStore does
+  if (eepromRead(address) != value) eepromWrite(address, value);
+}
+
+
+// DECODING
+// ----------------------------------------------------
+boolean historyHeaderValid(const HistoryBlockHeader *header) {
+  
+  return (headerCRC(header) == header->crc);
+}
+
+uint8_t historyVarintDecode(const uint8_t *bytes, uint8_t length, int32_t *value) {
+  
+  uint32_t zigzag = 0;
+  
+  for (uint8_t i = 0; i < length && i < 3; i++) {
+    
+    zigzag |= (uint32_t)(bytes[i] & 0x7F) << (7 * i);
+    
+    if ((bytes[i] & 0x80) == 0) {
+      
+      *value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+      return i + 1;
+    }
+  }
+  
+  return 0;
+}
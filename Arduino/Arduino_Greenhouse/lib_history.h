@@ -0,0 +1,97 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef History_h
+#define History_h
+
+#include "Arduino.h"
+
+#define HISTORY_BLOCK_SIZE 128  // bytes, header included
+#define HISTORY_VALUE_UNAVAILABLE -32768  // Logged for a channel with no valid reading in the interval
+
+#define HISTORY_FLAG_CLOCK_SET B00000001  // startTime is Unix time, otherwise seconds since boot
+
+// TYPES
+// -------------------------------------------------
+enum HistoryChannel {
+  
+  HistoryChannelExteriorHumidity,  // 0.1 % RH per count
+  HistoryChannelExteriorTemperature,  // 0.1 °C per count
+  HistoryChannelInteriorHumidity,
+  HistoryChannelInteriorTemperature,
+  HistoryChannelVentingNecessity,  // 1 per count
+  HistoryChannelVentServoPosition,  // servo angle
+  HistoryChannelCount
+  
+};
+
+// Starts every block, followed by its samples
+// NOTE: Each sample is one zig-zag varint per channel, the difference from the previous
+//   sample in the block.  The first sample is a difference from zero, so a block decodes
+//   on its own once older ones have been overwritten.
+typedef struct __attribute__((packed)) {
+  
+  uint16_t sequence;  // Increments with every block started, the highest valid one is newest
+  uint32_t startTime;  // s, of the first sample
+  uint16_t interval;  // s between samples
+  uint8_t flags;
+  uint16_t crc;  // CRC-16 of the fields above
+  uint8_t sampleCount;  // Bumped after each sample's bytes are written, so a half-written one is never counted
+  
+} HistoryBlockHeader;
+
+
+// Class Definition
+// -------------------------------------------------
+// Ring of fixed-size blocks in EEPROM holding the interval averages of each channel, so a
+//   client that was out of range can fetch what it missed.  The ring is downloaded as it
+//   lies in EEPROM, through the bulk transfer's BULK_STREAM_HISTORY, blocks whose header
+//   fails historyHeaderValid() or holds no samples are unused.
+// NOTE: A new block is started after a reset, when a sample would overflow the block, or
+//   when the clock jumps, so samples within a block are always exactly interval apart.
+class HistoryLog {
+  
+  public:
+    HistoryLog(uint16_t startAddress, uint16_t length);
+    
+    void begin(void);  // Finds the newest block, logging resumes in the one after it
+    
+    // Averaged until the next logSample()
+    void addMeasurement(HistoryChannel channel, float value);
+    boolean logSample(uint32_t time, uint16_t interval, boolean clockSet);  // time in s, false if nothing was measured
+    
+    uint8_t blockCount;
+    unsigned long samplesLogged;
+    unsigned long bytesLogged;  // Encoded sample bytes, excluding headers
+  
+  private:
+    uint16_t _blockAddress(uint8_t block);
+    boolean _readHeader(uint8_t block, HistoryBlockHeader *header);
+    void _startBlock(uint32_t time, uint16_t interval, uint8_t flags);
+    uint8_t _encodeSample(const int16_t *values, uint8_t *bytes);
+    void _writeByte(uint16_t address, uint8_t value);
+    
+    uint16_t _startAddress;
+    
+    // Block being filled
+    boolean _hasBlock;
+    uint8_t _currentBlock;
+    uint16_t _sequence;
+    HistoryBlockHeader _header;
+    uint8_t _writeOffset;
+    int16_t _previous[HistoryChannelCount];
+    
+    // Interval averages
+    int32_t _sums[HistoryChannelCount];
+    uint16_t _counts[HistoryChannelCount];
+};
+
+// Decoding, for a client of the downloaded ring
+boolean historyHeaderValid(const HistoryBlockHeader *header);
+uint8_t historyVarintDecode(const uint8_t *bytes, uint8_t length, int32_t *value);  // Returns bytes used, 0 if truncated
+
+#endif
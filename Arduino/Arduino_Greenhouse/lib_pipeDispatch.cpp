@@ -0,0 +1,66 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include <avr/pgmspace.h>
+#include <string.h>
+#include "lib_pipeDispatch.h"
+
+
+static float valueAsFloat(uint8_t type, const uint8_t *bytes) {
+  
+  // NOTE: Copied out rather than cast, the ACI buffer has no alignment guarantee
+  switch (type) {
+    
+    case PipeValueFloat: { float value; memcpy(&value, bytes, sizeof(value)); return value; }
+    case PipeValueInt16: { int16_t value; memcpy(&value, bytes, sizeof(value)); return value; }
+    case PipeValueUint32: { uint32_t value; memcpy(&value, bytes, sizeof(value)); return value; }
+    default: return bytes[0];
+  }
+}
+
+PipeWriteResult pipeDispatchWrite(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount, void *config,
+                                  const PipeDescriptor *descriptors, const uint8_t *index, uint8_t pipeCount,
+                                  PipeDescriptor *descriptor) {
+  
+  if (pipe > pipeCount) return PipeWriteUnhandled;
+  
+  uint8_t position = pgm_read_byte(&index[pipe]);
+  if (position == PIPE_DESCRIPTOR_NONE) return PipeWriteUnhandled;
+  
+  memcpy_P(descriptor, &descriptors[position], sizeof(PipeDescriptor));
+  
+  if (byteCount != descriptor->size) return PipeWriteRejected;
+  
+  if (!(descriptor->flags & PIPE_FLAG_UNBOUNDED)) {
+    
+    uint8_t fieldSize = descriptor->size / descriptor->count;
+    
+    // One field out of its limits rejects the whole write
+    for (uint8_t field = 0; field < descriptor->count; field++) {
+      
+      float value = valueAsFloat(descriptor->type, bytes + field * fieldSize);
+      if (!(value >= descriptor->minimum && value <= descriptor->maximum)) return PipeWriteRejected;  // NaN fails too
+    }
+  }
+  
+  if (descriptor->flags & PIPE_FLAG_ASCENDING) {
+    
+    uint8_t fieldSize = descriptor->size / descriptor->count;
+    
+    for (uint8_t field = 1; field < descriptor->count; field++) {
+      
+      float previous = valueAsFloat(descriptor->type, bytes + (field - 1) * fieldSize);
+      float value = valueAsFloat(descriptor->type, bytes + field * fieldSize);
+      if (!(value >= previous)) return PipeWriteRejected;
+    }
+  }
+  
+  memcpy((uint8_t *) config + descriptor->fieldOffset, bytes, descriptor->size);
+  
+  return PipeWriteAccepted;
+}
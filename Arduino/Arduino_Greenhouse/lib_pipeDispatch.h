@@ -0,0 +1,64 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef PipeDispatch_h
+#define PipeDispatch_h
+
+#include "Arduino.h"
+
+#define PIPE_NONE 0  // Pipe numbers start at 1
+#define PIPE_DESCRIPTOR_NONE 0xFF
+
+#define PIPE_FLAG_APPLY_CONTROL B00000001  // The control loop's copy of the configuration needs refreshing
+#define PIPE_FLAG_UNBOUNDED B00000010  // Any value is accepted, minimum and maximum are ignored
+#define PIPE_FLAG_ASCENDING B00000100  // Each of a run of fields must be at least the one before it, e.g. a minimum then a maximum
+
+// TYPES
+// -------------------------------------------------
+enum PipeValueType {
+  
+  PipeValueFloat,
+  PipeValueInt16,
+  PipeValueUint8,
+  PipeValueUint32
+  
+};
+
+enum PipeWriteResult {
+  
+  PipeWriteUnhandled,  // No descriptor, the pipe carries a command
+  PipeWriteRejected,  // Wrong size, outside the limits or out of order, nothing changed
+  PipeWriteAccepted
+  
+};
+
+// One writable configuration field, or a run of them of the same type, see pipe_descriptors.h
+// NOTE: Generated into PROGMEM by generate_services.py, read with memcpy_P()
+typedef struct __attribute__((packed)) {
+  
+  uint8_t pipe;  // RX_ACK_AUTO pipe the client writes
+  uint8_t echoPipe;  // SET pipe given the accepted value, PIPE_NONE for none
+  uint8_t type;  // PipeValueType
+  uint8_t size;  // bytes, a write must match it exactly
+  uint8_t count;  // Fields of the type, consecutive from fieldOffset, each held to the limits
+  uint8_t fieldOffset;  // bytes into the configuration struct
+  uint8_t flags;
+  float minimum;
+  float maximum;
+  
+} PipeDescriptor;
+
+
+// Generic handler for writes to a configuration field
+// NOTE: The index is by pipe number, so finding the descriptor takes one lookup however
+//   many pipes there are.  On acceptance the value is copied into config and descriptor
+//   is filled in for the caller to persist and echo it.
+PipeWriteResult pipeDispatchWrite(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount, void *config,
+                                  const PipeDescriptor *descriptors, const uint8_t *index, uint8_t pipeCount,
+                                  PipeDescriptor *descriptor);
+
+#endif
@@ -0,0 +1,81 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "constants.h"
+#include "lib_power.h"
+
+PowerMonitor::PowerMonitor(void) {
+  
+  cycleAwakeMicros = 0;
+  cycleIdleMillis = 0;
+  cyclePowerDownMillis = 0;
+  cycleMicroamps = 0;
+  
+  totalAwakeMillis = 0;
+  totalIdleMillis = 0;
+  totalPowerDownMillis = 0;
+  sleepCount = 0;
+  radioWakeCount = 0;
+  
+  _awakeSince = 0;
+  _awakeMicros = 0;
+  _idleMillis = 0;
+  _powerDownMillis = 0;
+  _awakeCarryMicros = 0;
+}
+
+void PowerMonitor::begin(unsigned long nowMicros) {
+  
+  _awakeSince = nowMicros;
+}
+
+void PowerMonitor::sleeping(unsigned long nowMicros) {
+  
+  _awakeMicros += nowMicros - _awakeSince;
+}
+
+void PowerMonitor::woke(HalSleepMode mode, unsigned long sleptMillis, boolean wokeByRadio, unsigned long nowMicros) {
+  
+  if (mode == HalSleepPowerDown) _powerDownMillis += sleptMillis;
+  else _idleMillis += sleptMillis;
+  
+  sleepCount++;
+  if (wokeByRadio) radioWakeCount++;
+  
+  _awakeSince = nowMicros;
+}
+
+void PowerMonitor::closeCycle(unsigned long nowMicros) {
+  
+  sleeping(nowMicros);
+  _awakeSince = nowMicros;
+  
+  cycleAwakeMicros = _awakeMicros;
+  cycleIdleMillis = _idleMillis;
+  cyclePowerDownMillis = _powerDownMillis;
+  
+  // Time-weighted average of the three states, in ms so a cycle's sums stay well inside 32 bits
+  float awakeMillis = cycleAwakeMicros / 1000.0;
+  float cycleMillis = awakeMillis + cycleIdleMillis + cyclePowerDownMillis;
+  
+  if (cycleMillis > 0) {
+    
+    float charge = awakeMillis * MCU_ACTIVE_MICROAMPS + cycleIdleMillis * MCU_IDLE_MICROAMPS + cyclePowerDownMillis * MCU_POWER_DOWN_MICROAMPS;
+    cycleMicroamps = (uint16_t) (charge / cycleMillis + 0.5);
+  }
+  
+  _awakeCarryMicros += _awakeMicros;
+  totalAwakeMillis += _awakeCarryMicros / 1000;
+  _awakeCarryMicros %= 1000;
+  totalIdleMillis += _idleMillis;
+  totalPowerDownMillis += _powerDownMillis;
+  
+  _awakeMicros = 0;
+  _idleMillis = 0;
+  _powerDownMillis = 0;
+}
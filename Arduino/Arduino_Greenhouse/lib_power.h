@@ -0,0 +1,53 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef PowerMonitor_h
+#define PowerMonitor_h
+
+#include "Arduino.h"
+#include "lib_hal.h"
+
+// Power Monitor
+// -------------------------------------------------
+// Splits each control cycle into time awake, in idle sleep and in power-down sleep,
+//   and estimates the MCU's average current from them
+// NOTE: Awake spans are timed with micros() between a wake and the next sleep, so never span a
+//   power-down, which stops the timer micros() counts. Sleep time is what hal_sleep() reports.
+
+// Class Definition
+class PowerMonitor {
+  
+  public:
+    PowerMonitor(void);
+    
+    void begin(unsigned long nowMicros);
+    void sleeping(unsigned long nowMicros);  // Ends the current awake span
+    void woke(HalSleepMode mode, unsigned long sleptMillis, boolean wokeByRadio, unsigned long nowMicros);
+    void closeCycle(unsigned long nowMicros);  // Once per control cycle, updates the cycle* values
+    
+    // Last complete cycle
+    unsigned long cycleAwakeMicros;
+    unsigned long cycleIdleMillis;
+    unsigned long cyclePowerDownMillis;
+    uint16_t cycleMicroamps;  // Estimated MCU average, see MCU_*_MICROAMPS
+    
+    // Since begin()
+    unsigned long totalAwakeMillis;
+    unsigned long totalIdleMillis;
+    unsigned long totalPowerDownMillis;
+    unsigned long sleepCount;
+    unsigned long radioWakeCount;  // Sleeps the nRF8001 cut short
+  
+  private:
+    unsigned long _awakeSince;  // µs
+    unsigned long _awakeMicros;  // This cycle so far
+    unsigned long _idleMillis;
+    unsigned long _powerDownMillis;
+    unsigned long _awakeCarryMicros;  // Below a ms, carried into the next cycle's total
+};
+
+#endif
@@ -0,0 +1,78 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_profiler.h"
+
+PhaseProfiler::PhaseProfiler(void) {
+  
+  reporting = false;
+  _reportPhase = 0;
+  reset(0);
+}
+
+void PhaseProfiler::begin(uint8_t phase, unsigned long nowMicros) {
+
+#ifdef GREENHOUSE_PROFILING
+  _started[phase] = nowMicros;
+#endif
+}
+
+void PhaseProfiler::end(uint8_t phase, unsigned long nowMicros) {
+
+#ifdef GREENHOUSE_PROFILING
+  uint32_t elapsed = nowMicros - _started[phase];
+  PhaseStatistics *statistics = &phases[phase];
+  
+  if (statistics->count == 0 || elapsed < statistics->minimum) statistics->minimum = elapsed;
+  if (elapsed > statistics->maximum) statistics->maximum = elapsed;
+  statistics->total += elapsed;
+  statistics->count++;
+#endif
+}
+
+void PhaseProfiler::reset(unsigned long nowMillis) {
+
+#ifdef GREENHOUSE_PROFILING
+  memset(phases, 0, sizeof(phases));
+#endif
+  _resetAt = nowMillis;
+}
+
+void PhaseProfiler::startReport(void) {
+  
+  reporting = true;
+  _reportPhase = 0;
+}
+
+boolean PhaseProfiler::nextReport(PhaseTimingReport *report, unsigned long nowMillis) {
+  
+  if (!reporting) return false;
+  
+  memset(report, 0, sizeof(PhaseTimingReport));
+
+#ifdef GREENHOUSE_PROFILING
+  if (_reportPhase < ProfilePhaseCount) {
+    
+    PhaseStatistics *statistics = &phases[_reportPhase];
+    
+    report->phase = _reportPhase++;
+    report->count = statistics->count;
+    report->minimum = statistics->minimum;
+    report->maximum = statistics->maximum;
+    if (statistics->count > 0) report->mean = statistics->total / statistics->count;
+    
+    return true;
+  }
+#endif
+  
+  report->phase = PROFILE_REPORT_END;
+  report->count = nowMillis - _resetAt;
+  reporting = false;
+  
+  return true;
+}
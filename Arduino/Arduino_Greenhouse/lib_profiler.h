@@ -0,0 +1,89 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef PhaseProfiler_h
+#define PhaseProfiler_h
+
+#include "Arduino.h"
+#include "constants.h"
+
+// Phase Profiler
+// -------------------------------------------------
+// Count, minimum, mean and maximum duration of each ProfilePhase, timed by PROFILE_BEGIN()
+//   and PROFILE_END() probes around it, and read back through the Diagnostics Report characteristic.
+// NOTE: Timed with micros(), 4µs resolution on a 16MHz AVR. Timer1 would resolve single cycles
+//   but belongs to the servo library, which restarts it every pulse frame.
+// NOTE: Without GREENHOUSE_PROFILING the probes compile to nothing and the statistics take no
+//   RAM, a report is then just the closing packet. The Arduino IDE has no per-sketch build
+//   flags, uncomment this to select it there
+//#define GREENHOUSE_PROFILING
+
+#define PROFILE_COMMAND_RESET 0  // Written to the Diagnostics Report after DIAGNOSTICS_REPORT_PHASE_TIMING
+#define PROFILE_COMMAND_REPORT 1
+
+#define PROFILE_REPORT_END 0xFF  // Phase of the closing packet
+
+// One phase's statistics, notified once per phase after PROFILE_COMMAND_REPORT
+// NOTE: The closing packet gives the ms since the last reset as its count, and zero times
+typedef struct __attribute__((packed)) {
+  
+  uint8_t phase;  // ProfilePhase, or PROFILE_REPORT_END
+  uint32_t count;
+  uint32_t minimum;  // µs, 0 until counted
+  uint32_t mean;  // µs
+  uint32_t maximum;  // µs
+  
+} PhaseTimingReport;
+
+typedef struct {
+  
+  uint32_t count;
+  uint32_t minimum;  // µs
+  uint32_t maximum;  // µs
+  uint64_t total;  // µs, 32 bits would wrap after 71 minutes spent in one phase
+  
+} PhaseStatistics;
+
+
+// Class Definition
+class PhaseProfiler {
+  
+  public:
+    PhaseProfiler(void);
+    
+    void begin(uint8_t phase, unsigned long nowMicros);
+    void end(uint8_t phase, unsigned long nowMicros);
+    void reset(unsigned long nowMillis);
+    
+    // Client report, one packet per call as the notification queue allows
+    void startReport(void);
+    boolean nextReport(PhaseTimingReport *report, unsigned long nowMillis);  // false once the closing packet has been given
+
+#ifdef GREENHOUSE_PROFILING
+    PhaseStatistics phases[ProfilePhaseCount];
+#endif
+    boolean reporting;
+  
+  private:
+#ifdef GREENHOUSE_PROFILING
+    unsigned long _started[ProfilePhaseCount];  // µs
+#endif
+    unsigned long _resetAt;  // ms
+    uint8_t _reportPhase;
+};
+
+extern PhaseProfiler profiler;  // The sketch's, shared with the modules it profiles
+
+#ifdef GREENHOUSE_PROFILING
+#define PROFILE_BEGIN(phase) profiler.begin(phase, micros())
+#define PROFILE_END(phase) profiler.end(phase, micros())
+#else
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#endif
+
+#endif
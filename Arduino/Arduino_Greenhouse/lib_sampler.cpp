@@ -0,0 +1,95 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_sampler.h"
+
+static unsigned long bounded(unsigned long value, unsigned long minimum, unsigned long maximum) {
+  
+  if (value < minimum) return minimum;
+  if (value > maximum) return maximum;
+  return value;
+}
+
+AdaptiveSampler::AdaptiveSampler(void) {
+  
+  interval = SAMPLING_INTERVAL;
+  minimum = SAMPLING_INTERVAL;
+  maximum = SAMPLING_INTERVAL;
+  
+  sampleCount = 0;
+  changeCount = 0;
+  _resetAt = 0;
+  _holdSamples = 0;
+}
+
+void AdaptiveSampler::begin(unsigned long startInterval, uint64_t nowMillis) {
+  
+  interval = bounded(startInterval, minimum, maximum);
+  reset(nowMillis);
+}
+
+void AdaptiveSampler::setBounds(unsigned long newMinimum, unsigned long newMaximum) {
+  
+  minimum = newMinimum;
+  maximum = (newMaximum > newMinimum) ? newMaximum : newMinimum;
+  
+  // NOTE: The interval itself moves into them at the next update(), when the tasks can be retimed
+}
+
+boolean AdaptiveSampler::update(float slope, float slopeError, float error) {
+  
+  sampleCount++;
+  
+  // Growing is held off until the window has a few samples at the new interval, halving never is
+  if (_holdSamples > 0) _holdSamples--;
+  
+  // Not enough of a window for a slope yet
+  if (slope == UNAVAILABLE_f || slopeError == UNAVAILABLE_f) return false;
+  
+  // A slope within the sensors' noise of zero is taken as zero, or noise alone would pin the interval at its minimum
+  if (fabs(slope) <= SAMPLER_SLOPE_SIGNIFICANCE * slopeError) slope = 0;
+  
+  float expectedChange = fabs(slope) * interval / 1000.0;
+  boolean movingAway = (slope > 0) == (error > 0);
+  
+  unsigned long next = interval;
+  
+  // NOTE: Halving lands above SAMPLER_QUIET_CHANGE and growing below the halving thresholds, so a steady slope holds one interval
+  if (expectedChange > SAMPLER_FAST_CHANGE || (movingAway && expectedChange > SAMPLER_FAST_CHANGE / 2)) next = interval / 2;
+  else if (expectedChange < SAMPLER_QUIET_CHANGE && _holdSamples == 0) next = interval + interval / 4;
+  
+  next = bounded(next, minimum, maximum);
+  if (next == interval) return false;
+  
+  if (next > interval) _holdSamples = SAMPLER_HOLD_SAMPLES;
+  
+  interval = next;
+  changeCount++;
+  
+  return true;
+}
+
+void AdaptiveSampler::reset(uint64_t nowMillis) {
+  
+  sampleCount = 0;
+  changeCount = 0;
+  _resetAt = nowMillis;
+}
+
+void AdaptiveSampler::fillReport(SamplingReport *report, uint64_t nowMillis) {
+  
+  uint64_t elapsed = nowMillis - _resetAt;
+  
+  report->interval = interval;
+  report->minimum = minimum / 1000;
+  report->maximum = maximum / 1000;
+  report->changeCount = changeCount;
+  report->sampleCount = sampleCount;
+  report->fixedRateSampleCount = elapsed / SAMPLING_INTERVAL;
+  report->elapsed = elapsed / 1000;
+}
@@ -0,0 +1,71 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef AdaptiveSampler_h
+#define AdaptiveSampler_h
+
+#include "Arduino.h"
+#include "constants.h"
+
+#define SAMPLER_HOLD_SAMPLES 3  // After growing the interval, before it can grow again
+#define SAMPLER_SLOPE_SIGNIFICANCE 2.0  // Standard errors a slope must clear to count
+
+#define SAMPLING_COMMAND_RESET 0  // Written to the Diagnostics Report after DIAGNOSTICS_REPORT_SAMPLING
+#define SAMPLING_COMMAND_REPORT 1
+
+// Notified once after SAMPLING_COMMAND_REPORT
+// NOTE: 1 - sampleCount / fixedRateSampleCount is the share of sensor reads and control cycles saved
+typedef struct __attribute__((packed)) {
+  
+  uint16_t interval;  // ms, current
+  uint8_t minimum;  // s, bounds in force
+  uint8_t maximum;  // s
+  uint16_t changeCount;  // Interval changes since the reset
+  uint32_t sampleCount;  // Control cycles since the reset
+  uint32_t fixedRateSampleCount;  // Those SAMPLING_INTERVAL would have taken over the same time
+  uint32_t elapsed;  // s since the reset
+  
+} SamplingReport;
+
+
+// Adaptive Sampler
+// -------------------------------------------------
+// Sampling interval that follows how fast venting necessity is moving.  Each sample the
+//   windowed slope is turned into the change expected over one interval: below
+//   SAMPLER_QUIET_CHANGE the interval grows by a quarter, above SAMPLER_FAST_CHANGE, or half
+//   of it while carrying the error further from the setpoint, it halves.  So it
+//   backs off slowly through a steady night and catches up within a few samples of a ramp.
+// NOTE: Both thresholds are in venting necessity per sample, the interval settles where the
+//   necessity moves by about the same amount each time, whatever the weather
+
+// Class Definition
+class AdaptiveSampler {
+  
+  public:
+    AdaptiveSampler(void);
+    
+    void begin(unsigned long interval, uint64_t nowMillis);
+    void setBounds(unsigned long minimum, unsigned long maximum);  // ms, maximum is raised to minimum if below it
+    boolean update(float slope, float slopeError, float error);  // Once per sample, slope per second, true if the interval changed
+    
+    void reset(uint64_t nowMillis);
+    void fillReport(SamplingReport *report, uint64_t nowMillis);
+    
+    unsigned long interval;  // ms
+    unsigned long minimum;  // ms
+    unsigned long maximum;  // ms
+    
+    // Since the reset
+    uint32_t sampleCount;
+    uint16_t changeCount;
+  
+  private:
+    uint64_t _resetAt;  // ms
+    uint8_t _holdSamples;  // Left before the interval may grow
+};
+
+#endif
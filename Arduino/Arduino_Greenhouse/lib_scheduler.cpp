@@ -0,0 +1,152 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_scheduler.h"
+#include "lib_hal.h"
+
+// NOTE: Ticks come from the 64-bit monotonic clock, which doesn't wrap, so they compare directly
+
+TaskScheduler::TaskScheduler(void) {
+  
+  taskCount = 0;
+}
+
+uint8_t TaskScheduler::addTask(TaskFn taskFn, unsigned long period, unsigned long phase, unsigned long deadline) {
+  
+  if (taskCount == SCHEDULER_MAX_TASKS) return SCHEDULER_INVALID_TASK;
+  
+  ScheduledTask *newTask = &_tasks[taskCount];
+  
+  newTask->taskFn = taskFn;
+  newTask->period = period;
+  newTask->deadline = deadline;
+  newTask->nextRelease = phase;  // Made relative to start()
+  newTask->enabled = true;
+  
+  newTask->lastExecutionTime = 0;
+  newTask->worstCaseExecutionTime = 0;
+  newTask->runCount = 0;
+  newTask->overrunCount = 0;
+  
+  return taskCount++;
+}
+
+void TaskScheduler::setTaskPeriod(uint8_t taskID, unsigned long period) {
+  
+  if (taskID >= taskCount) return;
+  
+  // Move the pending release too, so it keeps its phase within the cycle it was released from
+  // NOTE: A running task's release is rescheduled from the new period once it returns anyway
+  ScheduledTask *aTask = &_tasks[taskID];
+  aTask->nextRelease = aTask->nextRelease - aTask->period + period;
+  aTask->period = period;
+}
+
+void TaskScheduler::setTaskDeadline(uint8_t taskID, unsigned long deadline) {
+  
+  if (taskID < taskCount) _tasks[taskID].deadline = deadline;
+}
+
+void TaskScheduler::setTaskEnabled(uint8_t taskID, boolean enabled) {
+  
+  if (taskID < taskCount) _tasks[taskID].enabled = enabled;
+}
+
+void TaskScheduler::start(uint64_t now) {
+  
+  // Phases were stored as offsets, anchor them to the current tick
+  for (uint8_t i = 0; i < taskCount; i++) _tasks[i].nextRelease += now;
+}
+
+boolean TaskScheduler::runNextDueTask(uint64_t now) {
+  
+  ScheduledTask *dueTask = NULL;
+  
+  // Of the tasks that are due, run the one whose deadline comes first
+  for (uint8_t i = 0; i < taskCount; i++) {
+    
+    ScheduledTask *aTask = &_tasks[i];
+    
+    if (aTask->enabled && now >= aTask->nextRelease) {
+      
+      if (dueTask == NULL || aTask->nextRelease + aTask->deadline < dueTask->nextRelease + dueTask->deadline) dueTask = aTask;
+    }
+  }
+  
+  if (dueTask == NULL) return false;
+  
+  uint64_t release = dueTask->nextRelease;
+  unsigned long startMicros = micros();
+  
+  dueTask->taskFn();
+  
+  unsigned long executionTime = micros() - startMicros;
+  uint64_t finished = hal_millis64();
+  
+  dueTask->lastExecutionTime = executionTime;
+  if (executionTime > dueTask->worstCaseExecutionTime) dueTask->worstCaseExecutionTime = executionTime;
+  dueTask->runCount++;
+  
+  if ((finished - release) > dueTask->deadline) dueTask->overrunCount++;
+  
+  // Schedule the next release on the original grid, skipping any we've already missed
+  dueTask->nextRelease = release + dueTask->period;
+  while (finished >= dueTask->nextRelease + dueTask->period) {
+    
+    dueTask->nextRelease += dueTask->period;
+    dueTask->overrunCount++;
+  }
+  
+  return true;
+}
+
+unsigned long TaskScheduler::millisUntilNextTask(uint64_t now) {
+  
+  unsigned long soonest = 0xFFFFFFFF;
+  
+  for (uint8_t i = 0; i < taskCount; i++) {
+    
+    if (!_tasks[i].enabled) continue;
+    if (now >= _tasks[i].nextRelease) return 0;
+    
+    uint64_t untilRelease = _tasks[i].nextRelease - now;
+    if (untilRelease < soonest) soonest = (unsigned long) untilRelease;
+  }
+  
+  return soonest;
+}
+
+ScheduledTask *TaskScheduler::task(uint8_t taskID) {
+  
+  return (taskID < taskCount) ? &_tasks[taskID] : NULL;
+}
+
+void TaskScheduler::resetStatistics(void) {
+  
+  for (uint8_t i = 0; i < taskCount; i++) {
+    
+    _tasks[i].worstCaseExecutionTime = 0;
+    _tasks[i].runCount = 0;
+    _tasks[i].overrunCount = 0;
+  }
+}
+
+void TaskScheduler::printStatistics(void) {
+  
+  for (uint8_t i = 0; i < taskCount; i++) {
+    
+    Serial.print(F("Task "));
+    Serial.print(i);
+    Serial.print(F(": runs="));
+    Serial.print(_tasks[i].runCount);
+    Serial.print(F(", WCET="));
+    Serial.print(_tasks[i].worstCaseExecutionTime);
+    Serial.print(F(" us, overruns="));
+    Serial.println(_tasks[i].overrunCount);
+  }
+}
@@ -0,0 +1,59 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef TaskScheduler_h
+#define TaskScheduler_h
+
+#define SCHEDULER_MAX_TASKS 8
+#define SCHEDULER_INVALID_TASK 0xFF
+
+typedef void (*TaskFn)(void);
+
+typedef struct {
+  
+  TaskFn taskFn;
+  
+  unsigned long period;  // ms
+  unsigned long deadline;  // ms after release by which the task should have finished
+  uint64_t nextRelease;  // ms, hal_millis64() at which the task next becomes due
+  boolean enabled;
+  
+  unsigned long lastExecutionTime;  // µs
+  unsigned long worstCaseExecutionTime;  // µs
+  unsigned int runCount;
+  unsigned int overrunCount;  // Deadlines missed, including releases skipped entirely
+  
+} ScheduledTask;
+
+
+// Class Definition
+// NOTE: Cooperative, tasks run to completion one at a time from loop()
+class TaskScheduler {
+  
+  public:
+    TaskScheduler(void);
+    
+    uint8_t addTask(TaskFn taskFn, unsigned long period, unsigned long phase, unsigned long deadline);  // Returns task ID
+    void setTaskPeriod(uint8_t taskID, unsigned long period);  // From the next release, taken from the last one
+    void setTaskDeadline(uint8_t taskID, unsigned long deadline);
+    void setTaskEnabled(uint8_t taskID, boolean enabled);
+    
+    void start(uint64_t now);  // now from hal_millis64(), as for the two below
+    boolean runNextDueTask(uint64_t now);  // Returns true if a task was run
+    unsigned long millisUntilNextTask(uint64_t now);
+    
+    ScheduledTask *task(uint8_t taskID);
+    void resetStatistics(void);
+    void printStatistics(void);
+    
+    uint8_t taskCount;
+    
+  private:
+    ScheduledTask _tasks[SCHEDULER_MAX_TASKS];
+};
+
+#endif
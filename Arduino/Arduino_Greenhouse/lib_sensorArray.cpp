@@ -0,0 +1,156 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_hal.h"
+#include "lib_sensorArray.h"
+
+static control_t meanOf(control_t sum, uint8_t count) {
+
+#ifdef GREENHOUSE_FIXED_POINT
+  return Fixed::fromRaw(sum.raw / count);
+#else
+  return sum / count;
+#endif
+}
+
+SensorArray::SensorArray(void) {
+  
+  channelCount = 0;
+  shiftRegisterState = 0;
+  _allOutputs = 0;
+  
+  scanning = false;
+  readCount = 0;
+  failedReads = 0;
+  
+  _transaction.status = TwiStatusOK;
+  _scanDone = NULL;
+}
+
+void SensorArray::begin(uint8_t latchPin, uint8_t dataPin, uint8_t clockPin) {
+  
+  _latchPin = latchPin;
+  _dataPin = dataPin;
+  _clockPin = clockPin;
+  
+  pinMode(_latchPin, OUTPUT);
+  pinMode(_dataPin, OUTPUT);
+  pinMode(_clockPin, OUTPUT);
+  
+  _enableOutputs(_allOutputs);
+  twiBus.begin();
+}
+
+uint8_t SensorArray::addChannel(uint8_t output) {
+  
+  if (channelCount == SENSOR_CHANNEL_COUNT) return SENSOR_ARRAY_INVALID_CHANNEL;
+  
+  _outputs[channelCount] = output;
+  _allOutputs |= output;
+  
+  return channelCount++;
+}
+
+boolean SensorArray::startConversions(void) {
+  
+  // NOTE: Every line is left enabled between scans, so the sensors are already listening
+  if (scanning) return false;
+  return HIH6100_Sensor::requestMeasurement(&_transaction, NULL, this);
+}
+
+boolean SensorArray::fetchResults(SensorScanHandler done) {
+  
+  if (scanning || channelCount == 0) return false;
+  
+  scanning = true;
+  readCount = 0;
+  _scanDone = done;
+  
+  _fetchChannel(0);
+  return true;
+}
+
+void SensorArray::_fetchChannel(uint8_t channel) {
+  
+  _fetchingChannel = channel;
+  _enableOutputs(_outputs[channel]);
+  
+  if (HIH6100_Sensor::requestResult(&_transaction, _resultFetched, this)) return;
+  
+  // The request is still stuck on the bus, it'll time out, nothing more is read this scan
+  for (; channel < channelCount; channel++) channels[channel].state = HIH6100StateNoResponse;
+  failedReads += channelCount - _fetchingChannel;
+  
+  _finishScan();
+}
+
+// NOTE: From TwiBus::loop()
+void SensorArray::_resultFetched(TwiTransaction *transaction) {
+  
+  SensorArray *array = (SensorArray *) transaction->context;
+  HIH6100_Sensor *sensor = &array->channels[array->_fetchingChannel];
+  
+  if (sensor->decodeResult(transaction)) array->readCount++;
+  else if (sensor->state == HIH6100StateNoResponse) array->failedReads++;
+  
+  if (array->_fetchingChannel + 1 < array->channelCount) array->_fetchChannel(array->_fetchingChannel + 1);
+  else array->_finishScan();
+}
+
+void SensorArray::_finishScan(void) {
+  
+  // Ready for the next scan's shared request
+  _enableOutputs(_allOutputs);
+  scanning = false;
+  
+  if (_scanDone) _scanDone();
+}
+
+boolean SensorArray::aggregate(uint8_t firstChannel, uint8_t count, SensorAggregate *humidity, SensorAggregate *temperature) {
+  
+  control_t humiditySum = 0, temperatureSum = 0;
+  uint8_t included = 0;
+  
+  for (uint8_t i = firstChannel; i < firstChannel + count && i < channelCount; i++) {
+    
+    // A stale result is the last conversion's, still a reading, the rest are faults
+    HIH6100_Sensor *sensor = &channels[i];
+    if (sensor->state != HIH6100StateNormal && sensor->state != HIH6100StateStale) continue;
+    
+    if (included == 0) {
+      
+      humidity->minimum = humidity->maximum = sensor->humidity;
+      temperature->minimum = temperature->maximum = sensor->temperature;
+      
+    } else {
+      
+      if (sensor->humidity < humidity->minimum) humidity->minimum = sensor->humidity;
+      if (sensor->humidity > humidity->maximum) humidity->maximum = sensor->humidity;
+      if (sensor->temperature < temperature->minimum) temperature->minimum = sensor->temperature;
+      if (sensor->temperature > temperature->maximum) temperature->maximum = sensor->temperature;
+    }
+    
+    humiditySum += sensor->humidity;
+    temperatureSum += sensor->temperature;
+    included++;
+  }
+  
+  if (included == 0) return false;
+  
+  humidity->mean = meanOf(humiditySum, included);
+  temperature->mean = meanOf(temperatureSum, included);
+  
+  return true;
+}
+
+void SensorArray::_enableOutputs(uint8_t outputs) {
+  
+  // The transistors switching each sensor's SDA line are driven by the shift register's outputs
+  hal_shiftRegisterWrite(_latchPin, _dataPin, _clockPin, outputs);
+  shiftRegisterState = outputs;
+}
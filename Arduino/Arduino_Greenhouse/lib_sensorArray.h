@@ -0,0 +1,75 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef SensorArray_h
+#define SensorArray_h
+
+#include "Arduino.h"
+#include "constants.h"
+#include "lib_hih6100.h"
+
+#define SENSOR_ARRAY_INVALID_CHANNEL 0xFF
+
+typedef void (*SensorScanHandler)(void);
+
+// Lowest, mean and highest of a reading over a group of channels
+typedef struct {
+  
+  control_t minimum;
+  control_t mean;
+  control_t maximum;
+  
+} SensorAggregate;
+
+
+// Sensor Array
+// -------------------------------------------------
+// HIH6100s whose SDA lines are each switched by one output of an 8-bit shift register.
+// NOTE: They all answer at one I2C address, so a single Measurement Request with every line
+//   enabled starts all of their conversions together.  Only the 4-byte fetches, ~0.1ms each,
+//   are made one channel at a time, so a scan takes one conversion time however many there are.
+//   Each fetch is queued on twiBus from the last one's callback, after switching the lines over.
+
+// Class Definition
+class SensorArray {
+  
+  public:
+    SensorArray(void);
+    
+    void begin(uint8_t latchPin, uint8_t dataPin, uint8_t clockPin);
+    uint8_t addChannel(uint8_t output);  // Shift register output bit, returns the channel number
+    
+    boolean startConversions(void);  // false if the bus is still busy with the last scan
+    boolean fetchResults(SensorScanHandler done);  // No sooner than HIH6100_CONVERSION_TIME after, done() once all are
+    
+    // Over the channels from firstChannel that read, false leaves both as they were when none did
+    boolean aggregate(uint8_t firstChannel, uint8_t count, SensorAggregate *humidity, SensorAggregate *temperature);
+    
+    HIH6100_Sensor channels[SENSOR_CHANNEL_COUNT];
+    uint8_t channelCount;
+    uint8_t shiftRegisterState;  // Outputs last enabled
+    
+    boolean scanning;  // Between fetchResults() and its done()
+    uint8_t readCount;  // Channels with a fresh reading in the last scan
+    unsigned long failedReads;  // Fetches the bus couldn't complete, since begin()
+  
+  private:
+    static void _resultFetched(TwiTransaction *transaction);
+    void _fetchChannel(uint8_t channel);
+    void _finishScan(void);
+    void _enableOutputs(uint8_t outputs);
+    
+    TwiTransaction _transaction;  // The request, then each channel's fetch in turn
+    uint8_t _fetchingChannel;
+    SensorScanHandler _scanDone;
+    
+    uint8_t _outputs[SENSOR_CHANNEL_COUNT];
+    uint8_t _allOutputs;
+    uint8_t _latchPin, _dataPin, _clockPin;
+};
+
+#endif
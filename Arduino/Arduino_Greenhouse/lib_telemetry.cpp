@@ -0,0 +1,86 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_telemetry.h"
+
+TelemetrySnapshot::TelemetrySnapshot(void) {
+  
+  frame.version = TELEMETRY_FRAME_VERSION;
+  frame.sequence = 0;
+  frame.timestamp = 0;
+  
+  frame.exteriorHumidity = TELEMETRY_VALUE_UNAVAILABLE;
+  frame.exteriorTemperature = TELEMETRY_VALUE_UNAVAILABLE;
+  frame.interiorHumidity = TELEMETRY_VALUE_UNAVAILABLE;
+  frame.interiorTemperature = TELEMETRY_VALUE_UNAVAILABLE;
+  
+  frame.ventingNecessity = TELEMETRY_VALUE_UNAVAILABLE;
+  frame.ventingNecessityDelta = TELEMETRY_VALUE_UNAVAILABLE;
+  frame.ventServoPosition = 0;
+  
+  frame.flags = 0;
+}
+
+void TelemetrySnapshot::recordExterior(float humidity, float temperature) {
+  
+  frame.exteriorHumidity = _encode(humidity, TELEMETRY_HUMIDITY_SCALE);
+  frame.exteriorTemperature = _encode(temperature, TELEMETRY_TEMPERATURE_SCALE);
+}
+
+void TelemetrySnapshot::recordInterior(float humidity, float temperature) {
+  
+  frame.interiorHumidity = _encode(humidity, TELEMETRY_HUMIDITY_SCALE);
+  frame.interiorTemperature = _encode(temperature, TELEMETRY_TEMPERATURE_SCALE);
+}
+
+void TelemetrySnapshot::recordVenting(float necessity, float necessityDelta, uint8_t servoPosition) {
+  
+  frame.ventingNecessity = _encode(necessity, TELEMETRY_NECESSITY_SCALE);
+  frame.ventingNecessityDelta = _encode(necessityDelta, TELEMETRY_NECESSITY_DELTA_SCALE);
+  frame.ventServoPosition = servoPosition;
+}
+
+void TelemetrySnapshot::recordLightBanks(boolean bank1On, boolean bank2On) {
+  
+  frame.flags &= ~(TELEMETRY_FLAG_LIGHT_BANK_1 | TELEMETRY_FLAG_LIGHT_BANK_2);
+  
+  if (bank1On) frame.flags |= TELEMETRY_FLAG_LIGHT_BANK_1;
+  if (bank2On) frame.flags |= TELEMETRY_FLAG_LIGHT_BANK_2;
+}
+
+void TelemetrySnapshot::recordConfigPending(boolean pending) {
+  
+  if (pending) frame.flags |= TELEMETRY_FLAG_CONFIG_PENDING;
+  else frame.flags &= ~TELEMETRY_FLAG_CONFIG_PENDING;
+}
+
+void TelemetrySnapshot::recordClimateState(uint8_t state) {
+  
+  frame.flags &= ~TELEMETRY_FLAGS_CLIMATE_STATE;
+  frame.flags |= (state << TELEMETRY_CLIMATE_STATE_SHIFT) & TELEMETRY_FLAGS_CLIMATE_STATE;
+}
+
+TelemetryFrame *TelemetrySnapshot::stampFrame(unsigned long timestamp) {
+  
+  frame.sequence++;
+  frame.timestamp = timestamp;
+  
+  return &frame;
+}
+
+int16_t TelemetrySnapshot::_encode(float value, float scale) {
+  
+  if (value == UNAVAILABLE_f) return TELEMETRY_VALUE_UNAVAILABLE;
+  
+  float scaled = value * scale;
+  
+  // Clamp rather than wrap, keeping TELEMETRY_VALUE_UNAVAILABLE reserved
+  if (scaled >= 32767.0) return 32767;
+  else if (scaled <= -32767.0) return -32767;
+  else return (int16_t) (scaled + ((scaled >= 0) ? 0.5 : -0.5));
+}
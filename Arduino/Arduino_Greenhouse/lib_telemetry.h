@@ -0,0 +1,70 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef TelemetrySnapshot_h
+#define TelemetrySnapshot_h
+
+#include "constants.h"
+
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_VALUE_UNAVAILABLE -32768  // Sent in place of any value that is UNAVAILABLE_f
+
+#define TELEMETRY_HUMIDITY_SCALE 100.0  // 0.01 % RH per count
+#define TELEMETRY_TEMPERATURE_SCALE 100.0  // 0.01 °C per count
+#define TELEMETRY_NECESSITY_SCALE 10.0  // 0.1 per count
+#define TELEMETRY_NECESSITY_DELTA_SCALE 1000.0  // 0.001 per second per count
+
+#define TELEMETRY_FLAG_LIGHT_BANK_1 B00000001
+#define TELEMETRY_FLAG_LIGHT_BANK_2 B00000010
+#define TELEMETRY_FLAG_CONFIG_PENDING B00000100  // Configuration edits not yet committed to EEPROM
+#define TELEMETRY_FLAGS_CLIMATE_STATE B00111000  // ClimateState, shifted by TELEMETRY_CLIMATE_STATE_SHIFT
+#define TELEMETRY_CLIMATE_STATE_SHIFT 3
+
+// One consistent snapshot of every per-cycle value, sized to fit a single 20-byte packet
+// NOTE: Multi-byte fields are little-endian, as laid out by the AVR
+typedef struct __attribute__((packed)) {
+  
+  uint8_t version;  // TELEMETRY_FRAME_VERSION
+  uint8_t sequence;  // Increments once per frame, wraps
+  uint32_t timestamp;  // ms since boot
+  
+  int16_t exteriorHumidity;
+  int16_t exteriorTemperature;
+  int16_t interiorHumidity;
+  int16_t interiorTemperature;
+  
+  int16_t ventingNecessity;
+  int16_t ventingNecessityDelta;
+  uint8_t ventServoPosition;  // servo angle
+  
+  uint8_t flags;
+  
+} TelemetryFrame;
+
+
+// Class Definition
+class TelemetrySnapshot {
+  
+  public:
+    TelemetrySnapshot(void);
+    
+    void recordExterior(float humidity, float temperature);
+    void recordInterior(float humidity, float temperature);
+    void recordVenting(float necessity, float necessityDelta, uint8_t servoPosition);
+    void recordLightBanks(boolean bank1On, boolean bank2On);
+    void recordConfigPending(boolean pending);
+    void recordClimateState(uint8_t state);
+    
+    TelemetryFrame *stampFrame(unsigned long timestamp);  // Assigns the next sequence number
+    
+    TelemetryFrame frame;
+    
+  private:
+    int16_t _encode(float value, float scale);
+};
+
+#endif
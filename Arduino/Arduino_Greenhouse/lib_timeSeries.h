@@ -8,33 +8,198 @@
 #ifndef TimeSeries_h
 #define TimeSeries_h
 
+#include "Arduino.h"
 #include <Time.h>
 #include "constants.h"
+#include "lib_hal.h"
 
 #define CIRC_BUFFER_DEPTH 6
 
 
 // Class Definition
+// -------------------------------------------------
+// A fixed-depth window of timestamped measurements.  Running sums are updated as values
+//   enter and leave the window, so the mean, variance and least-squares slope cost the
+//   same few float operations however deep the window is.
+// NOTE: Times are kept relative to an origin inside the window so the sums stay small
+//   enough for a 32-bit float.  The sums are rebuilt from the buffer, and the origin moved
+//   up to the oldest measurement, once every Depth additions so rounding can't accumulate.
+//   The origin is a hal_millis64() time, so only the offsets need 32 bits: a window may span
+//   up to ~49 days whenever it was taken.
+template <uint8_t Depth>
 class TimeSeries {
   
   public:
     TimeSeries(void);
     
     void addValue(float newValue);
+    void addValue(float newValue, uint64_t time);  // time in ms, from hal_millis64() unless testing
     void clearAll();
     
     float averageValue();
-    float averageSlope();
+    float variance();
+    float averageSlope();  // per second, least-squares fit over the window
+    float slopeError();  // per second, standard error of averageSlope() from the scatter about the fit
     
     uint8_t measurementCount;
-    
-  private:
-    float _average(float values[], uint8_t startingIndex, uint8_t length);
   
-    float _measurements[CIRC_BUFFER_DEPTH];
-    uint16_t _timeDeltas[CIRC_BUFFER_DEPTH];
-    uint8_t _bufferIndex;
-    unsigned long _lastMeasurementTime;
+  private:
+    float _secondsSinceOrigin(uint32_t offset);
+    void _rebuildSums(void);
+    
+    float _measurements[Depth];
+    uint32_t _offsets[Depth];  // ms after _origin
+    uint8_t _bufferIndex;  // Next slot to write, the oldest measurement once the window is full
+    uint8_t _additionsSinceRebuild;
+    
+    uint64_t _origin;  // ms
+    float _sumT, _sumV, _sumTV, _sumTT, _sumVV;
 };
 
+
+// Class Implementation
+// -------------------------------------------------
+template <uint8_t Depth>
+TimeSeries<Depth>::TimeSeries() {
+  
+  clearAll();
+}
+
+template <uint8_t Depth>
+void TimeSeries<Depth>::clearAll() {
+  
+  _bufferIndex = 0;
+  _additionsSinceRebuild = 0;
+  measurementCount = 0;
+  
+  _sumT = _sumV = _sumTV = _sumTT = _sumVV = 0;
+}
+
+template <uint8_t Depth>
+void TimeSeries<Depth>::addValue(float newValue) {
+  
+  addValue(newValue, hal_millis64());
+}
+
+template <uint8_t Depth>
+void TimeSeries<Depth>::addValue(float newValue, uint64_t time) {
+  
+  if (measurementCount == 0) _origin = time;
+  
+  if (measurementCount == Depth) {
+    
+    // Evict the oldest measurement, which the new one overwrites
+    float t = _secondsSinceOrigin(_offsets[_bufferIndex]);
+    float v = _measurements[_bufferIndex];
+    
+    _sumT -= t;
+    _sumV -= v;
+    _sumTV -= t * v;
+    _sumTT -= t * t;
+    _sumVV -= v * v;
+    
+  } else measurementCount++;
+  
+  // Record the measurement
+  uint32_t offset = (uint32_t) (time - _origin);
+  
+  _measurements[_bufferIndex] = newValue;
+  _offsets[_bufferIndex] = offset;
+  
+  // Move the index forward, circularly
+  if (++_bufferIndex == Depth) _bufferIndex = 0;
+  
+  if (++_additionsSinceRebuild == Depth) _rebuildSums();
+  else {
+    
+    float t = _secondsSinceOrigin(offset);
+    
+    _sumT += t;
+    _sumV += newValue;
+    _sumTV += t * newValue;
+    _sumTT += t * t;
+    _sumVV += newValue * newValue;
+  }
+}
+
+template <uint8_t Depth>
+float TimeSeries<Depth>::averageValue() {
+  
+  if (measurementCount == 0) return UNAVAILABLE_f;
+  else return _sumV / measurementCount;
+}
+
+template <uint8_t Depth>
+float TimeSeries<Depth>::variance() {
+  
+  if (measurementCount < 2) return UNAVAILABLE_f;
+  
+  float sumOfSquares = _sumVV - (_sumV * _sumV) / measurementCount;
+  return (sumOfSquares > 0) ? sumOfSquares / (measurementCount - 1) : 0;  // Rounding can dip just below zero
+}
+
+template <uint8_t Depth>
+float TimeSeries<Depth>::averageSlope() {
+  
+  if (measurementCount < 2) return UNAVAILABLE_f;
+  
+  // Centred sums, Sxy / Sxx
+  float meanT = _sumT / measurementCount;
+  float spreadT = _sumTT - (_sumT * meanT);
+  
+  if (spreadT <= 0) return UNAVAILABLE_f;  // Every measurement at the same time
+  else return (_sumTV - (meanT * _sumV)) / spreadT;
+}
+
+template <uint8_t Depth>
+float TimeSeries<Depth>::slopeError() {
+  
+  if (measurementCount < 3) return UNAVAILABLE_f;
+  
+  float meanT = _sumT / measurementCount;
+  float spreadT = _sumTT - (_sumT * meanT);
+  
+  if (spreadT <= 0) return UNAVAILABLE_f;
+  
+  // Residual sum of squares, Syy - Sxy^2 / Sxx
+  float spreadTV = _sumTV - (meanT * _sumV);
+  float residual = _sumVV - (_sumV * _sumV) / measurementCount - (spreadTV * spreadTV) / spreadT;
+  if (residual < 0) residual = 0;  // Rounding, on a perfect line
+  
+  return sqrt(residual / (measurementCount - 2) / spreadT);
+}
+
+template <uint8_t Depth>
+float TimeSeries<Depth>::_secondsSinceOrigin(uint32_t offset) {
+  
+  return (float) offset / 1e3f;
+}
+
+template <uint8_t Depth>
+void TimeSeries<Depth>::_rebuildSums(void) {
+  
+  // Oldest measurement sits at the write index once the window is full, otherwise at 0
+  uint8_t oldestIndex = (measurementCount == Depth) ? _bufferIndex : 0;
+  uint32_t shift = _offsets[oldestIndex];
+  
+  _origin += shift;
+  _additionsSinceRebuild = 0;
+  
+  _sumT = _sumV = _sumTV = _sumTT = _sumVV = 0;
+  
+  for (uint8_t i = 0; i < measurementCount; i++) {
+    
+    _offsets[i] -= shift;
+    
+    float t = _secondsSinceOrigin(_offsets[i]);
+    float v = _measurements[i];
+    
+    _sumT += t;
+    _sumV += v;
+    _sumTV += t * v;
+    _sumTT += t * t;
+    _sumVV += v * v;
+  }
+}
+
 #endif
@@ -0,0 +1,128 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_twi.h"
+
+// Ring of queued transactions, oldest first: those finished and waiting for their callback,
+//   then the one on the bus, then the rest
+// NOTE: Shared with the TWI interrupt, loop() and queue() change it with interrupts off
+static TwiTransaction *queueSlots[TWI_QUEUE_DEPTH];
+static volatile uint8_t oldestSlot = 0;
+static volatile uint8_t queuedCount = 0;
+static volatile uint8_t finishedCount = 0;
+static volatile boolean busBusy = false;
+
+TwiBus::TwiBus(void) {
+  
+  errorCount = 0;
+  timeoutCount = 0;
+}
+
+void TwiBus::begin(void) {
+  
+  hal_twiBegin(TWI_FREQUENCY, _transferDone);
+}
+
+boolean TwiBus::queue(TwiTransaction *transaction) {
+  
+  noInterrupts();
+  
+  if (queuedCount == TWI_QUEUE_DEPTH || transaction->status == TwiStatusPending) {
+    
+    interrupts();
+    return false;
+  }
+  
+  transaction->status = TwiStatusPending;
+  transaction->byteCount = 0;
+  queueSlots[(oldestSlot + queuedCount) % TWI_QUEUE_DEPTH] = transaction;
+  queuedCount++;
+  
+  if (!busBusy) _startNext();
+  
+  interrupts();
+  return true;
+}
+
+void TwiBus::loop(void) {
+  
+  // Give up on a transfer that never ended, a sensor holding SDA low or stretching SCL forever
+  noInterrupts();
+  
+  if (busBusy) {
+    
+    TwiTransaction *transaction = queueSlots[(oldestSlot + finishedCount) % TWI_QUEUE_DEPTH];
+    
+    if (millis() - transaction->startedAt >= transaction->timeout) {
+      
+      hal_twiReset();
+      busBusy = false;
+      
+      transaction->status = TwiStatusTimedOut;
+      finishedCount++;
+      timeoutCount++;
+      
+      _startNext();
+    }
+  }
+  
+  interrupts();
+  
+  // Callbacks, with the slot already free so they can queue the next transfer
+  while (true) {
+    
+    noInterrupts();
+    
+    if (finishedCount == 0) {
+      
+      interrupts();
+      break;
+    }
+    
+    TwiTransaction *transaction = queueSlots[oldestSlot];
+    oldestSlot = (oldestSlot + 1) % TWI_QUEUE_DEPTH;
+    queuedCount--;
+    finishedCount--;
+    
+    interrupts();
+    
+    if (transaction->status != TwiStatusOK) errorCount++;
+    if (transaction->callback) transaction->callback(transaction);
+  }
+}
+
+boolean TwiBus::idle(void) {
+  
+  return queuedCount == 0;
+}
+
+// NOTE: From the TWI interrupt
+void TwiBus::_transferDone(HalTwiResult result, uint8_t byteCount) {
+  
+  TwiTransaction *transaction = queueSlots[(oldestSlot + finishedCount) % TWI_QUEUE_DEPTH];
+  
+  transaction->status = result;
+  transaction->byteCount = byteCount;
+  finishedCount++;
+  busBusy = false;
+  
+  _startNext();
+}
+
+// NOTE: With interrupts off, or from the TWI interrupt
+void TwiBus::_startNext(void) {
+  
+  if (finishedCount == queuedCount) return;
+  
+  TwiTransaction *transaction = queueSlots[(oldestSlot + finishedCount) % TWI_QUEUE_DEPTH];
+  
+  transaction->startedAt = millis();
+  busBusy = true;
+  
+  hal_twiStart(transaction->address, transaction->data, transaction->writeLength, transaction->readLength);
+}
@@ -0,0 +1,78 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef TwiBus_h
+#define TwiBus_h
+
+#include "Arduino.h"
+#include "lib_hal.h"
+
+#define TWI_FREQUENCY 400000UL  // Hz, HIH6100s take fast mode
+#define TWI_QUEUE_DEPTH 4  // Transactions waiting or in progress
+#define TWI_DATA_LENGTH 4  // bytes, an HIH6100 result is the largest transfer
+#define TWI_DEFAULT_TIMEOUT 10  // ms, a 4-byte read takes ~0.1ms at 400kHz
+
+enum TwiStatus {
+  
+  TwiStatusOK = HalTwiOK,
+  TwiStatusAddressNack = HalTwiAddressNack,
+  TwiStatusDataNack = HalTwiDataNack,
+  TwiStatusBusError = HalTwiBusError,
+  TwiStatusTimedOut,  // Abandoned after its timeout, the bus was reset
+  TwiStatusPending  // Queued or on the bus
+  
+};
+
+struct TwiTransaction;
+typedef void (*TwiCallback)(struct TwiTransaction *transaction);
+
+// One transfer, owned by the caller and left alone from queue() until its callback
+typedef struct TwiTransaction {
+  
+  uint8_t address;  // 7-bit
+  uint8_t writeLength;  // bytes of data sent...
+  uint8_t readLength;  // ...then read back into data after a repeated start
+  uint8_t data[TWI_DATA_LENGTH];
+  uint16_t timeout;  // ms from reaching the bus
+  
+  TwiCallback callback;  // From TwiBus::loop(), never the interrupt, may be NULL
+  void *context;
+  
+  volatile uint8_t status;  // TwiStatus
+  volatile uint8_t byteCount;  // Transferred before it ended
+  unsigned long startedAt;  // ms
+  
+} TwiTransaction;
+
+
+// TWI Bus
+// -------------------------------------------------
+// Queue of I2C transactions run back to back from the TWI interrupt, so the CPU is free while
+//   the bus is busy.  Callbacks are run from loop(), in the order the transactions were queued.
+
+// Class Definition
+class TwiBus {
+  
+  public:
+    TwiBus(void);
+    
+    void begin(void);
+    boolean queue(TwiTransaction *transaction);  // false if the queue is full or it's already pending
+    void loop(void);  // Runs callbacks and times out a stuck transfer, call every loop()
+    boolean idle(void);  // Nothing queued, on the bus or waiting for its callback
+    
+    unsigned long errorCount;  // Transactions that didn't end TwiStatusOK
+    unsigned long timeoutCount;
+  
+  private:
+    static void _transferDone(HalTwiResult result, uint8_t byteCount);
+    static void _startNext(void);
+};
+
+extern TwiBus twiBus;  // The sketch's, shared with the sensors on it
+
+#endif
@@ -0,0 +1,67 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_ventStrategy.h"
+
+HysteresisSwitch::HysteresisSwitch(void) {
+  
+  open = false;
+  _openAt = 0;
+  _closeAt = 0;
+}
+
+void HysteresisSwitch::begin(boolean startOpen) {
+  
+  open = startOpen;
+}
+
+void HysteresisSwitch::setLevels(control_t openAt, control_t closeAt) {
+  
+  _openAt = openAt;
+  _closeAt = (closeAt < openAt) ? closeAt : openAt;
+}
+
+boolean HysteresisSwitch::update(control_t necessity) {
+  
+  // NOTE: Inside the band the flap stays where it is, that's what keeps the actuation count down
+  if (!open && necessity >= _openAt) open = true;
+  else if (open && necessity <= _closeAt) open = false;
+  
+  return open;
+}
+
+ActuationCounter::ActuationCounter(void) {
+  
+  actuations = 0;
+  travel = 0;
+  _resetAt = 0;
+}
+
+void ActuationCounter::moved(uint8_t degrees) {
+  
+  actuations++;
+  travel += degrees;
+}
+
+void ActuationCounter::reset(uint64_t nowMillis) {
+  
+  actuations = 0;
+  travel = 0;
+  _resetAt = nowMillis;
+}
+
+void ActuationCounter::fillReport(ActuationReport *report, uint8_t strategy, uint64_t nowMillis) {
+  
+  uint64_t elapsed = nowMillis - _resetAt;
+  
+  report->strategy = strategy;
+  report->actuations = actuations;
+  report->travel = travel;
+  report->elapsed = elapsed / 1000;
+  report->actuationsPerHour = elapsed ? actuations * 3600000.0 / elapsed : 0;
+}
@@ -0,0 +1,78 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef VentStrategy_h
+#define VentStrategy_h
+
+#include "Arduino.h"
+#include "lib_fixed.h"
+
+#define ACTUATIONS_COMMAND_RESET 0  // Written to the Diagnostics Report after DIAGNOSTICS_REPORT_ACTUATIONS
+#define ACTUATIONS_COMMAND_REPORT 1
+
+enum VentStrategy {
+  
+  VentStrategyPID,  // Flap follows the PID, plus any feed-forward, every control cycle
+  VentStrategyHysteresis,  // Fully open or fully closed, switched at the necessity thresholds
+  VentStrategyCount
+  
+};
+
+// Notified once after ACTUATIONS_COMMAND_REPORT
+typedef struct __attribute__((packed)) {
+  
+  uint8_t strategy;  // VentStrategy, counts are reset when it changes
+  uint32_t actuations;  // Servo moves since the reset
+  uint32_t travel;  // degrees
+  uint32_t elapsed;  // s since the reset
+  float actuationsPerHour;
+  
+} ActuationReport;
+
+
+// Hysteresis Switch
+// -------------------------------------------------
+// Two-position control.  Opens once venting necessity reaches openAt and stays open until it has
+//   fallen to closeAt, below it, so the flap only moves when the necessity has swept the whole band.
+class HysteresisSwitch {
+  
+  public:
+    HysteresisSwitch(void);
+    
+    void begin(boolean startOpen);
+    void setLevels(control_t openAt, control_t closeAt);  // closeAt is lowered to openAt if above it
+    boolean update(control_t necessity);  // Once per control cycle, true if the flap should be open
+    
+    boolean open;
+  
+  private:
+    control_t _openAt;
+    control_t _closeAt;
+};
+
+
+// Actuation Counter
+// -------------------------------------------------
+// Servo moves and their travel, for comparing how hard the strategies work the flap.
+class ActuationCounter {
+  
+  public:
+    ActuationCounter(void);
+    
+    void moved(uint8_t degrees);
+    void reset(uint64_t nowMillis);
+    void fillReport(ActuationReport *report, uint8_t strategy, uint64_t nowMillis);
+    
+    // Since the reset
+    uint32_t actuations;
+    uint32_t travel;  // degrees
+  
+  private:
+    uint64_t _resetAt;  // ms
+};
+
+#endif
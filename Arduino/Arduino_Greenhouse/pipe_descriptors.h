@@ -0,0 +1,41 @@
+// Generated by generate_services.py from nordic_service_config.xml, don't edit
+
+#ifndef PipeDescriptors_h
+#define PipeDescriptors_h
+
+#include <stddef.h>
+#include <avr/pgmspace.h>
+#include "constants.h"
+#include "services.h"
+#include "lib_pipeDispatch.h"
+
+#define PIPE_DESCRIPTOR_COUNT 12
+
+static const PipeDescriptor pipeDescriptors[PIPE_DESCRIPTOR_COUNT] PROGMEM = {
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_SETPOINT_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_SETPOINT_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, temperatureSetpoint), PIPE_FLAG_APPLY_CONTROL, TEMPERATURE_SETPOINT_MIN, TEMPERATURE_SETPOINT_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_SETPOINT_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_SETPOINT_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, humiditySetpoint), PIPE_FLAG_APPLY_CONTROL, HUMIDITY_SETPOINT_MIN, HUMIDITY_SETPOINT_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_NECESSITY_COEFF_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_HUMIDITY_NECESSITY_COEFF_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, humidityNecessityCoeff), PIPE_FLAG_APPLY_CONTROL, NECESSITY_COEFF_MIN, NECESSITY_COEFF_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_TEMPERATURE_NECESSITY_COEFF_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, temperatureNecessityCoeff), PIPE_FLAG_APPLY_CONTROL, NECESSITY_COEFF_MIN, NECESSITY_COEFF_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_ON_TIME_SET, PipeValueInt16, 2, 1, offsetof(UserConfig, illuminationOnMinutes), PIPE_FLAG_UNBOUNDED, 0, 0 },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_SET, PipeValueInt16, 2, 1, offsetof(UserConfig, illuminationOffMinutes), PIPE_FLAG_UNBOUNDED, 0, 0 },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_SET, PipeValueUint8, 2, 2, offsetof(UserConfig, samplingMinSeconds), PIPE_FLAG_APPLY_CONTROL | PIPE_FLAG_ASCENDING, SAMPLING_BOUND_MIN, SAMPLING_BOUND_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, ventingNecessityThreshold), PIPE_FLAG_APPLY_CONTROL, NECESSITY_THRESHOLD_MIN, NECESSITY_THRESHOLD_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, ventingNecessityOvershoot), PIPE_FLAG_APPLY_CONTROL, VENTING_OVERSHOOT_MIN, VENTING_OVERSHOOT_MAX },
+  { PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_RX_ACK_AUTO, PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_SET, PipeValueFloat, 4, 1, offsetof(UserConfig, targetVentingNecessity), PIPE_FLAG_APPLY_CONTROL, TARGET_NECESSITY_MIN, TARGET_NECESSITY_MAX },
+  { PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_RX_ACK_AUTO, PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_SET, PipeValueFloat, 8, 2, offsetof(UserConfig, ventFeedForwardHumidity), 0, FEED_FORWARD_GAIN_MIN, FEED_FORWARD_GAIN_MAX },
+  { PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_RX_ACK_AUTO, PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_SET, PipeValueUint8, 1, 1, offsetof(UserConfig, ventStrategy), PIPE_FLAG_APPLY_CONTROL, VENT_STRATEGY_MIN, VENT_STRATEGY_MAX },
+};
+
+static_assert(offsetof(UserConfig, samplingMaxSeconds) == offsetof(UserConfig, samplingMinSeconds) + sizeof(UserConfig::samplingMinSeconds), "samplingMaxSeconds doesn't follow samplingMinSeconds");
+static_assert(offsetof(UserConfig, ventFeedForwardTemperature) == offsetof(UserConfig, ventFeedForwardHumidity) + sizeof(UserConfig::ventFeedForwardHumidity), "ventFeedForwardTemperature doesn't follow ventFeedForwardHumidity");
+
+// Position in pipeDescriptors by pipe number, PIPE_DESCRIPTOR_NONE for pipes handled elsewhere
+static const uint8_t pipeDescriptorIndex[NUMBER_OF_PIPES + 1] PROGMEM = {
+  PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, 0, PIPE_DESCRIPTOR_NONE, 1, PIPE_DESCRIPTOR_NONE, 2, PIPE_DESCRIPTOR_NONE,
+  3, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, 4, PIPE_DESCRIPTOR_NONE, 5, PIPE_DESCRIPTOR_NONE, 6,
+  PIPE_DESCRIPTOR_NONE, 7, PIPE_DESCRIPTOR_NONE, 8, PIPE_DESCRIPTOR_NONE, 9, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE,
+  PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE,
+  10, PIPE_DESCRIPTOR_NONE, 11, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE, PIPE_DESCRIPTOR_NONE,
+};
+
+#endif
@@ -94,56 +94,108 @@
 #define PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_RX_ACK_AUTO          13
 #define PIPE_GREENHOUSE_USER_ADJUSTMENTS_ILLUMINATION_OFF_TIME_RX_ACK_AUTO_MAX_SIZE 2
 
-/* Service: Greenhouse Measurements - Characteristic: Exterior Humidity - Pipe: TX */
-#define PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_HUMIDITY_TX          14
-#define PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_HUMIDITY_TX_MAX_SIZE 4
+/* Service: Greenhouse User Adjustments - Characteristic: Sampling Bounds - Pipe: SET */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_SET          14
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_SET_MAX_SIZE 2
 
-/* Service: Greenhouse Measurements - Characteristic: Exterior Temperature - Pipe: TX */
-#define PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_TEMPERATURE_TX          15
-#define PIPE_GREENHOUSE_MEASUREMENTS_EXTERIOR_TEMPERATURE_TX_MAX_SIZE 4
+/* Service: Greenhouse User Adjustments - Characteristic: Sampling Bounds - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_RX_ACK_AUTO          15
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_RX_ACK_AUTO_MAX_SIZE 2
 
-/* Service: Greenhouse Measurements - Characteristic: Interior Humidity - Pipe: TX */
-#define PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_HUMIDITY_TX          16
-#define PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_HUMIDITY_TX_MAX_SIZE 4
+/* Service: Greenhouse User Adjustments - Characteristic: Venting Necessity Threshold - Pipe: SET */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_SET          16
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_SET_MAX_SIZE 4
 
-/* Service: Greenhouse Measurements - Characteristic: Interior Temperature - Pipe: TX */
-#define PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_TEMPERATURE_TX          17
-#define PIPE_GREENHOUSE_MEASUREMENTS_INTERIOR_TEMPERATURE_TX_MAX_SIZE 4
+/* Service: Greenhouse User Adjustments - Characteristic: Venting Necessity Threshold - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_RX_ACK_AUTO          17
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_RX_ACK_AUTO_MAX_SIZE 4
 
-/* Service: Greenhouse State - Characteristic: Venting Necessity - Pipe: TX */
-#define PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_TX          18
-#define PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_TX_MAX_SIZE 4
+/* Service: Greenhouse User Adjustments - Characteristic: Venting Necessity Overshoot - Pipe: SET */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_SET          18
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_SET_MAX_SIZE 4
+
+/* Service: Greenhouse User Adjustments - Characteristic: Venting Necessity Overshoot - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_RX_ACK_AUTO          19
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_RX_ACK_AUTO_MAX_SIZE 4
+
+/* Service: Greenhouse User Adjustments - Characteristic: Target Venting Necessity - Pipe: SET */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_SET          20
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_SET_MAX_SIZE 4
+
+/* Service: Greenhouse User Adjustments - Characteristic: Target Venting Necessity - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_RX_ACK_AUTO          21
+#define PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_RX_ACK_AUTO_MAX_SIZE 4
+
+/* Service: Greenhouse Measurements - Characteristic: Telemetry Snapshot - Pipe: TX */
+#define PIPE_GREENHOUSE_MEASUREMENTS_TELEMETRY_SNAPSHOT_TX          22
+#define PIPE_GREENHOUSE_MEASUREMENTS_TELEMETRY_SNAPSHOT_TX_MAX_SIZE 20
 
 /* Service: Greenhouse State - Characteristic: Venting Necessity - Pipe: SET */
-#define PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET          19
+#define PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET          23
 #define PIPE_GREENHOUSE_STATE_VENTING_NECESSITY_SET_MAX_SIZE 4
 
-/* Service: Greenhouse State - Characteristic: Vent Necessity Delta - Pipe: TX */
-#define PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_TX          20
-#define PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_TX_MAX_SIZE 4
-
 /* Service: Greenhouse State - Characteristic: Vent Necessity Delta - Pipe: SET */
-#define PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET          21
+#define PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET          24
 #define PIPE_GREENHOUSE_STATE_VENT_NECESSITY_DELTA_SET_MAX_SIZE 4
 
 /* Service: Greenhouse Controls - Characteristic: Light Bank 1 Duty Cycle - Pipe: TX */
-#define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_TX          22
+#define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_TX          25
 #define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_TX_MAX_SIZE 1
 
 /* Service: Greenhouse Controls - Characteristic: Light Bank 1 Duty Cycle - Pipe: SET */
-#define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_SET          23
+#define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_SET          26
 #define PIPE_GREENHOUSE_CONTROLS_LIGHT_BANK_1_DUTY_CYCLE_SET_MAX_SIZE 1
 
-/* Service: Greenhouse Controls - Characteristic: Vent Servo Position - Pipe: TX */
-#define PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_TX          24
-#define PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_TX_MAX_SIZE 1
-
 /* Service: Greenhouse Controls - Characteristic: Vent Servo Position - Pipe: SET */
-#define PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_SET          25
+#define PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_SET          27
 #define PIPE_GREENHOUSE_CONTROLS_VENT_SERVO_POSITION_SET_MAX_SIZE 1
 
+/* Service: Greenhouse Controls - Characteristic: Vent PID Tuning - Pipe: TX */
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_TX          28
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_TX_MAX_SIZE 20
+
+/* Service: Greenhouse Controls - Characteristic: Vent PID Tuning - Pipe: SET */
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_SET          29
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_SET_MAX_SIZE 20
+
+/* Service: Greenhouse Controls - Characteristic: Vent PID Tuning - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_RX_ACK_AUTO          30
+#define PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_RX_ACK_AUTO_MAX_SIZE 20
+
+/* Service: Greenhouse Controls - Characteristic: Feed Forward Gains - Pipe: SET */
+#define PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_SET          31
+#define PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_SET_MAX_SIZE 8
+
+/* Service: Greenhouse Controls - Characteristic: Feed Forward Gains - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_RX_ACK_AUTO          32
+#define PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_RX_ACK_AUTO_MAX_SIZE 8
+
+/* Service: Greenhouse Controls - Characteristic: Vent Strategy - Pipe: SET */
+#define PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_SET          33
+#define PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_SET_MAX_SIZE 1
+
+/* Service: Greenhouse Controls - Characteristic: Vent Strategy - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_RX_ACK_AUTO          34
+#define PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_RX_ACK_AUTO_MAX_SIZE 1
+
+/* Service: Greenhouse Transfer - Characteristic: Bulk Transfer - Pipe: TX */
+#define PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_TX          35
+#define PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_TX_MAX_SIZE 20
 
-#define NUMBER_OF_PIPES 25
+/* Service: Greenhouse Transfer - Characteristic: Bulk Transfer - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_RX_ACK_AUTO          36
+#define PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_RX_ACK_AUTO_MAX_SIZE 20
+
+/* Service: Greenhouse Diagnostics - Characteristic: Report - Pipe: TX */
+#define PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_TX          37
+#define PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_TX_MAX_SIZE 20
+
+/* Service: Greenhouse Diagnostics - Characteristic: Report - Pipe: RX_ACK_AUTO */
+#define PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_RX_ACK_AUTO          38
+#define PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_RX_ACK_AUTO_MAX_SIZE 20
+
+
+#define NUMBER_OF_PIPES 38
 
 #define SERVICES_PIPE_TYPE_MAPPING_CONTENT {\
   {ACI_STORE_LOCAL, ACI_SET},   \
@@ -159,18 +211,31 @@
   {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
   {ACI_STORE_LOCAL, ACI_SET},   \
   {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
-  {ACI_STORE_LOCAL, ACI_TX},   \
-  {ACI_STORE_LOCAL, ACI_TX},   \
-  {ACI_STORE_LOCAL, ACI_TX},   \
-  {ACI_STORE_LOCAL, ACI_TX},   \
-  {ACI_STORE_LOCAL, ACI_TX},   \
   {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
   {ACI_STORE_LOCAL, ACI_TX},   \
   {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
   {ACI_STORE_LOCAL, ACI_TX},   \
   {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
   {ACI_STORE_LOCAL, ACI_TX},   \
   {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_SET},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_TX},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
+  {ACI_STORE_LOCAL, ACI_TX},   \
+  {ACI_STORE_LOCAL, ACI_RX_ACK_AUTO},   \
 }
 
 #define GAP_PPCP_MAX_CONN_INT 0x7a /**< Maximum connection interval as a multiple of 1.25 msec , 0xFFFF means no specific value requested */
@@ -178,7 +243,7 @@
 #define GAP_PPCP_SLAVE_LATENCY 0
 #define GAP_PPCP_CONN_TIMEOUT 0x32 /** Connection Supervision timeout multiplier as a multiple of 10msec, 0xFFFF means no specific value requested */
 
-#define NB_SETUP_MESSAGES 48
+#define NB_SETUP_MESSAGES 63
 #define SETUP_MESSAGES_CONTENT {\
     {0x00,\
         {\
@@ -187,7 +252,7 @@
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0x00,0x19,0x01,0x01,0x00,0x00,0x06,0x00,0x05,\
+            0x1f,0x06,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x15,0x00,0x26,0x01,0x01,0x00,0x00,0x06,0x00,0x05,\
             0x50,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,\
         },\
     },\
@@ -217,7 +282,7 @@
     {0x00,\
         {\
             0x1f,0x06,0x20,0x1c,0x0a,0x00,0x03,0x2a,0x00,0x01,0x47,0x52,0x45,0x45,0x4e,0x48,0x4f,0x55,0x53,0x45,\
-            0x2e,0x63,0x6f,0x6d,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x04,\
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x04,\
         },\
     },\
     {0x00,\
@@ -300,110 +365,181 @@
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x21,0xa4,0x03,0x02,0x00,0x17,0x01,0x09,0x02,0x00,0x00,0x04,0x04,0x10,0x10,0x00,0x18,0x28,\
-            0x00,0x01,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,\
+            0x1f,0x06,0x21,0xa4,0x03,0x02,0x00,0x17,0x01,0x09,0x02,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x18,0x28,\
+            0x03,0x01,0x0a,0x19,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x21,0xc0,0xe3,0x55,0x30,0x01,0xcc,0xe8,0x04,0x04,0x13,0x13,0x00,0x19,0x28,0x03,0x01,0x10,\
-            0x1a,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,\
+            0x1f,0x06,0x21,0xc0,0x40,0x64,0x0b,0xe3,0x55,0x0a,0x01,0xcc,0xe8,0x46,0x14,0x03,0x02,0x00,0x19,0x01,\
+            0x0a,0x02,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x1a,0x28,0x03,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x21,0xdc,0xe3,0x55,0x33,0x01,0xcc,0xe8,0x16,0x00,0x05,0x04,0x00,0x1a,0x01,0x33,0x02,0x00,\
-            0x00,0x00,0x00,0x46,0x14,0x03,0x02,0x00,0x1b,0x29,0x02,0x01,\
+            0x1f,0x06,0x21,0xdc,0x01,0x0a,0x1b,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,\
+            0x0c,0x01,0xcc,0xe8,0x46,0x14,0x05,0x04,0x00,0x1b,0x01,0x0c,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x21,0xf8,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x1c,0x28,0x03,0x01,0x10,0x1d,0x00,0xda,0x1b,\
-            0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x34,0x01,\
+            0x1f,0x06,0x21,0xf8,0x02,0x00,0x00,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x1c,0x28,0x03,0x01,0x0a,0x1d,\
+            0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0x14,0xcc,0xe8,0x16,0x00,0x05,0x04,0x00,0x1d,0x01,0x34,0x02,0x00,0x00,0x00,0x00,0x46,\
-            0x14,0x03,0x02,0x00,0x1e,0x29,0x02,0x01,0x00,0x00,0x04,0x04,\
+            0x1f,0x06,0x22,0x14,0x55,0x0d,0x01,0xcc,0xe8,0x46,0x14,0x05,0x04,0x00,0x1d,0x01,0x0d,0x02,0x00,0x00,\
+            0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x1e,0x28,0x03,0x01,0x0a,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0x30,0x13,0x13,0x00,0x1f,0x28,0x03,0x01,0x10,0x20,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,\
-            0xf8,0x40,0x64,0x0b,0xe3,0x55,0x31,0x01,0xcc,0xe8,0x16,0x00,\
+            0x1f,0x06,0x22,0x30,0x1f,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x0e,0x01,\
+            0xcc,0xe8,0x46,0x14,0x05,0x04,0x00,0x1f,0x01,0x0e,0x02,0x00,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0x4c,0x05,0x04,0x00,0x20,0x01,0x31,0x02,0x00,0x00,0x00,0x00,0x46,0x14,0x03,0x02,0x00,\
-            0x21,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x22,\
+            0x1f,0x06,0x22,0x4c,0x00,0x00,0x00,0x04,0x04,0x10,0x10,0x00,0x20,0x28,0x00,0x01,0xda,0x1b,0x66,0x89,\
+            0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x30,0x01,0xcc,0xe8,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0x68,0x28,0x03,0x01,0x10,0x23,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,\
-            0xe3,0x55,0x32,0x01,0xcc,0xe8,0x16,0x00,0x05,0x04,0x00,0x23,\
+            0x1f,0x06,0x22,0x68,0x04,0x04,0x13,0x13,0x00,0x21,0x28,0x03,0x01,0x10,0x22,0x00,0xda,0x1b,0x66,0x89,\
+            0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x36,0x01,0xcc,0xe8,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0x84,0x01,0x32,0x02,0x00,0x00,0x00,0x00,0x46,0x14,0x03,0x02,0x00,0x24,0x29,0x02,0x01,\
-            0x00,0x00,0x04,0x04,0x10,0x10,0x00,0x25,0x28,0x00,0x01,0xda,\
+            0x1f,0x06,0x22,0x84,0x16,0x00,0x15,0x14,0x00,0x22,0x01,0x36,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0xa0,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x10,0x01,0xcc,0xe8,0x04,\
-            0x04,0x13,0x13,0x00,0x26,0x28,0x03,0x01,0x12,0x27,0x00,0xda,\
+            0x1f,0x06,0x22,0xa0,0x00,0x46,0x14,0x03,0x02,0x00,0x23,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x10,0x10,\
+            0x00,0x24,0x28,0x00,0x01,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0xbc,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x11,0x01,0xcc,0xe8,0x16,\
-            0x04,0x05,0x04,0x00,0x27,0x01,0x11,0x02,0x00,0x00,0x00,0x00,\
+            0x1f,0x06,0x22,0xbc,0x40,0x64,0x0b,0xe3,0x55,0x10,0x01,0xcc,0xe8,0x04,0x04,0x13,0x13,0x00,0x25,0x28,\
+            0x03,0x01,0x02,0x26,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0xd8,0x46,0x14,0x03,0x02,0x00,0x28,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x13,0x13,0x00,\
-            0x29,0x28,0x03,0x01,0x12,0x2a,0x00,0xda,0x1b,0x66,0x89,0xf2,\
+            0x1f,0x06,0x22,0xd8,0x40,0x64,0x0b,0xe3,0x55,0x11,0x01,0xcc,0xe8,0x06,0x04,0x05,0x04,0x00,0x26,0x01,\
+            0x11,0x02,0x00,0x00,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x27,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x22,0xf4,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x15,0x01,0xcc,0xe8,0x16,0x04,0x05,0x04,0x00,\
-            0x2a,0x01,0x15,0x02,0x00,0x00,0x00,0x00,0x46,0x14,0x03,0x02,\
+            0x1f,0x06,0x22,0xf4,0x28,0x03,0x01,0x02,0x28,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,\
+            0xe3,0x55,0x15,0x01,0xcc,0xe8,0x06,0x04,0x05,0x04,0x00,0x28,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x23,0x10,0x00,0x2b,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x10,0x10,0x00,0x2c,0x28,0x00,0x01,\
+            0x1f,0x06,0x23,0x10,0x01,0x15,0x02,0x00,0x00,0x00,0x00,0x04,0x04,0x10,0x10,0x00,0x29,0x28,0x00,0x01,\
             0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x23,0x2c,0x20,0x01,0xcc,0xe8,0x04,0x04,0x13,0x13,0x00,0x2d,0x28,0x03,0x01,0x12,0x2e,0x00,\
+            0x1f,0x06,0x23,0x2c,0x20,0x01,0xcc,0xe8,0x04,0x04,0x13,0x13,0x00,0x2a,0x28,0x03,0x01,0x12,0x2b,0x00,\
             0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x23,0x48,0x21,0x01,0xcc,0xe8,0x16,0x04,0x02,0x01,0x00,0x2e,0x01,0x21,0x02,0x00,0x46,0x14,\
-            0x03,0x02,0x00,0x2f,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x13,\
+            0x1f,0x06,0x23,0x48,0x21,0x01,0xcc,0xe8,0x16,0x04,0x02,0x01,0x00,0x2b,0x01,0x21,0x02,0x00,0x46,0x14,\
+            0x03,0x02,0x00,0x2c,0x29,0x02,0x01,0x00,0x00,0x04,0x04,0x13,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0x64,0x13,0x00,0x2d,0x28,0x03,0x01,0x02,0x2e,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,\
+            0x40,0x64,0x0b,0xe3,0x55,0x23,0x01,0xcc,0xe8,0x06,0x04,0x02,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0x80,0x01,0x00,0x2e,0x01,0x23,0x02,0x00,0x04,0x04,0x13,0x13,0x00,0x2f,0x28,0x03,0x01,\
+            0x1a,0x30,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0x9c,0x0b,0xe3,0x55,0x24,0x01,0xcc,0xe8,0x56,0x14,0x15,0x14,0x00,0x30,0x01,0x24,0x02,\
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0xb8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x46,0x14,0x03,0x02,0x00,0x31,0x29,0x02,\
+            0x01,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x32,0x28,0x03,0x01,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0xd4,0x0a,0x33,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x25,\
+            0x01,0xcc,0xe8,0x46,0x14,0x09,0x08,0x00,0x33,0x01,0x25,0x02,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x23,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x04,0x13,0x13,0x00,0x34,0x28,0x03,\
+            0x01,0x0a,0x35,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x0c,0x64,0x0b,0xe3,0x55,0x27,0x01,0xcc,0xe8,0x46,0x14,0x02,0x01,0x00,0x35,0x01,0x27,\
+            0x02,0x00,0x04,0x04,0x10,0x10,0x00,0x36,0x28,0x00,0x01,0xda,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x28,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x40,0x01,0xcc,0xe8,0x04,\
+            0x04,0x13,0x13,0x00,0x37,0x28,0x03,0x01,0x18,0x38,0x00,0xda,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x44,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,0x64,0x0b,0xe3,0x55,0x41,0x01,0xcc,0xe8,0x56,\
+            0x10,0x15,0x14,0x00,0x38,0x01,0x41,0x02,0x00,0x00,0x00,0x00,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x60,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+            0x46,0x14,0x03,0x02,0x00,0x39,0x29,0x02,0x01,0x00,0x00,0x04,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x7c,0x04,0x10,0x10,0x00,0x3a,0x28,0x00,0x01,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,\
+            0x64,0x0b,0xe3,0x55,0x50,0x01,0xcc,0xe8,0x04,0x04,0x13,0x13,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x24,0x98,0x00,0x3b,0x28,0x03,0x01,0x18,0x3c,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,0x40,\
+            0x64,0x0b,0xe3,0x55,0x51,0x01,0xcc,0xe8,0x56,0x10,0x15,0x14,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x23,0x64,0x13,0x00,0x30,0x28,0x03,0x01,0x12,0x31,0x00,0xda,0x1b,0x66,0x89,0xf2,0xb2,0xf8,\
-            0x40,0x64,0x0b,0xe3,0x55,0x23,0x01,0xcc,0xe8,0x16,0x04,0x02,\
+            0x1f,0x06,0x24,0xb4,0x00,0x3c,0x01,0x51,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x46,0x14,0x03,\
         },\
     },\
     {0x00,\
         {\
-            0x16,0x06,0x23,0x80,0x01,0x00,0x31,0x01,0x23,0x02,0x00,0x46,0x14,0x03,0x02,0x00,0x32,0x29,0x02,0x01,\
-            0x00,0x00,0x00,\
+            0x0c,0x06,0x24,0xd0,0x02,0x00,0x3d,0x29,0x02,0x01,0x00,0x00,0x00,\
         },\
     },\
     {0x00,\
@@ -420,25 +556,37 @@
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x40,0x38,0x00,0x15,0x00,0x00,0x01,0x09,0x02,0x04,0x80,0x04,0x00,0x17,0x00,0x00,0x01,0x33,\
-            0x02,0x00,0x02,0x04,0x00,0x1a,0x00,0x1b,0x01,0x34,0x02,0x00,\
+            0x1f,0x06,0x40,0x38,0x00,0x15,0x00,0x00,0x01,0x09,0x02,0x04,0x80,0x04,0x00,0x17,0x00,0x00,0x01,0x0a,\
+            0x02,0x04,0x80,0x04,0x00,0x19,0x00,0x00,0x01,0x0c,0x02,0x04,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x40,0x54,0x02,0x04,0x00,0x1d,0x00,0x1e,0x01,0x31,0x02,0x00,0x02,0x04,0x00,0x20,0x00,0x21,\
-            0x01,0x32,0x02,0x00,0x02,0x04,0x00,0x23,0x00,0x24,0x01,0x11,\
+            0x1f,0x06,0x40,0x54,0x80,0x04,0x00,0x1b,0x00,0x00,0x01,0x0d,0x02,0x04,0x80,0x04,0x00,0x1d,0x00,0x00,\
+            0x01,0x0e,0x02,0x04,0x80,0x04,0x00,0x1f,0x00,0x00,0x01,0x36,\
         },\
     },\
     {0x00,\
         {\
-            0x1f,0x06,0x40,0x70,0x02,0x00,0x82,0x04,0x00,0x27,0x00,0x28,0x01,0x15,0x02,0x00,0x82,0x04,0x00,0x2a,\
-            0x00,0x2b,0x01,0x21,0x02,0x00,0x82,0x04,0x00,0x2e,0x00,0x2f,\
+            0x1f,0x06,0x40,0x70,0x02,0x00,0x02,0x04,0x00,0x22,0x00,0x23,0x01,0x11,0x02,0x00,0x80,0x04,0x00,0x26,\
+            0x00,0x00,0x01,0x15,0x02,0x00,0x80,0x04,0x00,0x28,0x00,0x00,\
         },\
     },\
     {0x00,\
         {\
-            0x0d,0x06,0x40,0x8c,0x01,0x23,0x02,0x00,0x82,0x04,0x00,0x31,0x00,0x32,\
+            0x1f,0x06,0x40,0x8c,0x01,0x21,0x02,0x00,0x82,0x04,0x00,0x2b,0x00,0x2c,0x01,0x23,0x02,0x00,0x80,0x04,\
+            0x00,0x2e,0x00,0x00,0x01,0x24,0x02,0x04,0x82,0x04,0x00,0x30,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x1f,0x06,0x40,0xa8,0x00,0x31,0x01,0x25,0x02,0x04,0x80,0x04,0x00,0x33,0x00,0x00,0x01,0x27,0x02,0x04,\
+            0x80,0x04,0x00,0x35,0x00,0x00,0x01,0x41,0x02,0x04,0x02,0x04,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x11,0x06,0x40,0xc4,0x00,0x38,0x00,0x39,0x01,0x51,0x02,0x04,0x02,0x04,0x00,0x3c,0x00,0x3d,\
         },\
     },\
     {0x00,\
@@ -454,13 +602,18 @@
     },\
     {0x00,\
         {\
-            0x14,0x06,0x60,0x1c,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
-            0x00,\
+            0x1f,0x06,0x60,0x1c,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
+        },\
+    },\
+    {0x00,\
+        {\
+            0x0a,0x06,0x60,0x38,0x00,0x00,0x00,0x00,0x00,0x00,0x00,\
         },\
     },\
     {0x00,\
         {\
-            0x06,0x06,0xf0,0x00,0x03,0x82,0x4f,\
+            0x06,0x06,0xf0,0x00,0x03,0x25,0xbe,\
         },\
     },\
 }
@@ -0,0 +1,106 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+// Host stand-in for the Arduino core
+// -------------------------------------------------
+// Just the parts of the core API the sketch uses.  Time is virtual, see host_fakes.h,
+//   and only moves when delay() is called, the radio is polled or the runner advances it.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "binary.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEC 10
+#define HEX 16
+
+// ATmega328 SPI pins, lib_ble.cpp hands these to lib_aci
+#define MOSI 11
+#define MISO 12
+#define SCK 13
+
+#define PROGMEM
+
+// Time (virtual)
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Interrupts, nothing on the host is ever preempted, handlers run as virtual time passes
+#define interrupts()
+#define noInterrupts()
+
+// Digital I/O
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value);
+
+
+// Serial
+// -------------------------------------------------
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class Print {
+
+  public:
+    virtual size_t write(uint8_t c) = 0;
+    size_t write(const char *str);
+
+    size_t print(const __FlashStringHelper *str);
+    size_t print(const char *str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println(void);
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+  private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+class HardwareSerial : public Print {
+
+  public:
+    void begin(unsigned long baud);
+    operator bool() { return true; }
+
+    using Print::write;
+    size_t write(uint8_t c);
+    void flush(void) { }  // Nothing is buffered
+};
+
+extern HardwareSerial Serial;
+
+#endif
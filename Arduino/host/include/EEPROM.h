@@ -0,0 +1,28 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+// Host stand-in, a byte array the size of the ATmega328's EEPROM, see host_fakes.h for inspection
+
+#include "Arduino.h"
+
+#define EEPROM_SIZE 1024
+
+class EEPROMClass {
+
+  public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length(void) { return EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,60 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef PID_v1_h
+#define PID_v1_h
+
+// Host stand-in for Brett Beauregard's PID_v1 library, same interface and
+//   the same algorithm (derivative on measurement, integral term clamped to the output limits)
+
+#include "Arduino.h"
+
+#define AUTOMATIC 1
+#define MANUAL 0
+#define DIRECT 0
+#define REVERSE 1
+
+class PID {
+
+  public:
+    PID(double *input, double *output, double *setpoint, double Kp, double Ki, double Kd, int controllerDirection);
+
+    void SetMode(int mode);
+    bool Compute(void);
+    void SetOutputLimits(double min, double max);
+
+    void SetTunings(double Kp, double Ki, double Kd);
+    void SetControllerDirection(int direction);
+    void SetSampleTime(int newSampleTime);  // ms
+
+    double GetKp(void);
+    double GetKi(void);
+    double GetKd(void);
+    int GetMode(void);
+    int GetDirection(void);
+
+  private:
+    void Initialize(void);
+
+    double dispKp, dispKi, dispKd;  // As entered, for display
+    double kp, ki, kd;  // Scaled by the sample time and direction
+
+    int controllerDirection;
+
+    double *myInput;
+    double *myOutput;
+    double *mySetpoint;
+
+    unsigned long lastTime;
+    double ITerm, lastInput;
+
+    unsigned long SampleTime;
+    double outMin, outMax;
+    bool inAuto;
+};
+
+#endif
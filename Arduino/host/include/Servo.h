@@ -0,0 +1,31 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Servo_h
+#define Servo_h
+
+// Host stand-in, records every position written, see host_fakes.h
+
+#include "Arduino.h"
+
+class Servo {
+
+  public:
+    Servo(void);
+
+    uint8_t attach(int pin);
+    void detach(void);
+    void write(int value);  // degrees
+    int read(void);
+    bool attached(void);
+
+  private:
+    int _pin;
+    int _angle;
+};
+
+#endif
@@ -0,0 +1,27 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Time_h
+#define Time_h
+
+// Host stand-in for the PJRC Time library, driven from the virtual millis()
+
+#include <sys/types.h>  // time_t
+#include "Arduino.h"
+
+typedef enum { timeNotSet, timeNeedsSync, timeSet } timeStatus_t;
+
+time_t now(void);
+void setTime(time_t t);
+void adjustTime(long adjustment);
+timeStatus_t timeStatus(void);
+
+int hour(void);
+int minute(void);
+int second(void);
+
+#endif
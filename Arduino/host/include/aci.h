@@ -0,0 +1,193 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef ACI_H__
+#define ACI_H__
+
+// Host stand-in for Nordic's aci.h
+// -------------------------------------------------
+// Opcodes and layouts follow the nRF8001 datasheet so the sketch's event handling compiles
+//   unchanged, but only the events and fields the sketch touches are declared.
+
+#include "hal_platform.h"
+
+#define HAL_ACI_MAX_LENGTH 31
+#define ACI_PIPE_RX_DATA_MAX_LEN 20
+#define PIPES_ARRAY_SIZE 8
+
+typedef enum {
+
+  ACI_DEVICE_INVALID = 0x00,
+  ACI_DEVICE_TEST = 0x01,
+  ACI_DEVICE_SETUP = 0x02,
+  ACI_DEVICE_STANDBY = 0x03,
+  ACI_DEVICE_SLEEP = 0x04
+
+} aci_device_operation_mode_t;
+
+typedef enum {
+
+  ACI_CMD_SETUP = 0x06,
+  ACI_CMD_RADIO_RESET = 0x0E,
+  ACI_CMD_CONNECT = 0x0F,
+  ACI_CMD_CHANGE_TIMING = 0x13,
+  ACI_CMD_SET_LOCAL_DATA = 0x0D,
+  ACI_CMD_SEND_DATA = 0x15
+
+} aci_cmd_opcode_t;
+
+typedef enum {
+
+  ACI_EVT_DEVICE_STARTED = 0x81,
+  ACI_EVT_ECHO = 0x82,
+  ACI_EVT_HW_ERROR = 0x83,
+  ACI_EVT_CMD_RSP = 0x84,
+  ACI_EVT_CONNECTED = 0x85,
+  ACI_EVT_DISCONNECTED = 0x86,
+  ACI_EVT_BOND_STATUS = 0x87,
+  ACI_EVT_PIPE_STATUS = 0x88,
+  ACI_EVT_TIMING = 0x89,
+  ACI_EVT_DATA_CREDIT = 0x8A,
+  ACI_EVT_DATA_ACK = 0x8B,
+  ACI_EVT_DATA_RECEIVED = 0x8C,
+  ACI_EVT_PIPE_ERROR = 0x8D,
+  ACI_EVT_DISPLAY_PASSKEY = 0x8E,
+  ACI_EVT_KEY_REQUEST = 0x8F
+
+} aci_evt_opcode_t;
+
+typedef enum {
+
+  ACI_STATUS_SUCCESS = 0x00,
+  ACI_STATUS_TRANSACTION_CONTINUE = 0x01,
+  ACI_STATUS_TRANSACTION_COMPLETE = 0x02,
+  ACI_STATUS_ERROR_UNKNOWN = 0x80,
+  ACI_STATUS_ERROR_PIPE_INVALID = 0x8A,
+  ACI_STATUS_ERROR_PEER_ATT_ERROR = 0x8B,
+  ACI_STATUS_ERROR_CREDIT_NOT_AVAILABLE = 0x8E,
+  ACI_STATUS_ERROR_PIPE_STATE_INVALID = 0x96
+
+} aci_status_code_t;
+
+typedef enum {
+
+  ACI_STORE_INVALID = 0x0,
+  ACI_STORE_LOCAL,
+  ACI_STORE_REMOTE
+
+} aci_pipe_store_t;
+
+typedef enum {
+
+  ACI_TX_BROADCAST = 0x0001,
+  ACI_TX = 0x0002,
+  ACI_TX_ACK = 0x0004,
+  ACI_RX = 0x0008,
+  ACI_RX_ACK = 0x0010,
+  ACI_TX_REQ = 0x0020,
+  ACI_RX_REQ = 0x0040,
+  ACI_SET = 0x0080,
+  ACI_TX_SIGN = 0x0100,
+  ACI_RX_SIGN = 0x0200,
+  ACI_RX_ACK_AUTO = 0x0400
+
+} aci_pipe_type_t;
+
+typedef struct {
+
+  aci_pipe_store_t location;
+  aci_pipe_type_t pipe_type;
+
+} services_pipe_type_mapping_t;
+
+typedef struct {
+
+  uint8_t pipe_number;
+  uint8_t aci_data[ACI_PIPE_RX_DATA_MAX_LEN];
+
+} aci_rx_data_t;
+
+typedef struct {
+
+  uint8_t len;
+  uint8_t evt_opcode;
+
+  union {
+
+    struct {
+      uint8_t device_mode;  // aci_device_operation_mode_t
+      uint8_t hw_error;
+      uint8_t credit_available;
+    } device_started;
+
+    struct {
+      uint16_t line_num;
+      uint8_t file_name[20];
+    } hw_error;
+
+    struct {
+      uint8_t cmd_opcode;  // aci_cmd_opcode_t
+      uint8_t cmd_status;  // aci_status_code_t
+    } cmd_rsp;
+
+    struct {
+      uint8_t dev_addr[6];
+      uint8_t dev_addr_type;
+      uint16_t conn_rf_interval;
+      uint16_t conn_slave_rf_latency;
+      uint16_t conn_rf_timeout;
+    } connected;
+
+    struct {
+      uint8_t aci_status;
+      uint8_t btle_status;
+    } disconnected;
+
+    struct {
+      uint8_t pipes_open_bitmap[PIPES_ARRAY_SIZE];
+      uint8_t pipes_closed_bitmap[PIPES_ARRAY_SIZE];
+    } pipe_status;
+
+    struct {
+      uint16_t conn_rf_interval;
+      uint16_t conn_slave_rf_latency;
+      uint16_t conn_rf_timeout;
+    } timing;
+
+    struct {
+      uint8_t credit;
+    } data_credit;
+
+    struct {
+      aci_rx_data_t rx_data;
+    } data_received;
+
+    struct {
+      uint8_t pipe_number;
+      uint8_t error_code;
+      uint8_t error_data[ACI_PIPE_RX_DATA_MAX_LEN];
+    } pipe_error;
+
+  } params;
+
+} aci_evt_t;
+
+typedef struct {
+
+  uint8_t debug_byte;
+  aci_evt_t evt;
+
+} hal_aci_evt_t;
+
+typedef struct {
+
+  uint8_t status_byte;
+  uint8_t buffer[HAL_ACI_MAX_LENGTH + 1];
+
+} hal_aci_data_t;
+
+#endif
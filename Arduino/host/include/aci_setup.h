@@ -0,0 +1,28 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef H_ACI_SETUP
+#define H_ACI_SETUP
+
+// Host stand-in, the fake radio in src/fake_radio.cpp accepts any setup
+
+#include "lib_aci.h"
+
+typedef enum {
+
+  SETUP_SUCCESS = 0,
+  SETUP_FAIL_COMMAND_QUEUE_NOT_EMPTY,
+  SETUP_FAIL_EVENT_QUEUE_NOT_EMPTY,
+  SETUP_FAIL_TIMEOUT,
+  SETUP_FAIL_NOT_SETUP_EVENT,
+  SETUP_FAIL_NOT_COMMAND_RESPONSE
+
+} aci_setup_return_t;
+
+uint8_t do_aci_setup(aci_state_t *aci_stat);
+
+#endif
@@ -0,0 +1,26 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Pgmspace_h
+#define Pgmspace_h
+
+// Host stand-in, flash and RAM are the same address space here
+
+#include "Arduino.h"
+
+#define PSTR(s) (s)
+
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_float(address) (*(const float *)(address))
+#define pgm_read_ptr(address) (*(void * const *)(address))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif
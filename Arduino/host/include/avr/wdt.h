@@ -0,0 +1,23 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Wdt_h
+#define Wdt_h
+
+// Host stand-in, the watchdog itself is hal_startWatchdogTimer() in src/hal_linux.cpp
+
+#define WDTO_15MS 0
+#define WDTO_1S 6
+#define WDTO_2S 7
+#define WDTO_4S 8
+#define WDTO_8S 9
+
+#define wdt_reset()
+#define wdt_enable(timeout)
+#define wdt_disable()
+
+#endif
@@ -0,0 +1,16 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef PLATFORM_H__
+#define PLATFORM_H__
+
+// Host stand-in for lib_aci's platform header
+
+#include "Arduino.h"
+#include <avr/pgmspace.h>
+
+#endif
@@ -0,0 +1,91 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef HostFakes_h
+#define HostFakes_h
+
+// Host Fakes
+// -------------------------------------------------
+// Control and inspection of the in-memory hardware the host build runs against.
+//   Nothing here is visible to the sketch, only to the host runner.
+
+#include "Arduino.h"
+#include "aci.h"
+#include "lib_hal.h"
+
+// Virtual clock
+// NOTE: 64-bit and in µs, so a host run never sees millis() wrap
+uint64_t fake_clockMicros(void);
+void fake_clockAdvanceMicros(uint64_t us);
+void fake_clockAdvanceMillis(uint64_t ms);
+void fake_clockSetAlarm(uint64_t atMicros, void (*handler)(void));  // One shot, the host's only interrupt, UINT64_MAX cancels
+
+// Serial
+void fake_serialSetEcho(boolean echo);  // Off by default, long runs print a lot
+
+// Watchdog and supply
+void fake_watchdogExpire(void);  // Runs the handler the watchdog interrupt would, as if loop() had hung
+unsigned long fake_watchdogFeedCount(void);
+void fake_supplySetMillivolts(uint16_t millivolts);  // 5000 until set
+void fake_sleepSetWakeLimit(uint64_t micros);  // hal_sleep() returns by this virtual time, UINT64_MAX until set
+unsigned long fake_sleepCount(HalSleepMode mode);
+
+// Digital pins
+uint8_t fake_pinState(uint8_t pin);
+uint8_t fake_shiftRegisterState(void);  // Last value written through hal_shiftRegisterWrite()
+
+// Simulated HIH6100s, one per shift register output enabling its SDA line
+// NOTE: They share one I2C address, enabling several at once wire-ANDs their replies like the real bus
+#define FAKE_HIH6100_CHANNELS 8
+#define FAKE_HIH6100_CONVERSION_TIME 37  // ms, datasheet typical
+
+void fake_hih6100SetReading(uint8_t shiftRegisterOutput, float humidity, float temperature);  // e.g. B10000000, % RH, °C
+void fake_hih6100SetConnected(uint8_t shiftRegisterOutput, boolean connected);
+unsigned long fake_hih6100RequestCount(void);
+unsigned long fake_hih6100FetchCount(void);
+
+// The bus side, for the TWI backend in hal_linux.cpp
+// NOTE: Resolved when the transfer ends, a conversion finishing during it is seen
+HalTwiResult fake_hih6100Transfer(uint8_t address, uint8_t *data, uint8_t writeLength, uint8_t readLength, uint8_t *byteCount);
+
+// EEPROM
+void fake_eepromErase(void);  // Back to 0xFF everywhere
+unsigned long fake_eepromWriteCount(void);  // Cell writes that actually changed or rewrote a byte
+unsigned long fake_eepromCellWriteCount(int address);
+unsigned long fake_eepromMaxCellWriteCount(void);
+
+// Servo
+int fake_servoPosition(void);  // degrees, last position written to any servo
+unsigned long fake_servoWriteCount(void);
+unsigned long fake_servoMoveCount(void);  // Writes that changed the position
+unsigned long fake_servoTravel(void);  // Total degrees moved
+double fake_servoAttachedSeconds(void);  // Virtual time any servo was attached, sending pulses from Timer1
+
+// Radio
+// NOTE: Events are delivered through lib_aci_event_get(), each poll costs FAKE_RADIO_POLL_TIME
+//   of virtual time so the sketch's busy-waits for responses and credits terminate
+#define FAKE_RADIO_POLL_TIME 50  // µs, roughly one SPI transaction with the nRF8001
+#define FAKE_RADIO_CREDITS 2
+#define FAKE_RADIO_CONNECTION_INTERVAL 30  // ms, time for a notification's credit to come back
+
+void fake_radioConnectClient(boolean subscribeToAll);  // Connects as soon as the sketch is advertising
+void fake_radioDisconnectClient(void);
+void fake_radioWrite(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount);  // Client writes to an RX pipe
+void fake_radioHang(void);  // No more events until lib_aci_init(), commands are swallowed
+boolean fake_radioClientSubscribed(void);  // Connected and its pipe subscriptions delivered to the sketch
+boolean fake_radioIdle(void);  // No event is ready or will be without time advancing
+uint64_t fake_radioNextEventMicros(void);  // UINT64_MAX when nothing is pending
+
+unsigned long fake_radioNotificationCount(void);
+unsigned long fake_radioNotificationBytes(void);
+unsigned long fake_radioLocalDataCount(void);
+uint8_t fake_radioLastNotification(uint8_t pipe, uint8_t *buffer);  // Returns byte count, 0 if never sent
+
+typedef void (*FakeNotificationObserver)(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount);
+void fake_radioSetNotificationObserver(FakeNotificationObserver observer);  // Sees every notification sent, NULL to stop
+
+#endif
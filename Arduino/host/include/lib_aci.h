@@ -0,0 +1,78 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef LIB_ACI_H__
+#define LIB_ACI_H__
+
+// Host stand-in for Nordic's lib_aci, backed by the fake radio in src/fake_radio.cpp
+
+#include "hal_platform.h"
+#include "aci.h"
+
+// boards.h
+#define BOARD_DEFAULT 0
+#define REDBEARLAB_SHIELD_V1_1 1
+#define UNUSED 255
+
+typedef struct {
+
+  uint8_t board_name;
+  uint8_t reqn_pin;
+  uint8_t rdyn_pin;
+  uint8_t mosi_pin;
+  uint8_t miso_pin;
+  uint8_t sck_pin;
+  uint8_t spi_clock_divider;
+  uint8_t reset_pin;
+  uint8_t active_pin;
+  uint8_t optional_chip_sel_pin;
+  bool interface_is_interrupt;
+  uint8_t interrupt_number;
+
+} aci_pins_t;
+
+typedef struct {
+
+  services_pipe_type_mapping_t *services_pipe_type_mapping;
+  uint8_t number_of_pipes;
+  hal_aci_data_t *setup_msgs;
+  uint8_t num_setup_msgs;
+
+} aci_setup_info_t;
+
+typedef struct aci_state_t {
+
+  aci_pins_t aci_pins;
+  aci_setup_info_t aci_setup_info;
+  uint8_t bonded;
+  uint8_t data_credit_total;
+  aci_device_operation_mode_t device_state;
+
+  uint8_t data_credit_available;
+  uint16_t connection_interval;  // Multiples of 1.25ms
+  uint16_t slave_latency;
+  uint16_t supervision_timeout;  // Multiples of 10ms
+
+  uint8_t pipes_open_bitmap[PIPES_ARRAY_SIZE];
+  uint8_t pipes_closed_bitmap[PIPES_ARRAY_SIZE];
+
+} aci_state_t;
+
+void lib_aci_init(aci_state_t *aci_stat, bool debug);
+void lib_aci_debug_print(bool enable);
+bool lib_aci_event_get(aci_state_t *aci_stat, hal_aci_evt_t *aci_evt);
+
+bool lib_aci_radio_reset(void);
+bool lib_aci_device_version(void);
+bool lib_aci_connect(uint16_t run_timeout, uint16_t adv_interval);
+bool lib_aci_change_timing_GAP_PPCP(void);
+
+bool lib_aci_is_pipe_available(aci_state_t *aci_stat, uint8_t pipe);
+bool lib_aci_set_local_data(aci_state_t *aci_stat, uint8_t pipe, uint8_t *value, uint8_t size);
+bool lib_aci_send_data(uint8_t pipe, uint8_t *value, uint8_t size);
+
+#endif
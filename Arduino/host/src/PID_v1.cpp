@@ -0,0 +1,138 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "PID_v1.h"
+
+PID::PID(double *input, double *output, double *setpoint, double Kp, double Ki, double Kd, int direction) {
+
+  myOutput = output;
+  myInput = input;
+  mySetpoint = setpoint;
+  inAuto = false;
+
+  SetOutputLimits(0, 255);  // Library default, the Arduino PWM range
+
+  SampleTime = 100;  // ms
+
+  SetControllerDirection(direction);
+  SetTunings(Kp, Ki, Kd);
+
+  lastTime = millis() - SampleTime;
+}
+
+bool PID::Compute(void) {
+
+  if (!inAuto) return false;
+
+  unsigned long now = millis();
+  unsigned long timeChange = (now - lastTime);
+
+  if (timeChange >= SampleTime) {
+
+    double input = *myInput;
+    double error = *mySetpoint - input;
+
+    ITerm += (ki * error);
+    if (ITerm > outMax) ITerm = outMax;
+    else if (ITerm < outMin) ITerm = outMin;
+
+    double dInput = (input - lastInput);
+
+    double output = kp * error + ITerm - kd * dInput;
+    if (output > outMax) output = outMax;
+    else if (output < outMin) output = outMin;
+    *myOutput = output;
+
+    lastInput = input;
+    lastTime = now;
+    return true;
+
+  } else return false;
+}
+
+void PID::SetTunings(double Kp, double Ki, double Kd) {
+
+  if (Kp < 0 || Ki < 0 || Kd < 0) return;
+
+  dispKp = Kp;
+  dispKi = Ki;
+  dispKd = Kd;
+
+  double SampleTimeInSec = ((double) SampleTime) / 1000;
+  kp = Kp;
+  ki = Ki * SampleTimeInSec;
+  kd = Kd / SampleTimeInSec;
+
+  if (controllerDirection == REVERSE) {
+
+    kp = (0 - kp);
+    ki = (0 - ki);
+    kd = (0 - kd);
+  }
+}
+
+void PID::SetSampleTime(int NewSampleTime) {
+
+  if (NewSampleTime > 0) {
+
+    double ratio = (double) NewSampleTime / (double) SampleTime;
+    ki *= ratio;
+    kd /= ratio;
+    SampleTime = (unsigned long) NewSampleTime;
+  }
+}
+
+void PID::SetOutputLimits(double Min, double Max) {
+
+  if (Min >= Max) return;
+  outMin = Min;
+  outMax = Max;
+
+  if (inAuto) {
+
+    if (*myOutput > outMax) *myOutput = outMax;
+    else if (*myOutput < outMin) *myOutput = outMin;
+
+    if (ITerm > outMax) ITerm = outMax;
+    else if (ITerm < outMin) ITerm = outMin;
+  }
+}
+
+void PID::SetMode(int Mode) {
+
+  bool newAuto = (Mode == AUTOMATIC);
+  if (newAuto && !inAuto) Initialize();  // Bumpless transfer from manual
+
+  inAuto = newAuto;
+}
+
+void PID::Initialize(void) {
+
+  ITerm = *myOutput;
+  lastInput = *myInput;
+
+  if (ITerm > outMax) ITerm = outMax;
+  else if (ITerm < outMin) ITerm = outMin;
+}
+
+void PID::SetControllerDirection(int Direction) {
+
+  if (inAuto && Direction != controllerDirection) {
+
+    kp = (0 - kp);
+    ki = (0 - ki);
+    kd = (0 - kd);
+  }
+
+  controllerDirection = Direction;
+}
+
+double PID::GetKp(void) { return dispKp; }
+double PID::GetKi(void) { return dispKi; }
+double PID::GetKd(void) { return dispKd; }
+int PID::GetMode(void) { return inAuto ? AUTOMATIC : MANUAL; }
+int PID::GetDirection(void) { return controllerDirection; }
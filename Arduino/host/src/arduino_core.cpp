@@ -0,0 +1,199 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "host_fakes.h"
+
+HardwareSerial Serial;
+
+static uint64_t clockMicros = 0;
+static uint64_t alarmMicros = UINT64_MAX;
+static void (*alarmHandler)(void) = NULL;
+static uint8_t pinStates[32];
+static boolean serialEcho = false;
+
+
+// TIME
+// ----------------------------------------------------
+uint64_t fake_clockMicros(void) {
+
+  return clockMicros;
+}
+
+void fake_clockAdvanceMicros(uint64_t us) {
+
+  uint64_t until = clockMicros + us;
+
+  // Run the alarm as an interrupt would, at its time, it may set the next one
+  while (alarmMicros <= until) {
+
+    clockMicros = alarmMicros;
+    alarmMicros = UINT64_MAX;
+    alarmHandler();
+  }
+
+  clockMicros = until;
+}
+
+void fake_clockAdvanceMillis(uint64_t ms) {
+
+  fake_clockAdvanceMicros(ms * 1000);
+}
+
+void fake_clockSetAlarm(uint64_t atMicros, void (*handler)(void)) {
+
+  alarmMicros = atMicros;
+  alarmHandler = handler;
+}
+
+unsigned long millis(void) {
+
+  return (unsigned long) (clockMicros / 1000);
+}
+
+unsigned long micros(void) {
+
+  return (unsigned long) clockMicros;
+}
+
+void delay(unsigned long ms) {
+
+  fake_clockAdvanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+
+  fake_clockAdvanceMicros(us);
+}
+
+
+// DIGITAL I/O
+// ----------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode) {
+
+  // Nothing to configure
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+
+  if (pin < sizeof(pinStates)) pinStates[pin] = value;
+}
+
+int digitalRead(uint8_t pin) {
+
+  return (pin < sizeof(pinStates)) ? pinStates[pin] : LOW;
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value) {
+
+  // Only the final state matters to the fakes, hal_shiftRegisterWrite() records it
+}
+
+uint8_t fake_pinState(uint8_t pin) {
+
+  return digitalRead(pin);
+}
+
+
+// SERIAL
+// ----------------------------------------------------
+void fake_serialSetEcho(boolean echo) {
+
+  serialEcho = echo;
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+
+  // Nothing to configure
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+
+  if (serialEcho) putchar(c);
+  return 1;
+}
+
+size_t Print::write(const char *str) {
+
+  size_t n = 0;
+  while (*str) n += write((uint8_t) *str++);
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+
+  return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const char *str) {
+
+  return write(str);
+}
+
+size_t Print::print(char c) {
+
+  return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+
+  return printNumber(value, base);
+}
+
+size_t Print::print(int value, int base) {
+
+  return print((long) value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+
+  return printNumber(value, base);
+}
+
+size_t Print::print(long value, int base) {
+
+  if (value < 0 && base == DEC) return print('-') + printNumber((unsigned long) -value, base);
+  else return printNumber((unsigned long) value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+
+  return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+size_t Print::println(void) {
+
+  return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+
+  char buffer[8 * sizeof(long) + 1];
+  char *str = &buffer[sizeof(buffer) - 1];
+  *str = '\0';
+
+  if (base < 2) base = DEC;
+
+  do {
+
+    unsigned long digit = value % base;
+    value /= base;
+    *--str = digit < 10 ? digit + '0' : digit + 'A' - 10;
+
+  } while (value);
+
+  return write(str);
+}
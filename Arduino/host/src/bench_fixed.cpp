@@ -0,0 +1,258 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+// Accuracy and cost of the Q15.16 control path against the float reference, stage by stage
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+#include "Arduino.h"
+#include "host_fakes.h"
+#include "constants.h"
+#include "lib_hih6100.h"
+#include "lib_fixed.h"
+#include "lib_fixedPID.h"
+
+#define BENCH_SAMPLES 200000UL
+#define PID_SAMPLE_TIME 3000  // ms, as analyzeSystemState() sets it
+
+typedef struct {
+  
+  uint16_t humidityCounts[2];  // Interior, exterior
+  uint16_t temperatureCounts[2];
+  
+} SensorCounts;
+
+typedef struct {
+  
+  float humiditySetpoint, humidityNecessityCoeff, temperatureSetpoint, temperatureNecessityCoeff;
+  
+} Coefficients;
+
+volatile float sink;  // Keeps the work from being optimised away
+
+
+// THE TWO PATHS
+// ----------------------------------------------------
+// Same expressions as HIH6100_Sensor::fetchResult() and analyzeSystemState()
+static inline double humidityFloat(uint16_t counts) { return (float) counts * 6.10e-3; }
+static inline double temperatureFloat(uint16_t counts) { return (float) counts * 1.007e-2 - 40.0; }
+
+static inline Fixed humidityFixed(uint16_t counts) {
+  
+  return Fixed::fromRaw((int32_t)(((uint32_t) counts * HIH6100_HUMIDITY_SCALE) >> HIH6100_SCALE_SHIFT));
+}
+
+static inline Fixed temperatureFixed(uint16_t counts) {
+  
+  return Fixed::fromRaw((int32_t)(((uint32_t) counts * HIH6100_TEMPERATURE_SCALE) >> HIH6100_SCALE_SHIFT) - 40L * FIXED_ONE);
+}
+
+template <class Number>
+static inline Number ventingNecessity(Number interiorHumidity, Number interiorTemperature, Number exteriorHumidity, Number exteriorTemperature,
+                                      Number humiditySetpoint, Number humidityCoeff, Number temperatureSetpoint, Number temperatureCoeff) {
+  
+  Number humidityDeviation = interiorHumidity - humiditySetpoint;
+  Number temperatureDeviation = interiorTemperature - temperatureSetpoint;
+  Number humidityDelta = interiorHumidity - exteriorHumidity;
+  Number temperatureDelta = interiorTemperature - exteriorTemperature;
+  
+  return (humidityCoeff * humidityDelta * humidityDeviation) + (temperatureCoeff * temperatureDelta * temperatureDeviation);
+}
+
+
+// INPUTS
+// ----------------------------------------------------
+static uint16_t countsForHumidity(float humidity) { return (uint16_t)(humidity / 6.10e-3f); }
+static uint16_t countsForTemperature(float temperature) { return (uint16_t)((temperature + 40.0f) / 1.007e-2f); }
+
+static float uniform(float low, float high) { return low + (high - low) * (float) rand() / (float) RAND_MAX; }
+static float constrainFloat(float value, float low, float high) { return (value < low) ? low : ((value > high) ? high : value); }
+
+// A greenhouse wandering between realistic interior and exterior conditions
+static void generateCounts(SensorCounts *counts, unsigned long n) {
+  
+  float interiorHumidity = 50, interiorTemperature = 21, exteriorHumidity = 60, exteriorTemperature = 15;
+  
+  for (unsigned long i = 0; i < n; i++) {
+    
+    interiorHumidity = constrainFloat(interiorHumidity + uniform(-0.5f, 0.5f), 10, 99);
+    interiorTemperature = constrainFloat(interiorTemperature + uniform(-0.1f, 0.1f), 5, 40);
+    exteriorHumidity = constrainFloat(exteriorHumidity + uniform(-0.5f, 0.5f), 10, 99);
+    exteriorTemperature = constrainFloat(exteriorTemperature + uniform(-0.1f, 0.1f), -5, 35);
+    
+    counts[i].humidityCounts[0] = countsForHumidity(interiorHumidity);
+    counts[i].temperatureCounts[0] = countsForTemperature(interiorTemperature);
+    counts[i].humidityCounts[1] = countsForHumidity(exteriorHumidity);
+    counts[i].temperatureCounts[1] = countsForTemperature(exteriorTemperature);
+  }
+}
+
+
+// MEASUREMENT
+// ----------------------------------------------------
+static inline uint64_t readCycles(void) {
+
+#ifdef HAS_CYCLE_COUNTER
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+typedef struct {
+  
+  double nanoseconds;
+  double cycles;
+  
+} StageCost;
+
+typedef struct {
+  
+  double worstError;
+  double sumSquaredError;
+  unsigned long samples;
+  
+} StageError;
+
+static void recordError(StageError *error, double reference, double value) {
+  
+  double difference = fabs(value - reference);
+  if (difference > error->worstError) error->worstError = difference;
+  error->sumSquaredError += difference * difference;
+  error->samples++;
+}
+
+#define TIME_STAGE(cost, body) do { \
+    auto started = std::chrono::steady_clock::now(); \
+    uint64_t startCycles = readCycles(); \
+    for (unsigned long i = 0; i < BENCH_SAMPLES; i++) { body; } \
+    (cost).cycles = (double)(readCycles() - startCycles) / BENCH_SAMPLES; \
+    (cost).nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / BENCH_SAMPLES; \
+  } while (0)
+
+static void printStage(const char *name, const char *units, StageCost reference, StageCost fixed, StageError error) {
+  
+  printf("%-18s %8.1f ns %7.1f cyc   %8.1f ns %7.1f cyc   worst %.5f, RMS %.5f %s\n", name,
+         reference.nanoseconds, reference.cycles, fixed.nanoseconds, fixed.cycles,
+         error.worstError, sqrt(error.sumSquaredError / error.samples), units);
+}
+
+
+// MAIN
+// ----------------------------------------------------
+int main(int argc, char *argv[]) {
+  
+  static SensorCounts counts[BENCH_SAMPLES];
+  generateCounts(counts, BENCH_SAMPLES);
+  
+  Coefficients coefficients = { 30.0f, 1.0f, 21.0f, 0.75f };  // restoreConfiguration()'s defaults
+  
+  static double referenceNecessity[BENCH_SAMPLES];
+  static Fixed fixedNecessity[BENCH_SAMPLES];
+  
+  StageCost referenceCost, fixedCost;
+  StageError error = { 0, 0, 0 };
+  
+  printf("Control path, %lu samples, float reference against Q15.16\n", BENCH_SAMPLES);
+  printf("%-18s %27s   %27s\n", "", "float", "fixed");
+  
+  // Counts to units
+  TIME_STAGE(referenceCost, sink = humidityFloat(counts[i].humidityCounts[0]) + temperatureFloat(counts[i].temperatureCounts[0]));
+  TIME_STAGE(fixedCost, sink = (float)(humidityFixed(counts[i].humidityCounts[0]) + temperatureFixed(counts[i].temperatureCounts[0])).raw);
+  
+  for (unsigned long i = 0; i < BENCH_SAMPLES; i++) {
+    
+    recordError(&error, humidityFloat(counts[i].humidityCounts[0]), humidityFixed(counts[i].humidityCounts[0]).toFloat());
+    recordError(&error, temperatureFloat(counts[i].temperatureCounts[0]), temperatureFixed(counts[i].temperatureCounts[0]).toFloat());
+  }
+  printStage("sensor conversion", "%RH/°C", referenceCost, fixedCost, error);
+  
+  // Venting necessity
+  double hS = coefficients.humiditySetpoint, hC = coefficients.humidityNecessityCoeff;
+  double tS = coefficients.temperatureSetpoint, tC = coefficients.temperatureNecessityCoeff;
+  Fixed hSFixed = hS, hCFixed = hC, tSFixed = tS, tCFixed = tC;
+  
+  TIME_STAGE(referenceCost, referenceNecessity[i] = ventingNecessity<double>(
+      humidityFloat(counts[i].humidityCounts[0]), temperatureFloat(counts[i].temperatureCounts[0]),
+      humidityFloat(counts[i].humidityCounts[1]), temperatureFloat(counts[i].temperatureCounts[1]), hS, hC, tS, tC));
+  TIME_STAGE(fixedCost, fixedNecessity[i] = ventingNecessity<Fixed>(
+      humidityFixed(counts[i].humidityCounts[0]), temperatureFixed(counts[i].temperatureCounts[0]),
+      humidityFixed(counts[i].humidityCounts[1]), temperatureFixed(counts[i].temperatureCounts[1]), hSFixed, hCFixed, tSFixed, tCFixed));
+  
+  error = (StageError) { 0, 0, 0 };
+  for (unsigned long i = 0; i < BENCH_SAMPLES; i++) recordError(&error, referenceNecessity[i], fixedNecessity[i].toFloat());
+  printStage("+ venting necessity", "", referenceCost, fixedCost, error);
+  
+  // PID, each fed the necessity its own path computed
+  double referenceInput = 0, referenceOutput = VENT_DOOR_CLOSED, referenceSetpoint = 0;
+  Fixed fixedInput = 0.0f, fixedOutput = (float) VENT_DOOR_CLOSED, fixedSetpoint = 0.0f;
+  
+  PID referencePID(&referenceInput, &referenceOutput, &referenceSetpoint, VENT_PID_DEFAULT_KP, VENT_PID_DEFAULT_KI, VENT_PID_DEFAULT_KD, DIRECT);
+  FixedPID fixedPID(&fixedInput, &fixedOutput, &fixedSetpoint, VENT_PID_DEFAULT_KP, VENT_PID_DEFAULT_KI, VENT_PID_DEFAULT_KD, DIRECT);
+  
+  referencePID.SetSampleTime(PID_SAMPLE_TIME);
+  referencePID.SetOutputLimits(VENT_DOOR_OPEN, VENT_DOOR_CLOSED);
+  referencePID.SetMode(AUTOMATIC);
+  
+  fixedPID.SetSampleTime(PID_SAMPLE_TIME);
+  fixedPID.SetOutputLimits(VENT_DOOR_OPEN, VENT_DOOR_CLOSED);
+  fixedPID.SetMode(AUTOMATIC);
+  
+  // NOTE: Compute() reads the virtual clock, so both controllers see every sample at their sample time
+  static double referenceAngle[BENCH_SAMPLES];
+  static Fixed fixedAngle[BENCH_SAMPLES];
+  double referenceNanoseconds = 0, fixedNanoseconds = 0, referenceCycles = 0, fixedCycles = 0;
+  
+  for (unsigned long i = 0; i < BENCH_SAMPLES; i++) {
+    
+    fake_clockAdvanceMillis(PID_SAMPLE_TIME);
+    
+    referenceInput = referenceNecessity[i];
+    fixedInput = fixedNecessity[i];
+    
+    auto started = std::chrono::steady_clock::now();
+    uint64_t startCycles = readCycles();
+    referencePID.Compute();
+    referenceCycles += readCycles() - startCycles;
+    auto middle = std::chrono::steady_clock::now();
+    startCycles = readCycles();
+    fixedPID.Compute();
+    fixedCycles += readCycles() - startCycles;
+    auto finished = std::chrono::steady_clock::now();
+    
+    referenceNanoseconds += std::chrono::duration<double, std::nano>(middle - started).count();
+    fixedNanoseconds += std::chrono::duration<double, std::nano>(finished - middle).count();
+    
+    referenceAngle[i] = referenceOutput;
+    fixedAngle[i] = fixedOutput;
+  }
+  
+  referenceCost = (StageCost) { referenceNanoseconds / BENCH_SAMPLES, referenceCycles / BENCH_SAMPLES };
+  fixedCost = (StageCost) { fixedNanoseconds / BENCH_SAMPLES, fixedCycles / BENCH_SAMPLES };
+  
+  error = (StageError) { 0, 0, 0 };
+  unsigned long differentAngles = 0;
+  for (unsigned long i = 0; i < BENCH_SAMPLES; i++) {
+    
+    recordError(&error, referenceAngle[i], fixedAngle[i].toFloat());
+    if (toInt(referenceAngle[i]) != toInt(fixedAngle[i])) differentAngles++;
+  }
+  printStage("+ PID (per call)", "deg", referenceCost, fixedCost, error);
+  
+  printf("\nservo angle differs on %lu of %lu cycles (%.3f%%)\n", differentAngles, BENCH_SAMPLES, 100.0 * differentAngles / BENCH_SAMPLES);
+  printf("NOTE: Host timings use the FPU, the ATmega328 has none, so the float column is far cheaper here than on the board\n");
+  
+  return 0;
+}
@@ -0,0 +1,172 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+// Cost per query of TimeSeries, against the pairwise-slope version it replaced
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+#include "Arduino.h"
+#include "lib_timeSeries.h"
+
+#define BENCH_QUERIES 2000000UL
+#define SAMPLE_INTERVAL 2000UL  // ms, analyzeSystemState()'s period
+
+
+// The previous implementation, as it was apart from taking the time as an argument and
+//   recording the time of the first measurement
+class PairwiseTimeSeries {
+  
+  public:
+    PairwiseTimeSeries(void) { _bufferIndex = 0; measurementCount = 0; _lastMeasurementTime = 0; }
+    
+    void addValue(float newValue, unsigned long currentTime) {
+      
+      _measurements[_bufferIndex] = newValue;
+      
+      if (measurementCount == 0) _timeDeltas[_bufferIndex] = 0;
+      else {
+        
+        _timeDeltas[_bufferIndex] = currentTime - _lastMeasurementTime;
+      }
+      _lastMeasurementTime = currentTime;
+      
+      _bufferIndex = (_bufferIndex + 1) % CIRC_BUFFER_DEPTH;
+      if (measurementCount < CIRC_BUFFER_DEPTH) measurementCount++;
+    }
+    
+    float averageValue() {
+      
+      if (measurementCount == 0) return UNAVAILABLE_f;
+      else return _average(_measurements, _bufferIndex, measurementCount);
+    }
+    
+    float averageSlope() {
+      
+      if (measurementCount < 2) return UNAVAILABLE_f;
+      
+      float dVdTs[CIRC_BUFFER_DEPTH - 1];
+      
+      for (uint8_t i=0; i < (measurementCount - 1); i++) {
+        
+        uint8_t startingIndex = (_bufferIndex + (CIRC_BUFFER_DEPTH - measurementCount)) % CIRC_BUFFER_DEPTH;
+        uint8_t indexA = (startingIndex + i) % CIRC_BUFFER_DEPTH;
+        uint8_t indexB = (indexA + 1) % CIRC_BUFFER_DEPTH;
+        
+        dVdTs[i] = (_measurements[indexB] - _measurements[indexA]) / ( (float)_timeDeltas[indexB] / 1e3f);
+      }
+      
+      return _average(dVdTs, 0, measurementCount - 1);
+    }
+    
+    uint8_t measurementCount;
+  
+  private:
+    float _average(float values[], uint8_t startingIndex, uint8_t length) {
+      
+      float total = 0;
+      for (uint8_t i = 0; i < length; i++) total += values[(i + startingIndex) % length];
+      return total / length;
+    }
+    
+    float _measurements[CIRC_BUFFER_DEPTH];
+    uint16_t _timeDeltas[CIRC_BUFFER_DEPTH];
+    uint8_t _bufferIndex;
+    unsigned long _lastMeasurementTime;
+};
+
+
+// TIMING
+// ----------------------------------------------------
+typedef struct {
+  
+  double nanoseconds;
+  double cycles;  // 0 without a cycle counter
+  
+} QueryCost;
+
+static inline uint64_t readCycles(void) {
+
+#ifdef HAS_CYCLE_COUNTER
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+volatile float sink;  // Keeps the queries from being optimised away
+
+template <class Series>
+QueryCost timeQueries(Series &series, boolean slope) {
+  
+  auto started = std::chrono::steady_clock::now();
+  uint64_t startCycles = readCycles();
+  
+  Series * volatile seriesPointer = &series;  // Stops the query being hoisted out of the loop
+  
+  for (unsigned long i = 0; i < BENCH_QUERIES; i++) sink = slope ? seriesPointer->averageSlope() : seriesPointer->averageValue();
+  
+  uint64_t cycles = readCycles() - startCycles;
+  double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+  
+  QueryCost cost = { elapsed / BENCH_QUERIES, (double) cycles / BENCH_QUERIES };
+  return cost;
+}
+
+template <class Series>
+QueryCost timeAdditions(Series &series) {
+  
+  auto started = std::chrono::steady_clock::now();
+  uint64_t startCycles = readCycles();
+  
+  for (unsigned long i = 0; i < BENCH_QUERIES; i++) series.addValue((float)(i & 0xFF), i * SAMPLE_INTERVAL);
+  
+  uint64_t cycles = readCycles() - startCycles;
+  double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+  
+  QueryCost cost = { elapsed / BENCH_QUERIES, (double) cycles / BENCH_QUERIES };
+  return cost;
+}
+
+void printCost(const char *name, QueryCost previous, QueryCost current) {
+  
+  printf("%-14s %10.1f ns %10.1f cyc   %10.1f ns %10.1f cyc\n", name, previous.nanoseconds, previous.cycles, current.nanoseconds, current.cycles);
+}
+
+
+// MAIN
+// ----------------------------------------------------
+int main(int argc, char *argv[]) {
+  
+  PairwiseTimeSeries previous;
+  TimeSeries<CIRC_BUFFER_DEPTH> current;
+  
+  printf("TimeSeries, depth %d, %lu iterations\n", CIRC_BUFFER_DEPTH, BENCH_QUERIES);
+  printf("%-14s %29s   %29s\n", "", "pairwise (previous)", "running sums");
+  
+  printCost("addValue", timeAdditions(previous), timeAdditions(current));
+  printCost("averageValue", timeQueries(previous, false), timeQueries(current, false));
+  printCost("averageSlope", timeQueries(previous, true), timeQueries(current, true));
+  
+  // A noiseless ramp, both should report the same slope
+  current.clearAll();
+  
+  for (uint8_t i = 0; i < CIRC_BUFFER_DEPTH; i++) {
+    
+    previous.addValue(1.5f * i, 500000UL + i * SAMPLE_INTERVAL);
+    current.addValue(1.5f * i, 500000UL + i * SAMPLE_INTERVAL);
+  }
+  printf("\nramp of 0.75/s: pairwise %.4f/s, least squares %.4f/s, variance %.4f\n", previous.averageSlope(), current.averageSlope(), current.variance());
+  
+  return 0;
+}
@@ -0,0 +1,70 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "EEPROM.h"
+#include "host_fakes.h"
+
+EEPROMClass EEPROM;
+
+static uint8_t cells[EEPROM_SIZE];
+static unsigned long cellWrites[EEPROM_SIZE];
+static unsigned long totalWrites = 0;
+static boolean erased = false;
+
+static void eraseIfNeeded(void) {
+
+  if (!erased) fake_eepromErase();
+}
+
+void fake_eepromErase(void) {
+
+  memset(cells, 0xFF, sizeof(cells));
+  memset(cellWrites, 0, sizeof(cellWrites));
+  totalWrites = 0;
+  erased = true;
+}
+
+unsigned long fake_eepromWriteCount(void) {
+
+  return totalWrites;
+}
+
+unsigned long fake_eepromCellWriteCount(int address) {
+
+  return (address >= 0 && address < EEPROM_SIZE) ? cellWrites[address] : 0;
+}
+
+unsigned long fake_eepromMaxCellWriteCount(void) {
+
+  unsigned long worst = 0;
+  for (int i = 0; i < EEPROM_SIZE; i++) if (cellWrites[i] > worst) worst = cellWrites[i];
+  return worst;
+}
+
+uint8_t EEPROMClass::read(int address) {
+
+  eraseIfNeeded();
+  return (address >= 0 && address < EEPROM_SIZE) ? cells[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+
+  eraseIfNeeded();
+  if (address < 0 || address >= EEPROM_SIZE) return;
+
+  // Every write is an erase/program cycle on the real part, even when the byte is unchanged
+  cells[address] = value;
+  cellWrites[address]++;
+  totalWrites++;
+
+  delayMicroseconds(3400);  // Datasheet erase + write time
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+
+  if (read(address) != value) write(address, value);
+}
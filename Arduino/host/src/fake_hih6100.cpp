@@ -0,0 +1,200 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "host_fakes.h"
+
+#define HIH6100_I2C_ADDRESS 0x27
+#define HIH6100_FULL_SCALE 16382.0f  // 2^14 - 2 counts
+
+// Simulated HIH6100s on the I2C bus
+// -------------------------------------------------
+// A write starts a conversion on every sensor whose SDA line is enabled, a 4-byte read
+//   returns the latest result with status 0 the first time and 1 (stale) after that.
+
+typedef struct {
+
+  boolean connected;
+  float humidity;  // % RH, what the sensor would measure right now
+  float temperature;  // °C
+
+  boolean converting;
+  uint64_t conversionDoneAt;  // µs
+  boolean resultUnread;
+  uint16_t rawHumidity;  // Latched at the end of the last conversion
+  uint16_t rawTemperature;
+
+} SimulatedHIH6100;
+
+static SimulatedHIH6100 channels[FAKE_HIH6100_CHANNELS];
+static boolean channelsInitialized = false;
+static unsigned long requestCount = 0;
+static unsigned long fetchCount = 0;
+
+static void initializeChannels(void) {
+
+  if (channelsInitialized) return;
+
+  for (uint8_t i = 0; i < FAKE_HIH6100_CHANNELS; i++) {
+
+    channels[i].connected = true;
+    channels[i].humidity = 50.0f;
+    channels[i].temperature = 20.0f;
+    channels[i].converting = false;
+    channels[i].resultUnread = false;
+    channels[i].rawHumidity = 0;
+    channels[i].rawTemperature = 0;
+  }
+
+  channelsInitialized = true;
+}
+
+static uint16_t encode(float value, float offset, float span) {
+
+  float counts = (value + offset) / span * HIH6100_FULL_SCALE;
+  if (counts < 0) counts = 0;
+  if (counts > HIH6100_FULL_SCALE) counts = HIH6100_FULL_SCALE;
+
+  return (uint16_t) (counts + 0.5f);
+}
+
+static void completeConversion(SimulatedHIH6100 *channel) {
+
+  if (channel->converting && fake_clockMicros() >= channel->conversionDoneAt) {
+
+    channel->rawHumidity = encode(channel->humidity, 0.0f, 100.0f);
+    channel->rawTemperature = encode(channel->temperature, 40.0f, 165.0f);
+    channel->converting = false;
+    channel->resultUnread = true;
+  }
+}
+
+// Bit i of the shift register enables channel i
+static boolean channelEnabled(uint8_t i) {
+
+  return channels[i].connected && (fake_shiftRegisterState() & (1 << i));
+}
+
+static int channelForOutput(uint8_t shiftRegisterOutput) {
+
+  for (uint8_t i = 0; i < FAKE_HIH6100_CHANNELS; i++) if (shiftRegisterOutput == (1 << i)) return i;
+  return -1;
+}
+
+void fake_hih6100SetReading(uint8_t shiftRegisterOutput, float humidity, float temperature) {
+
+  initializeChannels();
+
+  int i = channelForOutput(shiftRegisterOutput);
+  if (i < 0) return;
+
+  channels[i].humidity = humidity;
+  channels[i].temperature = temperature;
+}
+
+void fake_hih6100SetConnected(uint8_t shiftRegisterOutput, boolean connected) {
+
+  initializeChannels();
+
+  int i = channelForOutput(shiftRegisterOutput);
+  if (i >= 0) channels[i].connected = connected;
+}
+
+unsigned long fake_hih6100RequestCount(void) {
+
+  return requestCount;
+}
+
+unsigned long fake_hih6100FetchCount(void) {
+
+  return fetchCount;
+}
+
+
+// BUS
+// ----------------------------------------------------
+static HalTwiResult measurementRequest(void) {
+
+  boolean acknowledged = false;
+
+  for (uint8_t i = 0; i < FAKE_HIH6100_CHANNELS; i++) {
+
+    if (!channelEnabled(i)) continue;
+
+    completeConversion(&channels[i]);
+    if (!channels[i].converting) {
+
+      channels[i].converting = true;
+      channels[i].conversionDoneAt = fake_clockMicros() + (FAKE_HIH6100_CONVERSION_TIME * 1000UL);
+    }
+
+    acknowledged = true;
+  }
+
+  if (!acknowledged) return HalTwiAddressNack;
+
+  requestCount++;
+  return HalTwiOK;
+}
+
+static HalTwiResult dataFetch(uint8_t *data, uint8_t readLength) {
+
+  uint8_t reply[4] = { 0xFF, 0xFF, 0xFF, 0xFF };  // Open-drain bus idles high
+  boolean acknowledged = false;
+
+  for (uint8_t i = 0; i < FAKE_HIH6100_CHANNELS; i++) {
+
+    if (!channelEnabled(i)) continue;
+
+    SimulatedHIH6100 *channel = &channels[i];
+    completeConversion(channel);
+
+    uint8_t status = channel->resultUnread ? 0 : 1;
+    channel->resultUnread = false;
+
+    uint8_t bytes[4];
+    bytes[0] = (status << 6) | ((channel->rawHumidity >> 8) & 0x3F);
+    bytes[1] = channel->rawHumidity & 0xFF;
+    bytes[2] = (channel->rawTemperature >> 6) & 0xFF;
+    bytes[3] = (channel->rawTemperature << 2) & 0xFF;
+
+    for (uint8_t b = 0; b < 4; b++) reply[b] &= bytes[b];
+    acknowledged = true;
+  }
+
+  if (!acknowledged) return HalTwiAddressNack;
+
+  // Past the fourth byte the sensor has nothing more to say, the bus reads high
+  for (uint8_t b = 0; b < readLength; b++) data[b] = (b < 4) ? reply[b] : 0xFF;
+  fetchCount++;
+
+  return HalTwiOK;
+}
+
+HalTwiResult fake_hih6100Transfer(uint8_t address, uint8_t *data, uint8_t writeLength, uint8_t readLength, uint8_t *byteCount) {
+
+  initializeChannels();
+  *byteCount = 0;
+
+  if (address != HIH6100_I2C_ADDRESS) return HalTwiAddressNack;
+
+  // The HIH6100 ignores data bytes outside command mode, any write is a Measurement Request
+  if (writeLength > 0 || readLength == 0) {
+
+    HalTwiResult result = measurementRequest();
+    if (result != HalTwiOK || readLength == 0) {
+
+      *byteCount = (result == HalTwiOK) ? writeLength : 0;
+      return result;
+    }
+  }
+
+  HalTwiResult result = dataFetch(data, readLength);
+  if (result == HalTwiOK) *byteCount = readLength;
+
+  return result;
+}
@@ -0,0 +1,381 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "lib_aci.h"
+#include "aci_setup.h"
+#include "host_fakes.h"
+
+// Simulated nRF8001
+// -------------------------------------------------
+// Commands are accepted immediately and answered with events through lib_aci_event_get(),
+//   the same order the real device uses.  Notifications hand their data credit back one
+//   connection interval after they're sent.
+
+#define FAKE_RADIO_EVENT_QUEUE_DEPTH 32
+#define FAKE_RADIO_MAX_PIPES 62
+
+typedef struct {
+
+  aci_evt_t evt;
+  uint64_t releaseAt;  // µs, not delivered before this
+
+} QueuedEvent;
+
+static QueuedEvent eventQueue[FAKE_RADIO_EVENT_QUEUE_DEPTH];
+static uint8_t eventQueueCount = 0;
+
+static aci_state_t *radioState = NULL;
+static boolean advertising = false;
+static boolean connected = false;
+static boolean clientWaiting = false;
+static boolean clientSubscribesToAll = false;
+static boolean poweredUp = false;  // Setup mode is only entered once, from power-up
+static boolean hung = false;  // See fake_radioHang()
+
+static uint8_t lastNotification[FAKE_RADIO_MAX_PIPES + 1][ACI_PIPE_RX_DATA_MAX_LEN];
+static uint8_t lastNotificationSize[FAKE_RADIO_MAX_PIPES + 1];
+static unsigned long notificationCount = 0;
+static unsigned long notificationBytes = 0;
+static unsigned long localDataCount = 0;
+static FakeNotificationObserver notificationObserver = NULL;
+
+
+// EVENT QUEUE
+// ----------------------------------------------------
+static aci_evt_t *queueEvent(uint8_t opcode, uint8_t len, uint64_t delayMicros) {
+
+  if (eventQueueCount == FAKE_RADIO_EVENT_QUEUE_DEPTH) return NULL;  // Real device would assert, drop instead
+  if (hung) return NULL;
+
+  QueuedEvent *queued = &eventQueue[eventQueueCount++];
+  memset(queued, 0, sizeof(QueuedEvent));
+  queued->evt.evt_opcode = opcode;
+  queued->evt.len = len;
+  queued->releaseAt = fake_clockMicros() + delayMicros;
+
+  return &queued->evt;
+}
+
+static void dropEvents(uint8_t opcode) {
+
+  uint8_t kept = 0;
+
+  for (uint8_t i = 0; i < eventQueueCount; i++) {
+
+    if (eventQueue[i].evt.evt_opcode != opcode) eventQueue[kept++] = eventQueue[i];
+  }
+
+  eventQueueCount = kept;
+}
+
+static void queueCommandResponse(uint8_t cmdOpcode, uint8_t status) {
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_CMD_RSP, 3, 0);
+  if (evt == NULL) return;
+
+  evt->params.cmd_rsp.cmd_opcode = cmdOpcode;
+  evt->params.cmd_rsp.cmd_status = status;
+}
+
+static void queueDeviceStarted(aci_device_operation_mode_t mode) {
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_DEVICE_STARTED, 4, 0);
+  if (evt == NULL) return;
+
+  evt->params.device_started.device_mode = mode;
+  evt->params.device_started.hw_error = 0;
+  evt->params.device_started.credit_available = FAKE_RADIO_CREDITS;
+}
+
+static boolean pipeIsTransmit(uint8_t pipe) {
+
+  if (radioState == NULL || pipe == 0 || pipe > radioState->aci_setup_info.number_of_pipes) return false;
+
+  aci_pipe_type_t pipeType = radioState->aci_setup_info.services_pipe_type_mapping[pipe - 1].pipe_type;
+  return (pipeType == ACI_TX || pipeType == ACI_TX_ACK);
+}
+
+static void connectIfReady(void) {
+
+  if (!advertising || !clientWaiting || connected) return;
+
+  advertising = false;
+  connected = true;
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_CONNECTED, 14, 0);
+  if (evt == NULL) return;
+  evt->params.connected.conn_rf_interval = (FAKE_RADIO_CONNECTION_INTERVAL * 4) / 5;  // 1.25ms units
+  evt->params.connected.conn_rf_timeout = 600;
+
+  // The client subscribes to notifications, opening the transmit pipes
+  evt = queueEvent(ACI_EVT_PIPE_STATUS, 17, FAKE_RADIO_CONNECTION_INTERVAL * 1000UL);
+  if (evt == NULL) return;
+
+  for (uint8_t pipe = 1; pipe <= FAKE_RADIO_MAX_PIPES; pipe++) {
+
+    if (clientSubscribesToAll && pipeIsTransmit(pipe)) evt->params.pipe_status.pipes_open_bitmap[pipe / 8] |= (1 << (pipe % 8));
+    else evt->params.pipe_status.pipes_closed_bitmap[pipe / 8] |= (1 << (pipe % 8));
+  }
+
+  // Pipe 0 (the GATT pipe) is always open once connected
+  evt->params.pipe_status.pipes_open_bitmap[0] |= 0x01;
+}
+
+
+// LIB_ACI
+// ----------------------------------------------------
+void lib_aci_init(aci_state_t *aci_stat, bool debug) {
+
+  radioState = aci_stat;
+
+  for (uint8_t i = 0; i < PIPES_ARRAY_SIZE; i++) {
+
+    aci_stat->pipes_open_bitmap[i] = 0;
+    aci_stat->pipes_closed_bitmap[i] = 0;
+  }
+
+  aci_stat->data_credit_available = 0;
+  aci_stat->data_credit_total = 0;
+  aci_stat->device_state = ACI_DEVICE_INVALID;
+
+  eventQueueCount = 0;
+  advertising = false;
+  connected = false;
+  hung = false;
+
+  // NOTE: Without a reset line, only power-up starts the device, a later init needs lib_aci_radio_reset()
+  if (!poweredUp) queueDeviceStarted(ACI_DEVICE_SETUP);
+  poweredUp = true;
+}
+
+void lib_aci_debug_print(bool enable) {
+
+  // Nothing to print
+}
+
+bool lib_aci_event_get(aci_state_t *aci_stat, hal_aci_evt_t *aci_evt) {
+
+  fake_clockAdvanceMicros(FAKE_RADIO_POLL_TIME);
+  if (hung) return false;
+
+  // Deliver the oldest event that has been released
+  for (uint8_t i = 0; i < eventQueueCount; i++) {
+
+    if (eventQueue[i].releaseAt > fake_clockMicros()) continue;
+
+    aci_evt->debug_byte = 0;
+    aci_evt->evt = eventQueue[i].evt;
+
+    memmove(&eventQueue[i], &eventQueue[i + 1], (eventQueueCount - i - 1) * sizeof(QueuedEvent));
+    eventQueueCount--;
+
+    // Same bookkeeping lib_aci does before handing an event over
+    aci_evt_t *evt = &aci_evt->evt;
+    switch (evt->evt_opcode) {
+
+      case ACI_EVT_DEVICE_STARTED:
+        aci_stat->device_state = (aci_device_operation_mode_t) evt->params.device_started.device_mode;
+        break;
+
+      case ACI_EVT_CONNECTED:
+        aci_stat->connection_interval = evt->params.connected.conn_rf_interval;
+        aci_stat->slave_latency = evt->params.connected.conn_slave_rf_latency;
+        aci_stat->supervision_timeout = evt->params.connected.conn_rf_timeout;
+        break;
+
+      case ACI_EVT_PIPE_STATUS:
+        memcpy(aci_stat->pipes_open_bitmap, evt->params.pipe_status.pipes_open_bitmap, PIPES_ARRAY_SIZE);
+        memcpy(aci_stat->pipes_closed_bitmap, evt->params.pipe_status.pipes_closed_bitmap, PIPES_ARRAY_SIZE);
+        break;
+
+      case ACI_EVT_DISCONNECTED:
+        memset(aci_stat->pipes_open_bitmap, 0, PIPES_ARRAY_SIZE);
+        memset(aci_stat->pipes_closed_bitmap, 0, PIPES_ARRAY_SIZE);
+        break;
+
+      case ACI_EVT_TIMING:
+        aci_stat->connection_interval = evt->params.timing.conn_rf_interval;
+        break;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool lib_aci_radio_reset(void) {
+
+  queueDeviceStarted(ACI_DEVICE_STANDBY);
+  return true;
+}
+
+bool lib_aci_device_version(void) {
+
+  queueCommandResponse(0x09, ACI_STATUS_SUCCESS);
+  return true;
+}
+
+uint8_t do_aci_setup(aci_state_t *aci_stat) {
+
+  // The setup messages aren't interpreted, services.h pipe mapping is all the fake needs
+  queueDeviceStarted(ACI_DEVICE_STANDBY);
+  return SETUP_SUCCESS;
+}
+
+bool lib_aci_connect(uint16_t run_timeout, uint16_t adv_interval) {
+
+  queueCommandResponse(ACI_CMD_CONNECT, ACI_STATUS_SUCCESS);
+
+  advertising = true;
+  connectIfReady();
+
+  return true;
+}
+
+bool lib_aci_change_timing_GAP_PPCP(void) {
+
+  queueCommandResponse(ACI_CMD_CHANGE_TIMING, ACI_STATUS_SUCCESS);
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_TIMING, 7, FAKE_RADIO_CONNECTION_INTERVAL * 1000UL);
+  if (evt != NULL) evt->params.timing.conn_rf_interval = (FAKE_RADIO_CONNECTION_INTERVAL * 4) / 5;
+
+  return true;
+}
+
+bool lib_aci_is_pipe_available(aci_state_t *aci_stat, uint8_t pipe) {
+
+  if (pipe > FAKE_RADIO_MAX_PIPES) return false;
+  return (aci_stat->pipes_open_bitmap[pipe / 8] & (1 << (pipe % 8))) != 0;
+}
+
+bool lib_aci_set_local_data(aci_state_t *aci_stat, uint8_t pipe, uint8_t *value, uint8_t size) {
+
+  if (size > ACI_PIPE_RX_DATA_MAX_LEN) return false;
+
+  localDataCount++;
+  queueCommandResponse(ACI_CMD_SET_LOCAL_DATA, ACI_STATUS_SUCCESS);
+
+  return true;
+}
+
+bool lib_aci_send_data(uint8_t pipe, uint8_t *value, uint8_t size) {
+
+  if (radioState == NULL || size > ACI_PIPE_RX_DATA_MAX_LEN || pipe > FAKE_RADIO_MAX_PIPES) return false;
+
+  if (!connected || !lib_aci_is_pipe_available(radioState, pipe)) {
+
+    aci_evt_t *evt = queueEvent(ACI_EVT_PIPE_ERROR, 4, 0);
+    if (evt != NULL) {
+
+      evt->params.pipe_error.pipe_number = pipe;
+      evt->params.pipe_error.error_code = ACI_STATUS_ERROR_PIPE_STATE_INVALID;
+    }
+    return true;
+  }
+
+  memcpy(lastNotification[pipe], value, size);
+  lastNotificationSize[pipe] = size;
+  notificationCount++;
+  notificationBytes += size;
+  if (notificationObserver != NULL) notificationObserver(pipe, value, size);
+
+  // Credit comes back once the packet has gone out in the next connection event
+  aci_evt_t *evt = queueEvent(ACI_EVT_DATA_CREDIT, 2, FAKE_RADIO_CONNECTION_INTERVAL * 1000UL);
+  if (evt != NULL) evt->params.data_credit.credit = 1;
+
+  return true;
+}
+
+
+// HOST CONTROL
+// ----------------------------------------------------
+void fake_radioConnectClient(boolean subscribeToAll) {
+
+  clientWaiting = true;
+  clientSubscribesToAll = subscribeToAll;
+  connectIfReady();
+}
+
+void fake_radioDisconnectClient(void) {
+
+  clientWaiting = false;
+  if (!connected) return;
+
+  connected = false;
+
+  // Packets still waiting for a connection event are flushed, their credits never come back
+  dropEvents(ACI_EVT_DATA_CREDIT);
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_DISCONNECTED, 4, 0);
+  if (evt != NULL) evt->params.disconnected.btle_status = 0x13;  // Remote user terminated connection
+}
+
+void fake_radioHang(void) {
+
+  // Stops answering until the transport is re-initialised, as if an RDYN edge had been missed
+  hung = true;
+  eventQueueCount = 0;
+}
+
+void fake_radioWrite(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!connected || byteCount > ACI_PIPE_RX_DATA_MAX_LEN) return;
+
+  aci_evt_t *evt = queueEvent(ACI_EVT_DATA_RECEIVED, byteCount + 2, 0);
+  if (evt == NULL) return;
+
+  evt->params.data_received.rx_data.pipe_number = pipe;
+  memcpy(evt->params.data_received.rx_data.aci_data, bytes, byteCount);
+}
+
+boolean fake_radioClientSubscribed(void) {
+
+  // Pipe 0 opens with the first pipe status event after connecting
+  return connected && radioState != NULL && (radioState->pipes_open_bitmap[0] & 0x01);
+}
+
+boolean fake_radioIdle(void) {
+
+  return fake_radioNextEventMicros() > fake_clockMicros();
+}
+
+uint64_t fake_radioNextEventMicros(void) {
+
+  uint64_t next = UINT64_MAX;
+  for (uint8_t i = 0; i < eventQueueCount; i++) if (eventQueue[i].releaseAt < next) next = eventQueue[i].releaseAt;
+
+  return next;
+}
+
+unsigned long fake_radioNotificationCount(void) {
+
+  return notificationCount;
+}
+
+unsigned long fake_radioNotificationBytes(void) {
+
+  return notificationBytes;
+}
+
+unsigned long fake_radioLocalDataCount(void) {
+
+  return localDataCount;
+}
+
+void fake_radioSetNotificationObserver(FakeNotificationObserver observer) {
+
+  notificationObserver = observer;
+}
+
+uint8_t fake_radioLastNotification(uint8_t pipe, uint8_t *buffer) {
+
+  if (pipe > FAKE_RADIO_MAX_PIPES) return 0;
+
+  memcpy(buffer, lastNotification[pipe], lastNotificationSize[pipe]);
+  return lastNotificationSize[pipe];
+}
@@ -0,0 +1,91 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Servo.h"
+#include "host_fakes.h"
+
+static int lastPosition = 90;
+static unsigned long writeCount = 0;
+static unsigned long moveCount = 0;
+static unsigned long travel = 0;
+static uint8_t attachedCount = 0;
+static uint64_t attachedSince = 0;  // Since the first of those attached now
+static uint64_t attachedMicros = 0;  // Before then
+
+Servo::Servo(void) {
+
+  _pin = -1;
+  _angle = 90;
+}
+
+uint8_t Servo::attach(int pin) {
+
+  if (_pin < 0 && attachedCount++ == 0) attachedSince = fake_clockMicros();
+  _pin = pin;
+  return 0;
+}
+
+void Servo::detach(void) {
+
+  if (_pin >= 0 && --attachedCount == 0) attachedMicros += fake_clockMicros() - attachedSince;
+  _pin = -1;
+}
+
+void Servo::write(int value) {
+
+  // Same clamping as the real library for values given in degrees
+  if (value < 0) value = 0;
+  if (value > 180) value = 180;
+
+  writeCount++;
+  if (value != _angle) {
+
+    moveCount++;
+    travel += abs(value - _angle);
+  }
+
+  _angle = value;
+  lastPosition = value;
+}
+
+int Servo::read(void) {
+
+  return _angle;
+}
+
+bool Servo::attached(void) {
+
+  return _pin >= 0;
+}
+
+int fake_servoPosition(void) {
+
+  return lastPosition;
+}
+
+unsigned long fake_servoWriteCount(void) {
+
+  return writeCount;
+}
+
+unsigned long fake_servoMoveCount(void) {
+
+  return moveCount;
+}
+
+unsigned long fake_servoTravel(void) {
+
+  return travel;
+}
+
+double fake_servoAttachedSeconds(void) {
+
+  uint64_t micros = attachedMicros;
+  if (attachedCount > 0) micros += fake_clockMicros() - attachedSince;
+
+  return micros / 1e6;
+}
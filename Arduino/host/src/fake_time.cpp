@@ -0,0 +1,51 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Time.h"
+
+// Wall clock kept as seconds at the last setTime() plus virtual millis() since then
+
+static time_t sysTime = 0;
+static unsigned long sysTimeMillis = 0;
+static timeStatus_t status = timeNotSet;
+
+time_t now(void) {
+
+  return sysTime + (time_t) ((millis() - sysTimeMillis) / 1000);
+}
+
+void setTime(time_t t) {
+
+  sysTime = t;
+  sysTimeMillis = millis();
+  status = timeSet;
+}
+
+void adjustTime(long adjustment) {
+
+  sysTime += adjustment;
+}
+
+timeStatus_t timeStatus(void) {
+
+  return status;
+}
+
+int hour(void) {
+
+  return (int) ((now() % 86400) / 3600);
+}
+
+int minute(void) {
+
+  return (int) ((now() % 3600) / 60);
+}
+
+int second(void) {
+
+  return (int) (now() % 60);
+}
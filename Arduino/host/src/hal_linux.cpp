@@ -0,0 +1,156 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include "Arduino.h"
+#include "lib_hal.h"
+#include "host_fakes.h"
+
+// Linux backend of lib_hal.h
+
+static uint8_t shiftRegisterState = 0;
+
+static WatchdogHandler watchdogHandler = NULL;
+static unsigned long watchdogFeeds = 0;
+static uint16_t supplyMillivolts = 5000;
+static uint64_t sleepWakeLimit = UINT64_MAX;  // µs, see fake_sleepSetWakeLimit()
+static unsigned long sleepCounts[2] = { 0, 0 };
+
+void hal_startWatchdogTimer(WatchdogHandler beforeReset) {
+
+  // No timer, the host runner is its own watchdog, see fake_watchdogExpire()
+  watchdogHandler = beforeReset;
+}
+
+void hal_feedWatchdog(void) {
+
+  watchdogFeeds++;
+}
+
+uint64_t hal_millis64(void) {
+
+  // The virtual clock is 64-bit already
+  return fake_clockMicros() / 1000;
+}
+
+uint8_t hal_disableInterrupts(void) {
+
+  // Nothing preempts the sketch on the host
+  return 0;
+}
+
+void hal_restoreInterrupts(uint8_t state) {
+
+  (void) state;
+}
+
+unsigned long hal_sleep(HalSleepMode mode, unsigned long maxMillis, uint8_t wakePin, boolean *wokeByPin) {
+
+  // Jump the virtual clock to the first of the period running out, the radio's next event
+  //   pulling RDYN low, or the runner's next intervention
+  // NOTE: The time slept is exact here, the AVR estimates it for a power-down cut short
+  uint64_t now = fake_clockMicros();
+  uint64_t wake = now + (uint64_t) maxMillis * 1000;
+  uint64_t radioEvent = fake_radioNextEventMicros();
+
+  *wokeByPin = false;
+  if (radioEvent < wake) {
+
+    wake = radioEvent;
+    *wokeByPin = true;
+  }
+  if (sleepWakeLimit < wake) wake = sleepWakeLimit;
+  if (wake <= now) return 0;
+
+  sleepCounts[mode]++;
+  unsigned long before = millis();
+  fake_clockAdvanceMicros(wake - now);
+
+  return millis() - before;
+}
+
+void fake_sleepSetWakeLimit(uint64_t micros) {
+
+  sleepWakeLimit = micros;
+}
+
+unsigned long fake_sleepCount(HalSleepMode mode) {
+
+  return sleepCounts[mode];
+}
+
+uint16_t hal_supplyMillivolts(void) {
+
+  return supplyMillivolts;
+}
+
+void fake_watchdogExpire(void) {
+
+  if (watchdogHandler) watchdogHandler();
+}
+
+unsigned long fake_watchdogFeedCount(void) {
+
+  return watchdogFeeds;
+}
+
+void fake_supplySetMillivolts(uint16_t millivolts) {
+
+  supplyMillivolts = millivolts;
+}
+
+// The transfer in progress, finished by the virtual clock's alarm
+#define TWI_BYTE_TIME 25  // µs, nine bits at 400kHz with some slack
+
+static TwiDoneHandler twiDone = NULL;
+static uint8_t twiAddress;
+static uint8_t *twiData;
+static uint8_t twiWriteLength;
+static uint8_t twiReadLength;
+
+static void twiTransferEnded(void) {
+
+  uint8_t byteCount;
+  HalTwiResult result = fake_hih6100Transfer(twiAddress, twiData, twiWriteLength, twiReadLength, &byteCount);
+
+  if (twiDone) twiDone(result, byteCount);
+}
+
+void hal_twiBegin(uint32_t frequency, TwiDoneHandler done) {
+
+  twiDone = done;
+}
+
+void hal_twiStart(uint8_t address, uint8_t *data, uint8_t writeLength, uint8_t readLength) {
+
+  twiAddress = address;
+  twiData = data;
+  twiWriteLength = writeLength;
+  twiReadLength = readLength;
+
+  // Address, data, and the address again after a repeated start
+  uint8_t bytes = 1 + writeLength + readLength + ((writeLength > 0 && readLength > 0) ? 1 : 0);
+  fake_clockSetAlarm(fake_clockMicros() + bytes * TWI_BYTE_TIME, twiTransferEnded);
+}
+
+void hal_twiReset(void) {
+
+  fake_clockSetAlarm(UINT64_MAX, NULL);
+}
+
+void hal_shiftRegisterWrite(uint8_t latchPin, uint8_t dataPin, uint8_t clockPin, uint8_t value) {
+
+  digitalWrite(latchPin, LOW);
+  shiftOut(dataPin, clockPin, LSBFIRST, value);
+  digitalWrite(latchPin, HIGH);
+
+  shiftRegisterState = value;
+}
+
+uint8_t fake_shiftRegisterState(void) {
+
+  return shiftRegisterState;
+}
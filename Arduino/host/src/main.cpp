@@ -0,0 +1,1048 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "host_fakes.h"
+#include "constants.h"
+#include "lib_ble.h"
+#include "lib_scheduler.h"
+#include "lib_autotune.h"
+#include "lib_fixed.h"
+#include "lib_configStore.h"
+#include "lib_history.h"
+#include "lib_bulkTransfer.h"
+#include "lib_fsm.h"
+#include "lib_power.h"
+#include "lib_profiler.h"
+#include "lib_twi.h"
+#include "lib_sensorArray.h"
+#include "lib_sampler.h"
+#include "lib_ventStrategy.h"
+#include "services.h"
+#include "simulator.h"
+
+// Host runner
+// -------------------------------------------------
+// Runs setup() and loop() against the fakes for a span of virtual time, jumping the clock
+//   straight to the next scheduled task or radio event whenever the sketch has nothing to do.
+//   The plant model is stepped alongside and its interior feeds the simulated sensors, so
+//   the sketch's own control path closes the loop.
+//
+//   greenhouse_host [--hours N] [--weather constant|diurnal|front|FILE.csv] [--log FILE|-]
+//                   [--log-interval SECONDS] [--noise] [--seed N] [--autotune-at HOURS]
+//                   [--radio-hang-at HOURS] [--no-client] [--download-history] [--bulk-download] [--phase-timing]
+//                   [--sampling MIN MAX] [--sampling-report] [--feed-forward HUMIDITY TEMPERATURE]
+//                   [--vent-strategy pid|hysteresis] [--vent-thresholds THRESHOLD OVERSHOOT TARGET] [--actuation-report]
+//                   [--config-report] [--ble-report] [--verbose]
+//
+//   --download-history connects a client after the run, if there wasn't one, and fetches and
+//   decodes the sample history through the bulk transfer, the way the app would on
+//   reconnecting.  --bulk-download fetches every bulk transfer stream, interrupting and
+//   resuming the first one halfway.
+//   --phase-timing reads the profiler's statistics back through the Diagnostics Report characteristic.
+//   --sampling writes the adaptive sampling interval's bounds, in seconds, when the client connects,
+//   equal bounds give a fixed rate.  --sampling-report reads the sampler's counts back the same way.
+//   --feed-forward writes the vent's exterior-trend gains the same way, 0 0 for the PID alone.
+//   --vent-strategy and --vent-thresholds select the vent strategy and the hysteresis band, the overshoot
+//   in % of the threshold.  --actuation-report reads the actuation counts back.
+//   --config-report reads the configuration store's edit and EEPROM counts back.  --ble-report reads the
+//   notification queue's sent and dropped counts, and the pipe writes sent and suppressed, as the sketch reports them.
+//   --radio-hang-at stops the simulated nRF8001 answering, until the sketch re-initialises it.
+
+#define ZONE_TEMPERATURE_SPREAD 2.0f  // °C from the coolest interior zone to the warmest, when there are several
+#define ZONE_HUMIDITY_SPREAD 6.0f  // % RH
+#define LIGHT_BANK_1_PIN 5
+#define LIGHT_BANK_2_PIN 6
+
+#define PLANT_STEP 1.0f  // s of virtual time per model integration step
+
+// Reading-to-reading HIH6100 noise, one standard deviation, when --noise is given
+// NOTE: Much smaller than the datasheet accuracy, most of that is a fixed offset per part
+#define SENSOR_HUMIDITY_NOISE 0.2f  // % RH
+#define SENSOR_TEMPERATURE_NOISE 0.05f  // °C
+
+#define DOWNLOAD_TIME_LIMIT 120.0  // s of virtual time for connecting and fetching the history
+#define BULK_DOWNLOAD_MAX 1024  // bytes in one stream
+
+void setup(void);
+void loop(void);
+
+extern TaskScheduler scheduler;
+extern BLE BLE_board;
+extern UserConfig currentConfig;
+extern control_t ventingNecessity;
+extern ConfigStore configStore;
+extern SensorArray honeywellSensors;
+extern HistoryLog historyLog;
+extern FiniteStateMachine<ClimateState, ClimateStateCount, ClimateHooks> climateMachine;
+extern PowerMonitor powerMonitor;
+
+typedef struct {
+
+  double hours;
+  const char *weather;
+  const char *logPath;
+  double logInterval;  // s
+  boolean noise;
+  uint32_t seed;
+  double autotuneAt;  // h, < 0 for never
+  double radioHangAt;  // h, < 0 for never
+  boolean connectClient;
+  boolean downloadHistory;
+  boolean bulkDownload;
+  boolean phaseTiming;
+  int samplingMin;  // s, < 0 to leave the configured bounds
+  int samplingMax;
+  boolean samplingReport;
+  double feedForwardHumidity;  // < 0 to leave the configured gains
+  double feedForwardTemperature;
+  int ventStrategy;  // VentStrategy, < 0 to leave the configured one
+  double ventThreshold;  // < 0 to leave the configured band
+  double ventOvershoot;  // % of the threshold
+  double ventTarget;
+  boolean actuationReport;
+  boolean configReport;
+  boolean bleReport;
+  boolean verbose;
+
+} RunOptions;
+
+typedef struct {
+
+  unsigned long samples;
+  double temperatureError;  // Sums of absolute deviation from the setpoints
+  double humidityError;
+  double necessitySquared;
+  double ventOpening;
+  float minTemperature, maxTemperature;
+  float minHumidity, maxHumidity;
+
+  // Venting necessity excursions the vent brought back, as ResponseMonitor measures them
+  unsigned long responses;
+  double settlingTotal;  // s
+  double overshootTotal;  // %
+
+} RunStatistics;
+
+// The history stream as a client keeps it, the EEPROM ring of blocks
+typedef struct {
+
+  uint8_t bytes[HISTORY_LOG_LENGTH];
+  boolean complete;
+  unsigned long fragments;
+
+} HistoryDownload;
+
+// One bulk transfer stream, reassembled
+typedef struct {
+
+  uint8_t bytes[BULK_DOWNLOAD_MAX];
+  uint16_t nextSequence;  // First fragment not yet received
+  unsigned long fragments;
+  BulkSummary summary;
+  boolean complete;
+
+} BulkDownload;
+
+// The phase timing reports, closing packet included
+typedef struct {
+
+  PhaseTimingReport reports[ProfilePhaseCount + 1];
+  uint8_t reportCount;
+  boolean complete;
+
+} PhaseTimingDownload;
+
+
+// NOISE
+// ----------------------------------------------------
+static uint32_t noiseState = 1;
+
+static float uniformNoise(void) {
+
+  // xorshift32, repeatable for a given --seed
+  noiseState ^= noiseState << 13;
+  noiseState ^= noiseState >> 17;
+  noiseState ^= noiseState << 5;
+
+  return (noiseState + 1.0f) / 4294967297.0f;
+}
+
+static float gaussianNoise(float deviation) {
+
+  return deviation * sqrtf(-2.0f * logf(uniformNoise())) * cosf(2.0f * (float) M_PI * uniformNoise());
+}
+
+
+// RUN
+// ----------------------------------------------------
+static boolean parseOptions(int argc, char **argv, RunOptions *options) {
+
+  options->hours = 24.0;
+  options->weather = "diurnal";
+  options->logPath = NULL;
+  options->logInterval = 60.0;
+  options->noise = false;
+  options->seed = 1;
+  options->autotuneAt = -1;
+  options->radioHangAt = -1;
+  options->connectClient = true;
+  options->downloadHistory = false;
+  options->bulkDownload = false;
+  options->phaseTiming = false;
+  options->samplingMin = -1;
+  options->samplingMax = -1;
+  options->samplingReport = false;
+  options->feedForwardHumidity = -1;
+  options->feedForwardTemperature = -1;
+  options->ventStrategy = -1;
+  options->ventThreshold = -1;
+  options->ventOvershoot = 0;
+  options->ventTarget = 0;
+  options->actuationReport = false;
+  options->configReport = false;
+  options->bleReport = false;
+  options->verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+
+    if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) options->hours = atof(argv[++i]);
+    else if (strcmp(argv[i], "--weather") == 0 && i + 1 < argc) options->weather = argv[++i];
+    else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) options->logPath = argv[++i];
+    else if (strcmp(argv[i], "--log-interval") == 0 && i + 1 < argc) options->logInterval = atof(argv[++i]);
+    else if (strcmp(argv[i], "--noise") == 0) options->noise = true;
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) options->seed = (uint32_t) strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--autotune-at") == 0 && i + 1 < argc) options->autotuneAt = atof(argv[++i]);
+    else if (strcmp(argv[i], "--radio-hang-at") == 0 && i + 1 < argc) options->radioHangAt = atof(argv[++i]);
+    else if (strcmp(argv[i], "--no-client") == 0) options->connectClient = false;
+    else if (strcmp(argv[i], "--download-history") == 0) options->downloadHistory = true;
+    else if (strcmp(argv[i], "--bulk-download") == 0) options->bulkDownload = true;
+    else if (strcmp(argv[i], "--phase-timing") == 0) options->phaseTiming = true;
+    else if (strcmp(argv[i], "--sampling") == 0 && i + 2 < argc) {
+
+      options->samplingMin = atoi(argv[++i]);
+      options->samplingMax = atoi(argv[++i]);
+
+    } else if (strcmp(argv[i], "--sampling-report") == 0) options->samplingReport = true;
+    else if (strcmp(argv[i], "--feed-forward") == 0 && i + 2 < argc) {
+
+      options->feedForwardHumidity = atof(argv[++i]);
+      options->feedForwardTemperature = atof(argv[++i]);
+
+    } else if (strcmp(argv[i], "--vent-strategy") == 0 && i + 1 < argc) {
+
+      i++;
+      if (strcmp(argv[i], "pid") == 0) options->ventStrategy = VentStrategyPID;
+      else if (strcmp(argv[i], "hysteresis") == 0) options->ventStrategy = VentStrategyHysteresis;
+      else return false;
+
+    } else if (strcmp(argv[i], "--vent-thresholds") == 0 && i + 3 < argc) {
+
+      options->ventThreshold = atof(argv[++i]);
+      options->ventOvershoot = atof(argv[++i]);
+      options->ventTarget = atof(argv[++i]);
+
+    } else if (strcmp(argv[i], "--actuation-report") == 0) options->actuationReport = true;
+    else if (strcmp(argv[i], "--config-report") == 0) options->configReport = true;
+    else if (strcmp(argv[i], "--ble-report") == 0) options->bleReport = true;
+    else if (strcmp(argv[i], "--verbose") == 0) options->verbose = true;
+    else return false;
+  }
+
+  // Written by the client
+  if ((options->samplingMin >= 0 || options->feedForwardHumidity >= 0 || options->ventStrategy >= 0 || options->ventThreshold >= 0) && !options->connectClient) return false;
+
+  return options->hours > 0 && options->logInterval > 0;
+}
+
+static void recordStatistics(RunStatistics *stats, GreenhousePlant *plant) {
+
+  if (stats->samples == 0) {
+
+    stats->minTemperature = stats->maxTemperature = plant->temperature;
+    stats->minHumidity = stats->maxHumidity = plant->humidity;
+  }
+
+  stats->samples++;
+  stats->temperatureError += fabs(plant->temperature - currentConfig.temperatureSetpoint);
+  stats->humidityError += fabs(plant->humidity - currentConfig.humiditySetpoint);
+  if (ventingNecessity != control_t(UNAVAILABLE_f)) {
+
+    double necessity = toFloat(ventingNecessity);
+    stats->necessitySquared += necessity * necessity;
+  }
+  stats->ventOpening += plant->ventOpening(fake_servoPosition());
+
+  if (plant->temperature < stats->minTemperature) stats->minTemperature = plant->temperature;
+  if (plant->temperature > stats->maxTemperature) stats->maxTemperature = plant->temperature;
+  if (plant->humidity < stats->minHumidity) stats->minHumidity = plant->humidity;
+  if (plant->humidity > stats->maxHumidity) stats->maxHumidity = plant->humidity;
+}
+
+static void recordDisturbance(RunStatistics *stats, ResponseMonitor *monitor, double seconds) {
+
+  if (ventingNecessity == control_t(UNAVAILABLE_f)) return;
+
+  if (monitor->update(toFloat(ventingNecessity), (unsigned long) (seconds * 1000))) {
+
+    stats->responses++;
+    stats->settlingTotal += monitor->settlingTime;
+    stats->overshootTotal += monitor->overshoot;
+  }
+}
+
+static void logTrajectory(FILE *log, double seconds, WeatherSample exterior, GreenhousePlant *plant, uint8_t lightBanksOn) {
+
+  fprintf(log, "%.0f,%.2f,%.1f,%.0f,%.3f,%.2f,%d,%d,%.4f\n", seconds,
+          exterior.temperature, exterior.humidity, exterior.solar,
+          plant->temperature, plant->humidity,
+          fake_servoPosition(), lightBanksOn,
+          (ventingNecessity == control_t(UNAVAILABLE_f)) ? 0.0f : toFloat(ventingNecessity));
+}
+
+static void skipIdleTime(uint64_t endMicros, uint64_t alsoWakeAt) {
+
+  // Nothing to do until the next task release or radio event, skip ahead to it
+  if (!fake_radioIdle() || BLE_board.notificationQueueDepth() != 0 || !twiBus.idle()) return;
+
+  // Not asleep only because the last poll handled an event, the next loop() polls again and
+  //   sleeps if the radio has gone quiet, which the power statistics should see
+  static boolean pollAgain = true;
+  if (!BLE_board.readyToSleep() && pollAgain) {
+
+    pollAgain = false;
+    return;
+  }
+  pollAgain = true;
+
+  uint64_t nextTask = ((uint64_t) millis() + scheduler.millisUntilNextTask(millis())) * 1000;
+  uint64_t next = fake_radioNextEventMicros();
+  if (nextTask < next) next = nextTask;
+  if (alsoWakeAt < next) next = alsoWakeAt;
+  if (next > endMicros) next = endMicros;
+
+  if (next > fake_clockMicros()) fake_clockAdvanceMicros(next - fake_clockMicros());
+}
+
+
+// CLIENT
+// ----------------------------------------------------
+static boolean runUntil(boolean (*done)(void), uint64_t limitMicros) {
+
+  fake_sleepSetWakeLimit(limitMicros);
+
+  while (!done() && fake_clockMicros() < limitMicros) {
+
+    loop();
+    skipIdleTime(limitMicros, UINT64_MAX);
+  }
+
+  return done();
+}
+
+static boolean connectForDownload(void) {
+
+  // Reconnect if the run had no client, and wait for it to subscribe
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+
+  fake_radioConnectClient(true);
+  return runUntil(fake_radioClientSubscribed, limitMicros);
+}
+
+
+// BULK TRANSFER
+// ----------------------------------------------------
+static BulkDownload bulk;
+
+static boolean bulkStreamComplete(void) {
+
+  return bulk.complete;
+}
+
+static void receiveBulkFragment(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (pipe != PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_TX || byteCount < offsetof(BulkFragment, data)) return;
+
+  const BulkFragment *fragment = (const BulkFragment *) bytes;
+
+  if (fragment->sequence == BULK_SEQUENCE_END && byteCount == sizeof(BulkSummary)) {
+
+    memcpy(&bulk.summary, bytes, sizeof(BulkSummary));
+    bulk.complete = true;
+    return;
+  }
+
+  // A client only keeps fragments in order, anything after a gap is fetched again by resuming
+  uint32_t offset = (uint32_t) fragment->sequence * BULK_FRAGMENT_PAYLOAD;
+  uint8_t length = byteCount - offsetof(BulkFragment, data);
+  if (fragment->sequence != bulk.nextSequence || offset + length > BULK_DOWNLOAD_MAX) return;
+
+  memcpy(&bulk.bytes[offset], fragment->data, length);
+  bulk.nextSequence++;
+  bulk.fragments++;
+}
+
+static void requestBulkStream(uint8_t stream, uint16_t fromSequence) {
+
+  uint8_t command[4] = { BULK_COMMAND_START, stream, (uint8_t) (fromSequence & 0xFF), (uint8_t) (fromSequence >> 8) };
+  fake_radioWrite(PIPE_GREENHOUSE_TRANSFER_BULK_TRANSFER_RX_ACK_AUTO, command, sizeof(command));
+}
+
+static uint16_t bulkCRC(void) {
+
+  uint16_t crc = 0xFFFF;
+  for (uint32_t i = 0; i < bulk.summary.length && i < BULK_DOWNLOAD_MAX; i++) crc = crc16Update(crc, bulk.bytes[i]);
+
+  return crc;
+}
+
+static void bulkDownload(FILE *report, uint8_t stream, const char *name, boolean interrupt) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  uint64_t started = fake_clockMicros();
+  memset(&bulk, 0, sizeof(bulk));
+
+  requestBulkStream(stream, 0);
+
+  // Drop the link partway through, then pick up from the first missing fragment
+  uint16_t resumedAt = 0;
+  if (interrupt) {
+
+    fake_sleepSetWakeLimit(limitMicros);
+
+    while (bulk.fragments < 20 && !bulk.complete && fake_clockMicros() < limitMicros) {
+
+      loop();
+      skipIdleTime(limitMicros, UINT64_MAX);
+    }
+
+    fake_radioDisconnectClient();
+    connectForDownload();
+
+    resumedAt = bulk.nextSequence;
+    requestBulkStream(stream, resumedAt);
+  }
+
+  if (!runUntil(bulkStreamComplete, limitMicros)) {
+
+    fprintf(report, "  %s: didn't finish, %lu fragments received\n", name, bulk.fragments);
+    return;
+  }
+
+  // The stream changed under the part we kept, e.g. a sample was logged, so fetch it all again
+  boolean refetched = false;
+  if (bulkCRC() != bulk.summary.crc) {
+
+    memset(&bulk, 0, sizeof(bulk));
+    requestBulkStream(stream, 0);
+    refetched = true;
+
+    if (!runUntil(bulkStreamComplete, limitMicros)) {
+
+      fprintf(report, "  %s: refetch didn't finish, %lu fragments received\n", name, bulk.fragments);
+      return;
+    }
+  }
+
+  fprintf(report, "  %s: %u bytes in %lu fragments", name, (unsigned) bulk.summary.length, bulk.fragments);
+  if (interrupt) fprintf(report, ", resumed at fragment %u", resumedAt);
+  if (refetched) fprintf(report, ", refetched after the CRC failed");
+  fprintf(report, ", CRC %s, %.2f s\n", (bulkCRC() == bulk.summary.crc) ? "ok" : "MISMATCH", (fake_clockMicros() - started) / 1e6);
+  fprintf(report, "    device reports %u B/s over %lu ms\n", bulk.summary.bytesPerSecond, (unsigned long) bulk.summary.elapsed);
+}
+
+// SAMPLE HISTORY
+// ----------------------------------------------------
+static HistoryDownload download;
+
+static boolean downloadHistory(void) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  memset(&download, 0, sizeof(download));
+  memset(&bulk, 0, sizeof(bulk));
+
+  requestBulkStream(BULK_STREAM_HISTORY, 0);
+
+  download.complete = runUntil(bulkStreamComplete, limitMicros) && bulk.summary.length == HISTORY_LOG_LENGTH && bulkCRC() == bulk.summary.crc;
+  download.fragments = bulk.fragments;
+  if (download.complete) memcpy(download.bytes, bulk.bytes, HISTORY_LOG_LENGTH);
+
+  return download.complete;
+}
+
+// DIAGNOSTICS
+// ----------------------------------------------------
+// The Diagnostics Report characteristic's traffic leads with the report it's for
+static void requestDiagnostics(uint8_t reportID, uint8_t command) {
+
+  uint8_t request[2] = { reportID, command };
+  fake_radioWrite(PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_RX_ACK_AUTO, request, sizeof(request));
+}
+
+static boolean isDiagnostics(uint8_t reportID, size_t length, uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  return pipe == PIPE_GREENHOUSE_DIAGNOSTICS_REPORT_TX && byteCount == 1 + length && bytes[0] == reportID;
+}
+
+// PHASE TIMING
+// ----------------------------------------------------
+static PhaseTimingDownload phaseTiming;
+
+static boolean phaseTimingReceived(void) {
+
+  return phaseTiming.complete;
+}
+
+static void receivePhaseTiming(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!isDiagnostics(DIAGNOSTICS_REPORT_PHASE_TIMING, sizeof(PhaseTimingReport), pipe, bytes, byteCount)) return;
+
+  PhaseTimingReport *report = &phaseTiming.reports[phaseTiming.reportCount];
+  memcpy(report, bytes + 1, sizeof(PhaseTimingReport));
+
+  if (report->phase == PROFILE_REPORT_END) phaseTiming.complete = true;
+  else if (phaseTiming.reportCount < ProfilePhaseCount) phaseTiming.reportCount++;
+}
+
+static void reportPhaseTiming(FILE *report) {
+
+  static const char *names[ProfilePhaseCount] = { "measurements", "analysis", "illumination", "ACI response", "data credit" };
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  memset(&phaseTiming, 0, sizeof(phaseTiming));
+
+  requestDiagnostics(DIAGNOSTICS_REPORT_PHASE_TIMING, PROFILE_COMMAND_REPORT);
+
+  if (!runUntil(phaseTimingReceived, limitMicros)) {
+
+    fprintf(report, "\nPhase timing: no report\n");
+    return;
+  }
+
+  fprintf(report, "\nPhase timing (%.1f h since reset, virtual time)\n", phaseTiming.reports[phaseTiming.reportCount].count / 3600000.0);
+  if (phaseTiming.reportCount == 0) fprintf(report, "  probes compiled out, see GREENHOUSE_PROFILING\n");
+
+  for (uint8_t i = 0; i < phaseTiming.reportCount; i++) {
+
+    const PhaseTimingReport *phase = &phaseTiming.reports[i];
+    fprintf(report, "  %-13s count %lu, min %lu us, mean %lu us, max %lu us\n", (phase->phase < ProfilePhaseCount) ? names[phase->phase] : "?",
+            (unsigned long) phase->count, (unsigned long) phase->minimum, (unsigned long) phase->mean, (unsigned long) phase->maximum);
+  }
+}
+
+// SAMPLING
+// ----------------------------------------------------
+static SamplingReport sampling;
+static boolean samplingReceived;
+
+static boolean samplingReportReceived(void) {
+
+  return samplingReceived;
+}
+
+static void receiveSamplingReport(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!isDiagnostics(DIAGNOSTICS_REPORT_SAMPLING, sizeof(SamplingReport), pipe, bytes, byteCount)) return;
+
+  memcpy(&sampling, bytes + 1, sizeof(SamplingReport));
+  samplingReceived = true;
+}
+
+static void reportSampling(FILE *report) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  samplingReceived = false;
+
+  requestDiagnostics(DIAGNOSTICS_REPORT_SAMPLING, SAMPLING_COMMAND_REPORT);
+
+  if (!runUntil(samplingReportReceived, limitMicros)) {
+
+    fprintf(report, "\nSampling: no report\n");
+    return;
+  }
+
+  fprintf(report, "\nSampling (%.1f h since reset, bounds %u..%u s)\n", sampling.elapsed / 3600.0, sampling.minimum, sampling.maximum);
+  fprintf(report, "  %lu samples, %lu at the fixed %lu ms rate, %.1f%% saved; %u interval changes, now %u ms\n",
+          (unsigned long) sampling.sampleCount, (unsigned long) sampling.fixedRateSampleCount, SAMPLING_INTERVAL,
+          sampling.fixedRateSampleCount ? 100.0 * (1.0 - (double) sampling.sampleCount / sampling.fixedRateSampleCount) : 0.0,
+          sampling.changeCount, sampling.interval);
+}
+
+// VENT ACTUATIONS
+// ----------------------------------------------------
+static ActuationReport actuations;
+static boolean actuationsReceived;
+
+static boolean actuationReportReceived(void) {
+
+  return actuationsReceived;
+}
+
+static void receiveActuationReport(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!isDiagnostics(DIAGNOSTICS_REPORT_ACTUATIONS, sizeof(ActuationReport), pipe, bytes, byteCount)) return;
+
+  memcpy(&actuations, bytes + 1, sizeof(ActuationReport));
+  actuationsReceived = true;
+}
+
+static void reportActuations(FILE *report) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  actuationsReceived = false;
+
+  requestDiagnostics(DIAGNOSTICS_REPORT_ACTUATIONS, ACTUATIONS_COMMAND_REPORT);
+
+  if (!runUntil(actuationReportReceived, limitMicros)) {
+
+    fprintf(report, "\nVent actuations: no report\n");
+    return;
+  }
+
+  fprintf(report, "\nVent actuations (%s, %.1f h since reset)\n", (actuations.strategy == VentStrategyHysteresis) ? "hysteresis" : "PID", actuations.elapsed / 3600.0);
+  fprintf(report, "  %lu moves, %.1f per hour, travel %lu deg\n", (unsigned long) actuations.actuations, actuations.actuationsPerHour, (unsigned long) actuations.travel);
+}
+
+// CONFIG STORE
+// ----------------------------------------------------
+static ConfigReport configCounts;
+static boolean configCountsReceived;
+
+static boolean configReportReceived(void) {
+
+  return configCountsReceived;
+}
+
+static void receiveConfigReport(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!isDiagnostics(DIAGNOSTICS_REPORT_CONFIG, sizeof(ConfigReport), pipe, bytes, byteCount)) return;
+
+  memcpy(&configCounts, bytes + 1, sizeof(ConfigReport));
+  configCountsReceived = true;
+}
+
+static void reportConfig(FILE *report) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  configCountsReceived = false;
+
+  requestDiagnostics(DIAGNOSTICS_REPORT_CONFIG, CONFIG_COMMAND_REPORT);
+
+  if (!runUntil(configReportReceived, limitMicros)) {
+
+    fprintf(report, "\nConfig store: no report\n");
+    return;
+  }
+
+  fprintf(report, "\nConfig store (%u slots)\n", configCounts.slotCount);
+  fprintf(report, "  %lu edits committed in %u records, %u pending; %lu EEPROM bytes written\n", (unsigned long) configCounts.committedChanges,
+          configCounts.persistCount, configCounts.pendingChanges, (unsigned long) configCounts.totalBytesWritten);
+}
+
+// BLE
+// ----------------------------------------------------
+static BLEReport bleCounts;
+static boolean bleCountsReceived;
+
+static boolean bleReportReceived(void) {
+
+  return bleCountsReceived;
+}
+
+static void receiveBLEReport(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  if (!isDiagnostics(DIAGNOSTICS_REPORT_BLE, sizeof(BLEReport), pipe, bytes, byteCount)) return;
+
+  memcpy(&bleCounts, bytes + 1, sizeof(BLEReport));
+  bleCountsReceived = true;
+}
+
+static void reportBLE(FILE *report) {
+
+  uint64_t limitMicros = fake_clockMicros() + (uint64_t) (DOWNLOAD_TIME_LIMIT * 1e6);
+  bleCountsReceived = false;
+
+  requestDiagnostics(DIAGNOSTICS_REPORT_BLE, BLE_COMMAND_REPORT);
+
+  if (!runUntil(bleReportReceived, limitMicros)) {
+
+    fprintf(report, "\nBLE: no report\n");
+    return;
+  }
+
+  fprintf(report, "\nBLE (over BLE, %u queued)\n", bleCounts.queueDepth);
+  fprintf(report, "  notifications sent %lu, dropped %lu; pipe writes sent %lu, suppressed %lu\n", (unsigned long) bleCounts.notificationsSent,
+          (unsigned long) bleCounts.notificationsDropped, (unsigned long) bleCounts.pipeWritesSent, (unsigned long) bleCounts.pipeWritesSuppressed);
+}
+
+static void receiveNotification(uint8_t pipe, const uint8_t *bytes, uint8_t byteCount) {
+
+  receiveBulkFragment(pipe, bytes, byteCount);
+  receivePhaseTiming(pipe, bytes, byteCount);
+  receiveSamplingReport(pipe, bytes, byteCount);
+  receiveActuationReport(pipe, bytes, byteCount);
+  receiveConfigReport(pipe, bytes, byteCount);
+  receiveBLEReport(pipe, bytes, byteCount);
+}
+
+
+// REPORT
+// ----------------------------------------------------
+static void reportHistory(FILE *report, double downloadSeconds) {
+
+  unsigned long samples = 0, sampleBytes = 0, decodeErrors = 0;
+  unsigned blockCount = 0;
+  uint32_t firstTime = 0, lastTime = 0;
+  int32_t minTemperature = INT32_MAX, maxTemperature = INT32_MIN;
+
+  // Blocks in ring order, the samples' times place them
+  for (uint8_t block = 0; download.complete && block < HISTORY_LOG_LENGTH / HISTORY_BLOCK_SIZE; block++) {
+
+    const uint8_t *bytes = download.bytes + block * HISTORY_BLOCK_SIZE;
+    HistoryBlockHeader header;
+    memcpy(&header, bytes, sizeof(HistoryBlockHeader));
+
+    if (!historyHeaderValid(&header) || header.sampleCount == 0) continue;  // Never used, or emptied for reuse
+    blockCount++;
+
+    int32_t values[HistoryChannelCount] = { 0 };
+    uint8_t offset = sizeof(HistoryBlockHeader);
+
+    for (uint8_t sample = 0; sample < header.sampleCount; sample++) {
+
+      for (uint8_t channel = 0; channel < HistoryChannelCount; channel++) {
+
+        int32_t delta;
+        uint8_t used = historyVarintDecode(bytes + offset, HISTORY_BLOCK_SIZE - offset, &delta);
+        if (used == 0) {
+
+          decodeErrors++;
+          sample = header.sampleCount;
+          break;
+        }
+        offset += used;
+        values[channel] += delta;
+      }
+      if (sample == header.sampleCount) break;
+
+      uint32_t time = header.startTime + (uint32_t) sample * header.interval;
+      if (samples == 0 || time < firstTime) firstTime = time;
+      if (time + header.interval > lastTime) lastTime = time + header.interval;
+      samples++;
+
+      int32_t temperature = values[HistoryChannelInteriorTemperature];
+      if (temperature != HISTORY_VALUE_UNAVAILABLE) {
+
+        if (temperature < minTemperature) minTemperature = temperature;
+        if (temperature > maxTemperature) maxTemperature = temperature;
+      }
+    }
+
+    sampleBytes += offset - sizeof(HistoryBlockHeader);
+  }
+
+  fprintf(report, "\nSample history\n");
+  fprintf(report, "  logged %lu samples, %.1f bytes each, %u blocks of %d bytes\n", historyLog.samplesLogged,
+          historyLog.samplesLogged ? (double) historyLog.bytesLogged / historyLog.samplesLogged : 0.0, historyLog.blockCount, HISTORY_BLOCK_SIZE);
+
+  if (!download.complete) {
+
+    fprintf(report, "  download didn't finish, %lu fragments received\n", download.fragments);
+    return;
+  }
+
+  fprintf(report, "  downloaded %d bytes in %lu fragments, %.1f s\n", HISTORY_LOG_LENGTH, download.fragments, downloadSeconds);
+  fprintf(report, "  decoded %u blocks, %lu samples covering %.1f h, %.1f bytes each, %lu errors\n", blockCount, samples, (lastTime - firstTime) / 3600.0,
+          samples ? (double) sampleBytes / samples : 0.0, decodeErrors);
+  if (minTemperature <= maxTemperature) fprintf(report, "  interior temperature %.1f..%.1f°C\n", minTemperature / 10.0, maxTemperature / 10.0);
+}
+
+
+// MAIN
+// ----------------------------------------------------
+int main(int argc, char **argv) {
+
+  RunOptions options;
+  if (!parseOptions(argc, argv, &options)) {
+
+    fprintf(stderr, "usage: %s [--hours N] [--weather constant|diurnal|front|FILE.csv] [--log FILE|-]\n"
+                    "       [--log-interval SECONDS] [--noise] [--seed N] [--autotune-at HOURS]\n"
+                    "       [--radio-hang-at HOURS] [--no-client] [--download-history] [--bulk-download] [--phase-timing]\n"
+                    "       [--sampling MIN MAX] [--sampling-report] [--feed-forward HUMIDITY TEMPERATURE]\n"
+                    "       [--vent-strategy pid|hysteresis] [--vent-thresholds THRESHOLD OVERSHOOT TARGET] [--actuation-report] [--verbose]\n", argv[0]);
+    return 1;
+  }
+
+  WeatherProfile weather;
+  if (!weather.useScriptNamed(options.weather) && !weather.loadCSV(options.weather)) {
+
+    fprintf(stderr, "Can't read weather '%s'\n", options.weather);
+    return 1;
+  }
+
+  FILE *log = NULL;
+  if (options.logPath != NULL) {
+
+    log = (strcmp(options.logPath, "-") == 0) ? stdout : fopen(options.logPath, "w");
+    if (log == NULL) {
+
+      fprintf(stderr, "Can't write '%s'\n", options.logPath);
+      return 1;
+    }
+    fprintf(log, "seconds,exterior_temperature,exterior_humidity,solar,interior_temperature,interior_humidity,vent_angle,light_banks,venting_necessity\n");
+  }
+
+  fake_serialSetEcho(options.verbose);
+  noiseState = options.seed ? options.seed : 1;
+
+  // Start the interior where the exterior is, as if the door had just been shut
+  GreenhousePlant plant;
+  WeatherSample exterior = weather.sampleAt(0);
+  plant.reset(exterior.temperature, exterior.humidity);
+
+  RunStatistics stats;
+  memset(&stats, 0, sizeof(stats));
+  ResponseMonitor disturbance(RESPONSE_TRIGGER_ERROR);  // Against the PID's setpoint of zero
+
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+  setup();
+  if (options.connectClient) fake_radioConnectClient(true);
+
+  boolean samplingWritten = (options.samplingMin < 0);
+  boolean feedForwardWritten = (options.feedForwardHumidity < 0);
+  boolean ventStrategyWritten = (options.ventStrategy < 0 && options.ventThreshold < 0);
+
+  uint64_t endMicros = (uint64_t) (options.hours * 3600.0 * 1e6);
+  uint64_t autotuneMicros = (options.autotuneAt >= 0) ? (uint64_t) (options.autotuneAt * 3600.0 * 1e6) : UINT64_MAX;
+  uint64_t radioHangMicros = (options.radioHangAt >= 0) ? (uint64_t) (options.radioHangAt * 3600.0 * 1e6) : UINT64_MAX;
+  uint64_t plantMicros = 0;
+  double nextLog = 0;
+  unsigned long loopCount = 0;
+
+  while (fake_clockMicros() < endMicros) {
+
+    // Bring the plant up to the present, the sensors read whatever it was at the last step
+    while (plantMicros + (uint64_t) (PLANT_STEP * 1e6) <= fake_clockMicros()) {
+
+      double seconds = plantMicros / 1e6;
+      uint8_t lightBanksOn = (fake_pinState(LIGHT_BANK_1_PIN) == HIGH) + (fake_pinState(LIGHT_BANK_2_PIN) == HIGH);
+
+      exterior = weather.sampleAt(seconds);
+      plant.step(PLANT_STEP, exterior, fake_servoPosition(), lightBanksOn);
+      plantMicros += (uint64_t) (PLANT_STEP * 1e6);
+      recordDisturbance(&stats, &disturbance, seconds);
+
+      float exteriorNoise = options.noise ? gaussianNoise(SENSOR_TEMPERATURE_NOISE) : 0.0f;
+      float interiorNoise = options.noise ? gaussianNoise(SENSOR_TEMPERATURE_NOISE) : 0.0f;
+      float exteriorHumidityNoise = options.noise ? gaussianNoise(SENSOR_HUMIDITY_NOISE) : 0.0f;
+      float interiorHumidityNoise = options.noise ? gaussianNoise(SENSOR_HUMIDITY_NOISE) : 0.0f;
+
+      fake_hih6100SetReading(EXTERIOR_SENSOR_OUTPUT, exterior.humidity + exteriorHumidityNoise, exterior.temperature + exteriorNoise);
+
+      // The plant model is well mixed, extra zones read it with an even spread either side
+      for (uint8_t zone = 0; zone < INTERIOR_ZONE_COUNT; zone++) {
+
+        float position = (INTERIOR_ZONE_COUNT > 1) ? (float) zone / (INTERIOR_ZONE_COUNT - 1) - 0.5f : 0.0f;
+
+        if (zone > 0 && options.noise) {
+
+          interiorNoise = gaussianNoise(SENSOR_TEMPERATURE_NOISE);
+          interiorHumidityNoise = gaussianNoise(SENSOR_HUMIDITY_NOISE);
+        }
+
+        fake_hih6100SetReading(INTERIOR_ZONE_OUTPUT(zone), plant.humidity + position * ZONE_HUMIDITY_SPREAD + interiorHumidityNoise,
+                               plant.temperature + position * ZONE_TEMPERATURE_SPREAD + interiorNoise);
+      }
+
+      if (seconds >= nextLog) {
+
+        recordStatistics(&stats, &plant);
+        if (log != NULL) logTrajectory(log, seconds, exterior, &plant, lightBanksOn);
+        nextLog += options.logInterval;
+      }
+    }
+
+    // The app's settings screen, as soon as the client has subscribed
+    if (!samplingWritten && fake_radioClientSubscribed()) {
+
+      uint8_t bounds[2] = { (uint8_t) options.samplingMin, (uint8_t) options.samplingMax };
+      fake_radioWrite(PIPE_GREENHOUSE_USER_ADJUSTMENTS_SAMPLING_BOUNDS_RX_ACK_AUTO, bounds, sizeof(bounds));
+      samplingWritten = true;
+    }
+
+    if (!feedForwardWritten && fake_radioClientSubscribed()) {
+
+      float gains[2] = { (float) options.feedForwardHumidity, (float) options.feedForwardTemperature };
+      fake_radioWrite(PIPE_GREENHOUSE_CONTROLS_FEED_FORWARD_GAINS_RX_ACK_AUTO, (uint8_t *) gains, sizeof(gains));
+      feedForwardWritten = true;
+    }
+
+    // The band first, so the strategy starts out with it
+    if (!ventStrategyWritten && fake_radioClientSubscribed()) {
+
+      if (options.ventThreshold >= 0) {
+
+        float band[3] = { (float) options.ventThreshold, (float) options.ventOvershoot, (float) options.ventTarget };
+        fake_radioWrite(PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_THRESHOLD_RX_ACK_AUTO, (uint8_t *) &band[0], sizeof(float));
+        fake_radioWrite(PIPE_GREENHOUSE_USER_ADJUSTMENTS_VENTING_NECESSITY_OVERSHOOT_RX_ACK_AUTO, (uint8_t *) &band[1], sizeof(float));
+        fake_radioWrite(PIPE_GREENHOUSE_USER_ADJUSTMENTS_TARGET_VENTING_NECESSITY_RX_ACK_AUTO, (uint8_t *) &band[2], sizeof(float));
+      }
+
+      if (options.ventStrategy >= 0) {
+
+        uint8_t strategy = options.ventStrategy;
+        fake_radioWrite(PIPE_GREENHOUSE_CONTROLS_VENT_STRATEGY_RX_ACK_AUTO, &strategy, 1);
+      }
+
+      ventStrategyWritten = true;
+    }
+
+    // Start autotuning the way the app would, by writing the command to the characteristic
+    if (fake_clockMicros() >= autotuneMicros) {
+
+      uint8_t command = AUTOTUNE_COMMAND_START;
+      fake_radioWrite(PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_RX_ACK_AUTO, &command, 1);
+      autotuneMicros = UINT64_MAX;
+    }
+
+    if (fake_clockMicros() >= radioHangMicros) {
+
+      fake_radioHang();
+      radioHangMicros = UINT64_MAX;
+    }
+
+    uint64_t nextIntervention = (autotuneMicros < radioHangMicros) ? autotuneMicros : radioHangMicros;
+
+    // The sketch sleeps through to its next task, but no further than the runner's next step
+    fake_sleepSetWakeLimit((nextIntervention < endMicros) ? nextIntervention : endMicros);
+
+    loop();
+    loopCount++;
+
+    skipIdleTime(endMicros, nextIntervention);
+  }
+
+  // After the run, as a client coming back into range would
+  double downloadSeconds = 0;
+  if (options.downloadHistory || options.bulkDownload || options.phaseTiming || options.samplingReport || options.actuationReport || options.configReport || options.bleReport) {
+
+    fake_radioSetNotificationObserver(receiveNotification);
+    connectForDownload();
+  }
+
+  if (options.downloadHistory) {
+
+    uint64_t downloadStart = fake_clockMicros();
+    downloadHistory();
+    downloadSeconds = (fake_clockMicros() - downloadStart) / 1e6;
+  }
+
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double virtualSeconds = fake_clockMicros() / 1e6;
+
+  if (log != NULL && log != stdout) fclose(log);
+  FILE *report = (log == stdout) ? stderr : stdout;  // Keep a piped trajectory clean
+
+  fake_serialSetEcho(report == stdout);
+
+  fprintf(report, "\nVirtual time:   %.1f h in %.3f s wall (%.0fx real time)\n", virtualSeconds / 3600.0, wallSeconds, virtualSeconds / wallSeconds);
+  fprintf(report, "loop() calls:   %lu\n", loopCount);
+
+  if (stats.samples > 0) {
+
+    fprintf(report, "\nClimate (%s, setpoints %.1f°C %.1f%% RH)\n", options.weather, currentConfig.temperatureSetpoint, currentConfig.humiditySetpoint);
+    fprintf(report, "  interior temperature %.2f..%.2f°C, mean |error| %.2f°C\n", stats.minTemperature, stats.maxTemperature, stats.temperatureError / stats.samples);
+    fprintf(report, "  interior humidity %.1f..%.1f%% RH, mean |error| %.1f%% RH\n", stats.minHumidity, stats.maxHumidity, stats.humidityError / stats.samples);
+    fprintf(report, "  venting necessity RMS %.3f, mean vent opening %.0f%%\n", sqrt(stats.necessitySquared / stats.samples), 100.0 * stats.ventOpening / stats.samples);
+    fprintf(report, "  disturbances rejected %lu, mean settling %.0f s, mean overshoot %.0f%%; feed-forward gains %.1f, %.1f\n", stats.responses,
+            stats.responses ? stats.settlingTotal / stats.responses : 0.0, stats.responses ? stats.overshootTotal / stats.responses : 0.0,
+            currentConfig.ventFeedForwardHumidity, currentConfig.ventFeedForwardTemperature);
+    fprintf(report, "  climate state changes %lu, %lu rerouted through steady; entered steady %u, +RH %u, -RH %u, +T %u, -T %u\n",
+            climateMachine.transitionCount, climateMachine.rejectedCount,
+            climateMachine.entryCounts[ClimateStateSteady], climateMachine.entryCounts[ClimateStateIncreasingHumidity],
+            climateMachine.entryCounts[ClimateStateDecreasingHumidity], climateMachine.entryCounts[ClimateStateIncreasingTemperature],
+            climateMachine.entryCounts[ClimateStateDecreasingTemperature]);
+  }
+
+  TuningReport tuning;
+  if (fake_radioLastNotification(PIPE_GREENHOUSE_CONTROLS_VENT_PID_TUNING_TX, (uint8_t *) &tuning) == sizeof(TuningReport)) {
+
+    static const char *states[] = { "idle", "running", "succeeded", "failed", "aborted" };
+
+    fprintf(report, "\nVent PID autotune %s: Kp %.3f, Ki %.5f/s, Kd %.2fs\n", (tuning.state <= AutotuneStateAborted) ? states[tuning.state] : "?", tuning.kp, tuning.ki, tuning.kd);
+    fprintf(report, "  before: settling %us, overshoot %u%%\n", tuning.settlingTimeBefore, tuning.overshootBefore);
+    fprintf(report, "  after:  settling %us, overshoot %u%%\n", tuning.settlingTimeAfter, tuning.overshootAfter);
+  }
+
+  if (report == stdout) {
+
+    fprintf(report, "\nScheduler\n");
+    fflush(report);
+    scheduler.printStatistics();
+  }
+
+  fprintf(report, "\nBLE\n");
+  fprintf(report, "  notifications sent %lu, dropped %lu, radio packets %lu (%lu bytes)\n",
+          BLE_board.sentNotificationCount(), BLE_board.droppedNotificationCount(),
+          fake_radioNotificationCount(), fake_radioNotificationBytes());
+  fprintf(report, "  pipe writes sent %lu, suppressed %lu, set local data %lu\n",
+          BLE_board.sentPipeWriteCount(), BLE_board.suppressedPipeWriteCount(), fake_radioLocalDataCount());
+  fprintf(report, "  time-outs: command response %lu, data credit %lu; over budget %lu, radio re-initialised %lu\n",
+          BLE_board.timeoutCount(BLETimeoutCommandResponse), BLE_board.timeoutCount(BLETimeoutDataCredit),
+          BLE_board.overBudgetCount(), BLE_board.radioReinitCount());
+
+  unsigned long sleptMillis = powerMonitor.totalIdleMillis + powerMonitor.totalPowerDownMillis;
+  unsigned long coveredMillis = powerMonitor.totalAwakeMillis + sleptMillis;
+
+  if (coveredMillis > 0) {
+
+    fprintf(report, "\nPower (MCU only, estimated)\n");
+    fprintf(report, "  awake %.2f%%, idle %.2f%%, power-down %.2f%%; last cycle awake %lu us, %u uA\n",
+            100.0 * powerMonitor.totalAwakeMillis / coveredMillis, 100.0 * powerMonitor.totalIdleMillis / coveredMillis,
+            100.0 * powerMonitor.totalPowerDownMillis / coveredMillis, powerMonitor.cycleAwakeMicros, powerMonitor.cycleMicroamps);
+    fprintf(report, "  average %.0f uA; sleeps %lu (idle %lu, power-down %lu), %lu cut short by the radio\n",
+            ((double) powerMonitor.totalAwakeMillis * MCU_ACTIVE_MICROAMPS + (double) powerMonitor.totalIdleMillis * MCU_IDLE_MICROAMPS
+              + (double) powerMonitor.totalPowerDownMillis * MCU_POWER_DOWN_MICROAMPS) / coveredMillis,
+            powerMonitor.sleepCount, fake_sleepCount(HalSleepIdle), fake_sleepCount(HalSleepPowerDown), powerMonitor.radioWakeCount);
+  }
+
+  fprintf(report, "\nPeripherals\n");
+  fprintf(report, "  HIH6100 requests %lu, fetches %lu, failed reads %lu; TWI errors %lu, time-outs %lu\n", fake_hih6100RequestCount(), fake_hih6100FetchCount(),
+          honeywellSensors.failedReads, twiBus.errorCount, twiBus.timeoutCount);
+  fprintf(report, "  EEPROM writes %lu, worst cell %lu\n", fake_eepromWriteCount(), fake_eepromMaxCellWriteCount());
+  fprintf(report, "  config edits %lu committed in %u records, %u pending\n",
+          configStore.committedChanges, configStore.persistCount, configStore.pendingChanges);
+  fprintf(report, "  servo writes %lu, moves %lu, travel %lu deg, pulses %.1f%% of the time\n", fake_servoWriteCount(), fake_servoMoveCount(), fake_servoTravel(),
+          100.0 * fake_servoAttachedSeconds() / virtualSeconds);
+
+  if (options.downloadHistory) reportHistory(report, downloadSeconds);
+
+  if (options.bulkDownload) {
+
+    fprintf(report, "\nBulk transfer (link limit %d B/s, %d credits per %d ms)\n",
+            FAKE_RADIO_CREDITS * BULK_FRAGMENT_PAYLOAD * 1000 / FAKE_RADIO_CONNECTION_INTERVAL, FAKE_RADIO_CREDITS, FAKE_RADIO_CONNECTION_INTERVAL);
+    bulkDownload(report, BULK_STREAM_HISTORY, "history", true);
+    bulkDownload(report, BULK_STREAM_CONFIG, "config", false);
+  }
+
+  if (options.phaseTiming) reportPhaseTiming(report);
+  if (options.samplingReport) reportSampling(report);
+  if (options.actuationReport) reportActuations(report);
+  if (options.configReport) reportConfig(report);
+  if (options.bleReport) reportBLE(report);
+
+  fake_radioSetNotificationObserver(NULL);
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#include <stdio.h>
+
+#include "simulator.h"
+#include "constants.h"
+
+#define AIR_DENSITY 1.2f  // kg/m³
+#define AIR_SPECIFIC_HEAT 1005.0f  // J/(kg·K)
+#define SECONDS_PER_DAY 86400.0
+
+
+// PSYCHROMETRICS
+// ----------------------------------------------------
+
+// Magnus formula over water, good to ~0.1% between -40°C and 50°C
+float saturationVapourDensity(float temperature) {
+
+  float pressure = 611.2f * expf(17.62f * temperature / (243.12f + temperature));  // Pa
+  return 2.167f * pressure / (temperature + 273.15f);  // g/m³
+}
+
+
+// WEATHER
+// ----------------------------------------------------
+WeatherProfile::WeatherProfile(void) {
+
+  _script = WeatherScriptConstant;
+  _lastIndex = 0;
+}
+
+void WeatherProfile::useScript(WeatherScript script) {
+
+  _script = script;
+  _points.clear();
+}
+
+boolean WeatherProfile::useScriptNamed(const char *name) {
+
+  if (strcmp(name, "constant") == 0) useScript(WeatherScriptConstant);
+  else if (strcmp(name, "diurnal") == 0) useScript(WeatherScriptDiurnal);
+  else if (strcmp(name, "front") == 0) useScript(WeatherScriptColdFront);
+  else return false;
+
+  return true;
+}
+
+boolean WeatherProfile::loadCSV(const char *path) {
+
+  FILE *file = fopen(path, "r");
+  if (file == NULL) return false;
+
+  _points.clear();
+  _lastIndex = 0;
+
+  char line[256];
+  while (fgets(line, sizeof(line), file)) {
+
+    WeatherPoint point;
+    point.sample.solar = 0;
+
+    // Header and comment lines don't parse, skip them
+    int fields = sscanf(line, "%lf,%f,%f,%f", &point.seconds, &point.sample.temperature, &point.sample.humidity, &point.sample.solar);
+    if (fields < 3) continue;
+
+    if (!_points.empty() && point.seconds <= _points.back().seconds) continue;  // Must be increasing
+    _points.push_back(point);
+  }
+
+  fclose(file);
+  return !_points.empty();
+}
+
+WeatherSample WeatherProfile::sampleAt(double seconds) {
+
+  WeatherSample sample;
+
+  if (!_points.empty()) {
+
+    // Samples are asked for in increasing time, so resume the search where the last one ended
+    if (_lastIndex >= _points.size() || _points[_lastIndex].seconds > seconds) _lastIndex = 0;
+    while (_lastIndex + 1 < _points.size() && _points[_lastIndex + 1].seconds <= seconds) _lastIndex++;
+
+    const WeatherPoint &a = _points[_lastIndex];
+    if (_lastIndex + 1 == _points.size() || seconds <= a.seconds) return a.sample;  // Hold the ends
+
+    const WeatherPoint &b = _points[_lastIndex + 1];
+    float f = (float) ((seconds - a.seconds) / (b.seconds - a.seconds));
+
+    sample.temperature = a.sample.temperature + f * (b.sample.temperature - a.sample.temperature);
+    sample.humidity = a.sample.humidity + f * (b.sample.humidity - a.sample.humidity);
+    sample.solar = a.sample.solar + f * (b.sample.solar - a.sample.solar);
+
+    return sample;
+  }
+
+  double dayFraction = fmod(seconds, SECONDS_PER_DAY) / SECONDS_PER_DAY;
+
+  switch (_script) {
+
+    case WeatherScriptConstant: {
+
+      sample.temperature = 15.0f;
+      sample.humidity = 45.0f;
+      sample.solar = 0.0f;
+      break;
+    }
+
+    case WeatherScriptDiurnal:
+    case WeatherScriptColdFront: {
+
+      // Coldest at 05:00, warmest at 15:00, sun up 06:00..18:00
+      float phase = (float) (2.0 * M_PI * (dayFraction - 0.375));
+      sample.temperature = 15.0f + 7.0f * sinf(phase);
+
+      // Roughly constant vapour content outside, so RH falls as the day warms
+      float dewPointDensity = saturationVapourDensity(8.0f);
+      sample.humidity = 100.0f * dewPointDensity / saturationVapourDensity(sample.temperature);
+      if (sample.humidity > 100.0f) sample.humidity = 100.0f;
+
+      float sunAngle = (float) (M_PI * (dayFraction - 0.25) / 0.5);
+      sample.solar = (dayFraction > 0.25 && dayFraction < 0.75) ? 600.0f * sinf(sunAngle) : 0.0f;
+
+      if (_script == WeatherScriptColdFront && dayFraction >= (14.0 / 24.0)) {
+
+        // Front passes over an hour, then cold, damp and overcast
+        float f = (float) ((dayFraction - (14.0 / 24.0)) * 24.0);
+        if (f > 1.0f) f = 1.0f;
+
+        sample.temperature += f * (6.0f - sample.temperature);
+        sample.humidity += f * (90.0f - sample.humidity);
+        sample.solar *= (1.0f - f);
+      }
+      break;
+    }
+  }
+
+  return sample;
+}
+
+
+// PLANT
+// ----------------------------------------------------
+GreenhousePlant::GreenhousePlant(void) {
+
+  volume = 1.5f;
+  heatCapacity = 60000.0f;
+  wallConductance = 10.0f;
+  glazingArea = 1.2f;
+  solarTransmittance = 0.5f;
+  leakageAirChanges = 1.0f;
+  ventAirChanges = 60.0f;
+  lightBankPower = 25.0f;
+  transpiration = 0.01f;
+  litTranspiration = 0.01f;
+
+  reset(20.0f, 50.0f);
+}
+
+void GreenhousePlant::reset(float initialTemperature, float initialHumidity) {
+
+  temperature = initialTemperature;
+  humidity = initialHumidity;
+  _vapourDensity = saturationVapourDensity(temperature) * humidity / 100.0f;
+}
+
+float GreenhousePlant::ventOpening(int ventAngle) {
+
+  float opening = (float) (VENT_DOOR_CLOSED - ventAngle) / (float) (VENT_DOOR_CLOSED - VENT_DOOR_OPEN);
+
+  if (opening < 0.0f) opening = 0.0f;
+  if (opening > 1.0f) opening = 1.0f;
+
+  return opening;
+}
+
+void GreenhousePlant::step(float seconds, WeatherSample exterior, int ventAngle, uint8_t lightBanksOn) {
+
+  float airChanges = leakageAirChanges + ventAirChanges * ventOpening(ventAngle);  // per hour
+  float exchangeRate = airChanges / 3600.0f;  // volumes per second
+
+  // Heat balance, W
+  float ventilationConductance = AIR_DENSITY * AIR_SPECIFIC_HEAT * volume * exchangeRate;  // W/K
+  float heatFlow = (wallConductance + ventilationConductance) * (exterior.temperature - temperature)
+                 + glazingArea * solarTransmittance * exterior.solar
+                 + lightBankPower * lightBanksOn;
+
+  temperature += heatFlow * seconds / heatCapacity;
+
+  // Moisture balance, g
+  float saturation = saturationVapourDensity(temperature);
+  float exteriorVapourDensity = saturationVapourDensity(exterior.temperature) * exterior.humidity / 100.0f;
+  float plantWater = (transpiration + litTranspiration * lightBanksOn) * (1.0f - _vapourDensity / saturation);  // g/s
+
+  _vapourDensity += (exchangeRate * (exteriorVapourDensity - _vapourDensity) + plantWater / volume) * seconds;
+  if (_vapourDensity > saturation) _vapourDensity = saturation;  // Condenses on the glazing
+  if (_vapourDensity < 0.0f) _vapourDensity = 0.0f;
+
+  humidity = 100.0f * _vapourDensity / saturation;
+}
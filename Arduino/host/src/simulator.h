@@ -0,0 +1,92 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+#ifndef Simulator_h
+#define Simulator_h
+
+#include <vector>
+#include "Arduino.h"
+
+// Greenhouse Simulator
+// -------------------------------------------------
+// A lumped model of the greenhouse's interior air, driven by exterior weather, the vent
+//   flap and the light banks.  Interior moisture is tracked as vapour density so that
+//   heating and cooling move relative humidity the way they do in the real enclosure.
+
+typedef struct {
+
+  float temperature;  // °C
+  float humidity;  // % RH
+  float solar;  // W/m², on the glazing
+
+} WeatherSample;
+
+typedef enum {
+
+  WeatherScriptConstant,  // 15°C, 45% RH, overcast
+  WeatherScriptDiurnal,  // Clear day, 8..22°C with humidity falling as it warms
+  WeatherScriptColdFront  // Diurnal, then a cold damp front arrives at 14:00
+
+} WeatherScript;
+
+class WeatherProfile {
+
+  public:
+    WeatherProfile(void);
+
+    void useScript(WeatherScript script);
+    boolean useScriptNamed(const char *name);  // "constant", "diurnal", "front"
+    boolean loadCSV(const char *path);  // seconds,temperature,humidity[,solar] rows, linearly interpolated
+
+    WeatherSample sampleAt(double seconds);
+
+  private:
+    typedef struct {
+
+      double seconds;
+      WeatherSample sample;
+
+    } WeatherPoint;
+
+    WeatherScript _script;
+    std::vector<WeatherPoint> _points;  // Empty when following a script
+    size_t _lastIndex;
+};
+
+class GreenhousePlant {
+
+  public:
+    GreenhousePlant(void);
+
+    void reset(float temperature, float humidity);
+    void step(float seconds, WeatherSample exterior, int ventAngle, uint8_t lightBanksOn);
+
+    float ventOpening(int ventAngle);  // 0 (closed) .. 1 (fully open)
+
+    // Interior, what the sensor sees
+    float temperature;  // °C
+    float humidity;  // % RH
+
+    // Model parameters, defaults approximate the hobby greenhouse
+    float volume;  // m³ of air
+    float heatCapacity;  // J/K, air plus pots, soil and frame
+    float wallConductance;  // W/K through the glazing
+    float glazingArea;  // m² admitting sunlight
+    float solarTransmittance;  // Fraction of solar arriving as heat
+    float leakageAirChanges;  // per hour with the vent closed
+    float ventAirChanges;  // per hour added with the vent fully open
+    float lightBankPower;  // W of heat per bank
+    float transpiration;  // g/s of water from the plants at 0% RH, dark
+    float litTranspiration;  // g/s added per lit bank
+
+  private:
+    float _vapourDensity;  // g/m³
+};
+
+float saturationVapourDensity(float temperature);  // g/m³ at °C
+
+#endif
@@ -0,0 +1,11 @@
+// LICENSES: [a1cdbd]
+// -----------------------------------
+// The contents of this file contains the aggregate of contributions
+//   covered under one or more licences. The full text of those licenses
+//   can be found in the "LICENSES" file at the top level of this project
+//   identified by the MD5 fingerprints listed above.
+
+// The sketch, unmodified, as a host translation unit
+
+#include "Arduino.h"
+#include "Arduino_Greenhouse.ino"
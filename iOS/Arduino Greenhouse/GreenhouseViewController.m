@@ -1094,8 +1094,60 @@ typedef NS_ENUM(UInt8, ClimateState) {
 	//	NSLog(@"NOTIFY changed: %@", characteristic);
 }
 
+- (void)setTelemetryValue:(SInt16)encodedValue scale:(float)scale forKey:(NSString *)key {
+	
+	if (encodedValue == TELEMETRY_VALUE_UNAVAILABLE) [self.greenhouseValues removeObjectForKey:key];
+	else [self.greenhouseValues setValue:@(encodedValue / scale) forKey:key];
+}
+
+- (void)reloadRowsForModelObject:(id)modelObject {
+	
+	NSArray *rowDescriptors = [self rowDescriptorsWithModelObject:modelObject];
+	NSMutableArray *indexPaths = [NSMutableArray new];
+	for (TableRowDescriptor *aRowDescriptor in rowDescriptors) {
+		
+		NSIndexPath *indexPathToReload = [self indexPathOfCellForRowDescriptor:aRowDescriptor];
+		[indexPaths addObject:indexPathToReload];
+	}
+	
+	[self.tableView reloadRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+}
+
+- (void)didReceiveTelemetryFrame:(NSData *)frameData {
+	
+	if (frameData.length != sizeof(TelemetryFrame)) return;
+	
+	TelemetryFrame frame;
+	[frameData getBytes:&frame length:sizeof(TelemetryFrame)];
+	
+	if (frame.version != TELEMETRY_FRAME_VERSION) {
+		
+		NSLog(@"Ignoring telemetry frame with unsupported version %d", frame.version);
+		return;
+	}
+	
+	[self setTelemetryValue:frame.exteriorHumidity scale:TELEMETRY_HUMIDITY_SCALE forKey:EXTERIOR_HUMIDITY_CHARACTERISTIC_UUID];
+	[self setTelemetryValue:frame.exteriorTemperature scale:TELEMETRY_TEMPERATURE_SCALE forKey:EXTERIOR_TEMPERATURE_CHARACTERISTIC_UUID];
+	[self setTelemetryValue:frame.interiorHumidity scale:TELEMETRY_HUMIDITY_SCALE forKey:INTERIOR_HUMIDITY_CHARACTERISTIC_UUID];
+	[self setTelemetryValue:frame.interiorTemperature scale:TELEMETRY_TEMPERATURE_SCALE forKey:INTERIOR_TEMPERATURE_CHARACTERISTIC_UUID];
+	[self setTelemetryValue:frame.ventingNecessity scale:TELEMETRY_NECESSITY_SCALE forKey:VENTING_NECESSITY_CHARACTERISTIC_UUID];
+	[self setTelemetryValue:frame.ventingNecessityDelta scale:TELEMETRY_NECESSITY_DELTA_SCALE forKey:VENTING_NECESSITY_DELTA_CHARACTERISTIC_UUID];
+	[self.greenhouseValues setValue:@(frame.ventServoPosition) forKey:VENT_FLAP_CHARACTERISTIC_UUID];
+	
+	for (NSString *modelObject in @[EXTERIOR_HUMIDITY_CHARACTERISTIC_UUID, EXTERIOR_TEMPERATURE_CHARACTERISTIC_UUID, INTERIOR_HUMIDITY_CHARACTERISTIC_UUID, INTERIOR_TEMPERATURE_CHARACTERISTIC_UUID, VENTING_NECESSITY_CHARACTERISTIC_UUID, VENT_FLAP_CHARACTERISTIC_UUID]) {
+		
+		[self reloadRowsForModelObject:modelObject];
+	}
+}
+
 - (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
 	
+	if ([characteristic.UUID.UUIDString isEqualToString:TELEMETRY_SNAPSHOT_CHARACTERISTIC_UUID]) {
+		
+		[self didReceiveTelemetryFrame:characteristic.value];
+		return;
+	}
+	
 	switch (characteristic.value.length) {
 			
 		case sizeof(float): {
@@ -1134,15 +1186,7 @@ typedef NS_ENUM(UInt8, ClimateState) {
 	}
 	
 	// Update the relevant TableView rows
-	NSArray *rowDescriptors = [self rowDescriptorsWithModelObject:characteristic.UUID.UUIDString];
-	NSMutableArray *indexPaths = [NSMutableArray new];
-	for (TableRowDescriptor *aRowDescriptor in rowDescriptors) {
-		
-		NSIndexPath *indexPathToReload = [self indexPathOfCellForRowDescriptor:aRowDescriptor];
-		[indexPaths addObject:indexPathToReload];
-	}
-	
-	[self.tableView reloadRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+	[self reloadRowsForModelObject:characteristic.UUID.UUIDString];
 	
 	/*
 	 if ([UIApplication sharedApplication].applicationState == UIApplicationStateBackground) {